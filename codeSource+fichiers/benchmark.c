@@ -0,0 +1,848 @@
+/*
+ * Benchmark suite - reproducible instance generators and a timing harness
+ *
+ *   benchmark generate <family> <size> [seed]     print one instance in DIMACS format
+ *   benchmark run [options] [instances...]        solve instances repeatedly, report as CSV/JSON
+ *
+ * Instance families, each scaled by its size parameter:
+ *   randomK     random K-SAT (K from 3 to 7, "random" is 3-SAT) over size variables, at the
+ *               clause/variable ratio of the satisfiability phase transition
+ *   pigeonhole  size + 1 pigeons in size holes (unsatisfiable)
+ *   tseitin     parity constraints on the edges of a size x size torus grid with an odd
+ *               total charge (unsatisfiable)
+ *   coloring    3-coloring of a random graph of size vertices of average degree 4.6, near
+ *               the colorability threshold
+ * The same family, size and seed always give the same formula on every platform.
+ */
+
+#include "solver.h"
+#include "solver_internal.h"
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#include <psapi.h>
+#endif
+
+#define DEFAULT_RUNS 5
+#define DEFAULT_TIME_LIMIT 10.0 // Seconds of each run; slower runs answer "unknown"
+#define COLORING_COLORS 3
+#define COLORING_AVERAGE_DEGREE 4.6
+#define BLOCK_VARIABLES 12
+
+// Clause/variable ratio of the satisfiability threshold of random K-SAT, from K = 3
+static const double random_ratios[] = {4.267, 9.931, 21.117, 43.37, 87.79};
+
+// Structure to represent a benchmark instance: generated clauses, or a formula file
+typedef struct
+{
+    char name[64];
+    const char *path; // Formula file, or NULL for a generated instance
+    int num_variables;
+    int num_clauses;
+    int *literals; // DIMACS literals of every clause, each clause ending with 0
+    int size;
+    int capacity;
+} Instance;
+
+// Structure to represent the measures of one run
+typedef struct
+{
+    bool ok; // The instance could be loaded and solved
+    int variables;
+    int clauses;
+    SolverResult result;
+    double seconds; // Wall-clock time of the solve, loading excluded
+    long resolvents;
+    long conflicts;
+    long peak_kb; // Peak resident set size of the process that solved, -1 if unknown
+} RunRecord;
+
+// Structure to represent the solver settings of a benchmark
+typedef struct
+{
+    SolverEngine engine;
+    const char *engine_name;
+    SolverSelection selection;
+    bool preprocess;
+    int threads;
+    int runs;
+    SolverBudget budget;
+} BenchmarkOptions;
+
+// Built-in suites as family:size:seed specifications
+static const char *small_suite[] = {"random:10:1",  "random:12:2",  "random:15:3",   "random4:8:1",
+                                    "pigeonhole:2", "pigeonhole:3", "tseitin:2:1",   "tseitin:2:2",
+                                    "coloring:5:1", "coloring:6:2", "coloring:7:3", "blocks:4:1",   NULL};
+static const char *large_suite[] = {"random:100:1",   "random:150:2",   "random:200:3",   "random4:60:1",
+                                    "pigeonhole:7",   "pigeonhole:8",   "tseitin:4:1",    "tseitin:5:1",
+                                    "tseitin:5:2",    "coloring:100:1", "coloring:200:2", "coloring:300:3",
+                                    "blocks:32:1",    NULL};
+
+// ---------------------------------------------------------------------------
+// Instance generators
+// ---------------------------------------------------------------------------
+
+// Function to draw the next number of a seeded generator (splitmix64), the same everywhere
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Function to draw a number from 0 to bound - 1
+static int random_below(uint64_t *state, int bound)
+{
+    return (int)(next_random(state) % (uint64_t)bound);
+}
+
+// Function to append a clause of DIMACS literals to an instance
+static bool instance_add_clause(Instance *instance, const int *literals, int num_literals)
+{
+    int needed = instance->size + num_literals + 1;
+    if (needed > instance->capacity)
+    {
+        int new_capacity = instance->capacity ? instance->capacity : INITIAL_CAPACITY;
+        while (new_capacity < needed)
+            new_capacity *= GROWTH_FACTOR;
+        int *new_literals = realloc(instance->literals, new_capacity * sizeof(int));
+        if (!new_literals)
+            return false;
+        instance->literals = new_literals;
+        instance->capacity = new_capacity;
+    }
+
+    for (int i = 0; i < num_literals; i++)
+        instance->literals[instance->size++] = literals[i];
+    instance->literals[instance->size++] = 0;
+    instance->num_clauses++;
+    return true;
+}
+
+// Function to generate random K-SAT: clauses of k distinct variables with random signs
+static bool generate_random(Instance *instance, int num_vars, int k, uint64_t seed)
+{
+    if (num_vars < k)
+        return false;
+    int num_clauses = (int)(random_ratios[k - 3] * num_vars + 0.5);
+    int clause[7];
+    instance->num_variables = num_vars;
+    for (int c = 0; c < num_clauses; c++)
+    {
+        for (int i = 0; i < k; i++)
+        {
+            bool repeated;
+            do
+            {
+                clause[i] = random_below(&seed, num_vars) + 1;
+                repeated = false;
+                for (int j = 0; j < i; j++)
+                    repeated = repeated || clause[j] == clause[i];
+            } while (repeated);
+            if (random_below(&seed, 2))
+                clause[i] = -clause[i];
+        }
+        if (!instance_add_clause(instance, clause, k))
+            return false;
+    }
+    return true;
+}
+
+// Function to generate independent blocks of random 3-SAT, each on BLOCK_VARIABLES variables
+// of its own: near the threshold each block is unsatisfiable about half the time
+// Variables b * BLOCK_VARIABLES + 1 to (b + 1) * BLOCK_VARIABLES belong to block b
+static bool generate_blocks(Instance *instance, int num_blocks, uint64_t seed)
+{
+    if (num_blocks < 1)
+        return false;
+    int clauses_per_block = (int)(random_ratios[0] * BLOCK_VARIABLES + 0.5);
+    int clause[3];
+    instance->num_variables = num_blocks * BLOCK_VARIABLES;
+    for (int b = 0; b < num_blocks; b++)
+    {
+        for (int c = 0; c < clauses_per_block; c++)
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                bool repeated;
+                do
+                {
+                    clause[i] = random_below(&seed, BLOCK_VARIABLES) + 1;
+                    repeated = false;
+                    for (int j = 0; j < i; j++)
+                        repeated = repeated || clause[j] == clause[i];
+                } while (repeated);
+                clause[i] += b * BLOCK_VARIABLES;
+                if (random_below(&seed, 2))
+                    clause[i] = -clause[i];
+            }
+            if (!instance_add_clause(instance, clause, 3))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Function to generate the pigeonhole principle: holes + 1 pigeons each in a hole, no two
+// in the same hole. Variable p * holes + h + 1 puts pigeon p in hole h
+static bool generate_pigeonhole(Instance *instance, int holes)
+{
+    if (holes < 1)
+        return false;
+    int pigeons = holes + 1;
+    instance->num_variables = pigeons * holes;
+    int *clause = malloc(holes * sizeof(int));
+    bool ok = clause != NULL;
+    for (int p = 0; p < pigeons && ok; p++)
+    {
+        for (int h = 0; h < holes; h++)
+            clause[h] = p * holes + h + 1;
+        ok = instance_add_clause(instance, clause, holes);
+    }
+    for (int h = 0; h < holes && ok; h++)
+    {
+        for (int p = 0; p < pigeons && ok; p++)
+        {
+            for (int q = p + 1; q < pigeons && ok; q++)
+            {
+                int pair[2] = {-(p * holes + h + 1), -(q * holes + h + 1)};
+                ok = instance_add_clause(instance, pair, 2);
+            }
+        }
+    }
+    free(clause);
+    return ok;
+}
+
+// Function to generate Tseitin parity formulas on a side x side torus grid: each edge is a
+// variable and the edges around each vertex must sum to its charge modulo 2. The charges are
+// random but sum to an odd number, which no assignment can meet
+static bool generate_tseitin(Instance *instance, int side, uint64_t seed)
+{
+    if (side < 2)
+        return false; // A side of 2 doubles every edge, which keeps four distinct edge variables
+    int num_vertices = side * side;
+    instance->num_variables = 2 * num_vertices; // Edge 2v + 1 goes right of v, 2v + 2 down
+
+    int parity = 0;
+    bool ok = true;
+    for (int v = 0; v < num_vertices && ok; v++)
+    {
+        int row = v / side;
+        int col = v % side;
+        int left = row * side + (col + side - 1) % side;
+        int up = ((row + side - 1) % side) * side + col;
+        int edges[4] = {2 * v + 1, 2 * v + 2, 2 * left + 1, 2 * up + 2};
+        int charge = random_below(&seed, 2);
+        if (v == num_vertices - 1)
+            charge = parity ^ 1;
+        parity ^= charge;
+
+        // One clause excludes each assignment of the four edges of the wrong parity
+        for (int mask = 0; mask < 16 && ok; mask++)
+        {
+            int ones = (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+            if (ones % 2 == charge)
+                continue;
+            int clause[4];
+            for (int i = 0; i < 4; i++)
+                clause[i] = (mask >> i) & 1 ? -edges[i] : edges[i];
+            ok = instance_add_clause(instance, clause, 4);
+        }
+    }
+    return ok;
+}
+
+// Function to generate graph coloring: a random graph whose vertices each take exactly one
+// of the colors, with the two ends of every edge colored differently
+// Variable v * COLORING_COLORS + c + 1 gives vertex v color c
+static bool generate_coloring(Instance *instance, int num_vertices, uint64_t seed)
+{
+    if (num_vertices < 2)
+        return false;
+    long max_edges = (long)num_vertices * (num_vertices - 1) / 2;
+    long num_edges = (long)(COLORING_AVERAGE_DEGREE * num_vertices / 2 + 0.5);
+    if (num_edges > max_edges)
+        num_edges = max_edges;
+    bool *adjacent = calloc((size_t)num_vertices * num_vertices, sizeof(bool));
+    if (!adjacent)
+        return false;
+    instance->num_variables = num_vertices * COLORING_COLORS;
+
+    bool ok = true;
+    for (int v = 0; v < num_vertices && ok; v++)
+    {
+        int clause[COLORING_COLORS];
+        for (int c = 0; c < COLORING_COLORS; c++)
+            clause[c] = v * COLORING_COLORS + c + 1;
+        ok = instance_add_clause(instance, clause, COLORING_COLORS);
+        for (int c = 0; c < COLORING_COLORS && ok; c++)
+        {
+            for (int d = c + 1; d < COLORING_COLORS && ok; d++)
+            {
+                int pair[2] = {-(v * COLORING_COLORS + c + 1), -(v * COLORING_COLORS + d + 1)};
+                ok = instance_add_clause(instance, pair, 2);
+            }
+        }
+    }
+    for (long e = 0; e < num_edges && ok; e++)
+    {
+        int u, w;
+        do
+        {
+            u = random_below(&seed, num_vertices);
+            w = random_below(&seed, num_vertices);
+        } while (u == w || adjacent[(size_t)u * num_vertices + w]);
+        adjacent[(size_t)u * num_vertices + w] = true;
+        adjacent[(size_t)w * num_vertices + u] = true;
+        for (int c = 0; c < COLORING_COLORS && ok; c++)
+        {
+            int pair[2] = {-(u * COLORING_COLORS + c + 1), -(w * COLORING_COLORS + c + 1)};
+            ok = instance_add_clause(instance, pair, 2);
+        }
+    }
+    free(adjacent);
+    return ok;
+}
+
+// Function to generate an instance of a family; returns false (after printing the reason)
+// on an unknown family or a size it does not support
+static bool generate_instance(Instance *instance, const char *family, int size, unsigned int seed)
+{
+    memset(instance, 0, sizeof(*instance));
+    snprintf(instance->name, sizeof(instance->name), "%s-%d-%u", family, size, seed);
+    uint64_t state = ((uint64_t)seed << 32) ^ (uint64_t)size;
+
+    bool known = true;
+    bool ok = false;
+    if (strncmp(family, "random", 6) == 0)
+    {
+        int k = family[6] ? atoi(family + 6) : 3;
+        known = k >= 3 && k <= 7 && (family[6] == '\0' || (isdigit((unsigned char)family[6]) && family[7] == '\0'));
+        ok = known && generate_random(instance, size, k, state);
+    }
+    else if (strcmp(family, "pigeonhole") == 0)
+    {
+        ok = generate_pigeonhole(instance, size);
+    }
+    else if (strcmp(family, "tseitin") == 0)
+    {
+        ok = generate_tseitin(instance, size, state);
+    }
+    else if (strcmp(family, "coloring") == 0)
+    {
+        ok = generate_coloring(instance, size, state);
+    }
+    else if (strcmp(family, "blocks") == 0)
+    {
+        ok = generate_blocks(instance, size, state);
+    }
+    else
+    {
+        known = false;
+    }
+
+    if (!known)
+        printf("Error: Unknown instance family %s\n", family);
+    else if (!ok)
+        printf("Error: Unable to generate %s of size %d\n", family, size);
+    if (!ok)
+        free(instance->literals);
+    return ok;
+}
+
+// Function to parse an instance given as family:size[:seed], or take it as a formula file
+static bool parse_instance(Instance *instance, const char *spec)
+{
+    const char *colon = strchr(spec, ':');
+    if (!colon)
+    {
+        memset(instance, 0, sizeof(*instance));
+        instance->path = spec;
+        const char *base = strrchr(spec, '/');
+        snprintf(instance->name, sizeof(instance->name), "%s", base ? base + 1 : spec);
+        return true;
+    }
+
+    char family[32];
+    size_t length = (size_t)(colon - spec);
+    if (length >= sizeof(family))
+        length = sizeof(family) - 1;
+    memcpy(family, spec, length);
+    family[length] = '\0';
+    int size = atoi(colon + 1);
+    const char *seed = strchr(colon + 1, ':');
+    return generate_instance(instance, family, size, seed ? (unsigned int)strtoul(seed + 1, NULL, 10) : 1u);
+}
+
+// Function to print an instance in DIMACS format
+static void print_dimacs(Instance *instance)
+{
+    printf("c %s\n", instance->name);
+    printf("p cnf %d %d\n", instance->num_variables, instance->num_clauses);
+    for (int i = 0; i < instance->size; i++)
+        printf(instance->literals[i] == 0 ? "0\n" : "%d ", instance->literals[i]);
+}
+
+// ---------------------------------------------------------------------------
+// Timing harness
+// ---------------------------------------------------------------------------
+
+// Function to load an instance into a solver and solve it once
+static void solve_instance(Instance *instance, BenchmarkOptions *options, RunRecord *record)
+{
+    memset(record, 0, sizeof(*record));
+    record->peak_kb = -1;
+    Solver *solver = solver_create();
+    if (!solver)
+        return;
+
+    bool ok = true;
+    if (instance->path)
+    {
+        ok = solver_read_file(solver, instance->path, SOLVER_FORMAT_AUTO);
+    }
+    else
+    {
+        int start = 0;
+        for (int i = 0; i < instance->size && ok; i++)
+        {
+            if (instance->literals[i] != 0)
+                continue;
+            ok = solver_add_clause(solver, instance->literals + start, i - start);
+            start = i + 1;
+        }
+    }
+
+    if (ok)
+    {
+        solver_set_engine(solver, options->engine);
+        solver_set_selection(solver, options->selection);
+        solver_set_preprocessing(solver, options->preprocess);
+        solver_set_threads(solver, options->threads);
+        solver_set_budget(solver, &options->budget);
+        double start = now_seconds();
+        record->result = solver_solve(solver);
+        record->seconds = now_seconds() - start;
+
+        SolverStats stats;
+        solver_get_stats(solver, &stats);
+        record->resolvents = stats.resolvents;
+        record->conflicts = stats.conflicts;
+        record->variables = solver_num_variables(solver);
+        record->clauses = solver_num_clauses(solver);
+        record->ok = true;
+    }
+    solver_destroy(solver);
+}
+
+// Function to run one measure of an instance
+// Each run solves in a child process of its own, so that its peak resident set size is not
+// that of the runs before it; on Windows it runs in this process, whose peak is reported
+static void measure_run(Instance *instance, BenchmarkOptions *options, RunRecord *record)
+{
+#ifdef _WIN32
+    solve_instance(instance, options, record);
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        record->peak_kb = (long)(counters.PeakWorkingSetSize / 1024);
+#else
+    int fds[2];
+    pid_t pid = -1;
+    fflush(stdout);
+    if (pipe(fds) == 0)
+    {
+        pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+        }
+    }
+    if (pid < 0)
+    {
+        // No child process: measure here, with the peak of the whole benchmark
+        solve_instance(instance, options, record);
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            record->peak_kb = usage.ru_maxrss;
+        return;
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        solve_instance(instance, options, record);
+        bool written = write(fds[1], record, sizeof(*record)) == (ssize_t)sizeof(*record);
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    size_t received = 0;
+    while (received < sizeof(*record))
+    {
+        ssize_t n = read(fds[0], (char *)record + received, sizeof(*record) - received);
+        if (n <= 0)
+            break;
+        received += (size_t)n;
+    }
+    close(fds[0]);
+    if (received < sizeof(*record))
+    {
+        memset(record, 0, sizeof(*record)); // The child failed before reporting
+        record->peak_kb = -1;
+    }
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) == pid)
+    {
+#ifdef __APPLE__
+        record->peak_kb = usage.ru_maxrss / 1024; // Bytes there, kilobytes elsewhere
+#else
+        record->peak_kb = usage.ru_maxrss;
+#endif
+    }
+#endif
+}
+
+// Function to compare doubles for qsort
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to compare longs for qsort
+static int compare_longs(const void *a, const void *b)
+{
+    long x = *(const long *)a;
+    long y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to get a percentile of sorted values by the nearest-rank method
+static double percentile(const double *sorted, int count, double percent)
+{
+    int rank = (int)(percent / 100.0 * count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+    return sorted[rank - 1];
+}
+
+// Function to get the median of longs, sorting them
+static long median_long(long *values, int count)
+{
+    qsort(values, count, sizeof(long), compare_longs);
+    return values[(count - 1) / 2];
+}
+
+// Structure to represent the measures of an instance over all its runs
+typedef struct
+{
+    const char *verdict; // Answer of every run, "mixed" if they disagree, "error" if one failed
+    int runs;
+    double time_min;
+    double time_median;
+    double time_p90;
+    double time_max;
+    long peak_kb;    // Median peak resident set size
+    long resolvents; // Median counters
+    long conflicts;
+} Summary;
+
+// Function to run an instance repeatedly and summarize the runs
+static bool benchmark_instance(Instance *instance, BenchmarkOptions *options, Summary *summary)
+{
+    int runs = options->runs;
+    double *times = malloc(runs * sizeof(double));
+    long *peaks = malloc(runs * sizeof(long));
+    long *resolvents = malloc(runs * sizeof(long));
+    long *conflicts = malloc(runs * sizeof(long));
+    bool ok = times && peaks && resolvents && conflicts;
+
+    memset(summary, 0, sizeof(*summary));
+    summary->runs = runs;
+    for (int r = 0; r < runs && ok; r++)
+    {
+        RunRecord record;
+        measure_run(instance, options, &record);
+        const char *verdict = record.ok ? solver_result_name(record.result) : "error";
+        if (!summary->verdict)
+            summary->verdict = verdict;
+        else if (strcmp(summary->verdict, verdict) != 0 && strcmp(summary->verdict, "error") != 0)
+            summary->verdict = record.ok ? "mixed" : "error";
+        if (record.ok && instance->path)
+        {
+            instance->num_variables = record.variables;
+            instance->num_clauses = record.clauses;
+        }
+        times[r] = record.seconds;
+        peaks[r] = record.peak_kb;
+        resolvents[r] = record.resolvents;
+        conflicts[r] = record.conflicts;
+    }
+
+    if (ok)
+    {
+        qsort(times, runs, sizeof(double), compare_doubles);
+        summary->time_min = times[0];
+        summary->time_median = percentile(times, runs, 50.0);
+        summary->time_p90 = percentile(times, runs, 90.0);
+        summary->time_max = times[runs - 1];
+        summary->peak_kb = median_long(peaks, runs);
+        summary->resolvents = median_long(resolvents, runs);
+        summary->conflicts = median_long(conflicts, runs);
+    }
+    free(times);
+    free(peaks);
+    free(resolvents);
+    free(conflicts);
+    return ok;
+}
+
+// Function to write a string as a JSON string literal
+static void print_json_string(FILE *out, const char *text)
+{
+    fputc('"', out);
+    for (const char *p = text; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            fputc('\\', out);
+        if ((unsigned char)*p >= 0x20)
+            fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+// Function to write the summary of an instance as a CSV row or a JSON object
+static void print_summary(FILE *out, bool json, bool first, Instance *instance, BenchmarkOptions *options,
+                          Summary *summary)
+{
+    if (!json)
+    {
+        fprintf(out, "%s,%d,%d,%s,%s,%d,%.6f,%.6f,%.6f,%.6f,%ld,%ld,%ld\n", instance->name,
+                instance->num_variables, instance->num_clauses, options->engine_name, summary->verdict,
+                summary->runs, summary->time_min, summary->time_median, summary->time_p90, summary->time_max,
+                summary->peak_kb, summary->resolvents, summary->conflicts);
+        return;
+    }
+
+    fprintf(out, "%s  {\"instance\": ", first ? "" : ",\n");
+    print_json_string(out, instance->name);
+    fprintf(out, ", \"variables\": %d, \"clauses\": %d, \"engine\": \"%s\", \"verdict\": \"%s\", \"runs\": %d, ",
+            instance->num_variables, instance->num_clauses, options->engine_name, summary->verdict, summary->runs);
+    fprintf(out, "\"time_min\": %.6f, \"time_median\": %.6f, \"time_p90\": %.6f, \"time_max\": %.6f, ",
+            summary->time_min, summary->time_median, summary->time_p90, summary->time_max);
+    fprintf(out, "\"peak_rss_kb\": %ld, \"resolvents\": %ld, \"conflicts\": %ld}", summary->peak_kb,
+            summary->resolvents, summary->conflicts);
+}
+
+// Function to benchmark every instance and write one row or object per instance
+// The instances are all generated first, so that the report only starts once they are valid
+// Returns the exit status: 1 if any instance could not be generated or solved, 0 otherwise
+static int run_benchmark(const char **specs, int num_specs, BenchmarkOptions *options, FILE *out, bool json)
+{
+    Instance *instances = malloc(num_specs * sizeof(Instance));
+    if (!instances)
+    {
+        printf("Error: Out of memory\n");
+        return 1;
+    }
+    int num_instances = 0;
+    while (num_instances < num_specs && parse_instance(&instances[num_instances], specs[num_instances]))
+        num_instances++;
+    if (num_instances < num_specs)
+    {
+        for (int i = 0; i < num_instances; i++)
+            free(instances[i].literals);
+        free(instances);
+        return 1;
+    }
+
+    int status = 0;
+    if (json)
+        fprintf(out, "[\n");
+    else
+        fprintf(out, "instance,variables,clauses,engine,verdict,runs,time_min,time_median,time_p90,time_max,"
+                     "peak_rss_kb,resolvents,conflicts\n");
+
+    bool first = true;
+    for (int i = 0; i < num_instances; i++)
+    {
+        Instance *instance = &instances[i];
+        Summary summary;
+        if (benchmark_instance(instance, options, &summary))
+        {
+            print_summary(out, json, first, instance, options, &summary);
+            first = false;
+            fflush(out);
+            if (strcmp(summary.verdict, "error") == 0)
+                status = 1;
+        }
+        else
+        {
+            printf("Error: Out of memory while benchmarking %s\n", instance->name);
+            status = 1;
+        }
+        free(instance->literals);
+    }
+
+    if (json)
+        fprintf(out, "%s]\n", first ? "" : "\n");
+    free(instances);
+    return status;
+}
+
+// Function to look up a resolution selection strategy by its command-line name
+// Returns the SolverSelection, or -1 for an unknown name
+static int selection_from_name(const char *name)
+{
+    if (strcmp(name, "shortest") == 0)
+        return SOLVER_SELECT_SHORTEST;
+    if (strcmp(name, "age-weight") == 0)
+        return SOLVER_SELECT_AGE_WEIGHT;
+    if (strcmp(name, "fifo") == 0)
+        return SOLVER_SELECT_FIFO;
+    if (strcmp(name, "ordered") == 0)
+        return SOLVER_SELECT_ORDERED;
+    return -1;
+}
+
+// Function to print how to use the benchmark
+static void print_usage(const char *program)
+{
+    printf("Usage: %s generate <family> <size> [seed]\n", program);
+    printf("       %s run [--engine=resolution|cdcl|portfolio] [--select=shortest|age-weight|fifo|ordered] "
+           "[--preprocess] [--threads N] [--runs N] "
+           "[--time-limit S] [--format=csv|json] [--suite small|large] [--output FILE] "
+           "[family:size[:seed] | file.cnf ...]\n",
+           program);
+    printf("Families: random (random3 to random7), pigeonhole, tseitin, coloring, blocks\n");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 4 && strcmp(argv[1], "generate") == 0)
+    {
+        Instance instance;
+        unsigned int seed = argc >= 5 ? (unsigned int)strtoul(argv[4], NULL, 10) : 1u;
+        if (!generate_instance(&instance, argv[2], atoi(argv[3]), seed))
+            return 1;
+        print_dimacs(&instance);
+        free(instance.literals);
+        return 0;
+    }
+    if (argc < 2 || strcmp(argv[1], "run") != 0)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    BenchmarkOptions options;
+    memset(&options, 0, sizeof(options));
+    options.engine = SOLVER_ENGINE_RESOLUTION;
+    options.engine_name = "resolution";
+    options.threads = 1;
+    options.runs = DEFAULT_RUNS;
+    options.budget.seconds = DEFAULT_TIME_LIMIT;
+    const char **suite = small_suite;
+    const char *output = NULL;
+    bool json = false;
+    const char **specs = malloc(argc * sizeof(char *));
+    int num_specs = 0;
+    if (!specs)
+    {
+        printf("Error: Out of memory\n");
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--engine=resolution") == 0)
+        {
+            options.engine = SOLVER_ENGINE_RESOLUTION;
+            options.engine_name = "resolution";
+        }
+        else if (strcmp(argv[i], "--engine=cdcl") == 0)
+        {
+            options.engine = SOLVER_ENGINE_CDCL;
+            options.engine_name = "cdcl";
+        }
+        else if (strcmp(argv[i], "--engine=portfolio") == 0)
+        {
+            options.engine = SOLVER_ENGINE_PORTFOLIO;
+            options.engine_name = "portfolio";
+        }
+        else if (strncmp(argv[i], "--select=", 9) == 0 && selection_from_name(argv[i] + 9) >= 0)
+        {
+            options.selection = (SolverSelection)selection_from_name(argv[i] + 9);
+        }
+        else if (strcmp(argv[i], "--preprocess") == 0)
+        {
+            options.preprocess = true;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+            options.threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+            options.runs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0)
+        {
+            options.budget.seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--format=csv") == 0 || strcmp(argv[i], "--format=json") == 0)
+        {
+            json = strcmp(argv[i], "--format=json") == 0;
+        }
+        else if (strcmp(argv[i], "--suite") == 0 && i + 1 < argc &&
+                 (strcmp(argv[i + 1], "small") == 0 || strcmp(argv[i + 1], "large") == 0))
+        {
+            suite = strcmp(argv[++i], "small") == 0 ? small_suite : large_suite;
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (argv[i][0] != '-')
+        {
+            specs[num_specs++] = argv[i];
+        }
+        else
+        {
+            print_usage(argv[0]);
+            free(specs);
+            return 1;
+        }
+    }
+
+    // Without instances given, the suite is run
+    const char **list = specs;
+    if (num_specs == 0)
+    {
+        list = suite;
+        while (suite[num_specs])
+            num_specs++;
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out)
+    {
+        printf("Error: Unable to create %s\n", output);
+        free(specs);
+        return 1;
+    }
+    int status = run_benchmark(list, num_specs, &options, out, json);
+    if (output)
+        fclose(out);
+    free(specs);
+    return status;
+}
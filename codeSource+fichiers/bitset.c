@@ -0,0 +1,178 @@
+/*
+ * Bitset clause kernels for formulas of at most BITSET_MAX_VARIABLES variables
+ *
+ * A clause is a positive and a negative mask of one bit per variable, so resolving two
+ * clauses is an OR of their masks less the pivot, a tautology is a variable set in both
+ * masks and subsumption is an AND-NOT that must leave nothing. The kernels are compiled
+ * once per width (64, 128, 256 and 512 variables) with AVX-512 or AVX2 instructions when
+ * the compiler targets them (make SIMD=native), scalar 64-bit words otherwise.
+ */
+
+#include "solver_internal.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__)
+#define BITSET_INSTRUCTIONS "avx512"
+#elif defined(__AVX2__)
+#define BITSET_INSTRUCTIONS "avx2"
+#else
+#define BITSET_INSTRUCTIONS "scalar"
+#endif
+
+// Function to OR two bitsets of n words; n is a constant once inlined in a kernel
+static inline void bitset_or(uint64_t *out, const uint64_t *a, const uint64_t *b, int n)
+{
+    int i = 0;
+#if defined(__AVX512F__)
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm512_storeu_si512(out + i, _mm512_or_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+    }
+#endif
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_or_si256(x, y));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i] = a[i] | b[i];
+    }
+}
+
+// Function to check if two bitsets of n words share a bit
+static inline bool bitset_intersects(const uint64_t *a, const uint64_t *b, int n)
+{
+    int i = 0;
+#if defined(__AVX512F__)
+    for (; i + 8 <= n; i += 8)
+    {
+        if (_mm512_test_epi64_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)))
+            return true;
+    }
+#endif
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        if (!_mm256_testz_si256(x, y))
+            return true;
+    }
+#endif
+    for (; i < n; i++)
+    {
+        if (a[i] & b[i])
+            return true;
+    }
+    return false;
+}
+
+// Function to check if every bit of a bitset of n words is also set in another
+static inline bool bitset_within(const uint64_t *a, const uint64_t *b, int n)
+{
+    int i = 0;
+#if defined(__AVX512F__)
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i outside = _mm512_andnot_si512(_mm512_loadu_si512(b + i), x);
+        if (_mm512_test_epi64_mask(outside, outside))
+            return false;
+    }
+#endif
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        if (!_mm256_testc_si256(y, x))
+            return false;
+    }
+#endif
+    for (; i < n; i++)
+    {
+        if (a[i] & ~b[i])
+            return false;
+    }
+    return true;
+}
+
+// Kernels of one width: WORDS 64-bit words per mask, both masks of a clause side by side
+#define BITSET_KERNELS(WORDS)                                                                 \
+    static bool bitset_subsumes_##WORDS(const uint64_t *a, const uint64_t *b)                 \
+    {                                                                                         \
+        return bitset_within(a, b, 2 * WORDS);                                                \
+    }                                                                                         \
+                                                                                              \
+    static bool bitset_resolve_##WORDS(const uint64_t *a, const uint64_t *b, int var, uint64_t *out) \
+    {                                                                                         \
+        bitset_or(out, a, b, 2 * WORDS);                                                      \
+        uint64_t pivot = ~(1ull << (var & 63));                                               \
+        out[var >> 6] &= pivot;                                                               \
+        out[WORDS + (var >> 6)] &= pivot;                                                     \
+        return !bitset_intersects(out, out + WORDS, WORDS);                                   \
+    }
+
+BITSET_KERNELS(1)
+BITSET_KERNELS(2)
+BITSET_KERNELS(4)
+BITSET_KERNELS(8)
+
+static const BitsetKernels bitset_kernel_table[] = {
+    {1, BITSET_INSTRUCTIONS, bitset_subsumes_1, bitset_resolve_1},
+    {2, BITSET_INSTRUCTIONS, bitset_subsumes_2, bitset_resolve_2},
+    {4, BITSET_INSTRUCTIONS, bitset_subsumes_4, bitset_resolve_4},
+    {8, BITSET_INSTRUCTIONS, bitset_subsumes_8, bitset_resolve_8},
+};
+
+// Function to get the narrowest kernels covering a number of variables, or NULL if there
+// are more than BITSET_MAX_VARIABLES
+const BitsetKernels *bitset_kernels(int num_vars)
+{
+    for (size_t i = 0; i < sizeof(bitset_kernel_table) / sizeof(bitset_kernel_table[0]); i++)
+    {
+        if (num_vars <= 64 * bitset_kernel_table[i].words)
+            return &bitset_kernel_table[i];
+    }
+    return NULL;
+}
+
+// Function to build the masks of a clause; literals of variables beyond the width are
+// left out, which keeps "a subsumes b" exact whenever a itself fits
+void bitset_from_literals(uint64_t *bits, int words, const Literal *literals, int num_literals)
+{
+    memset(bits, 0, 2 * words * sizeof(uint64_t));
+    for (int i = 0; i < num_literals; i++)
+    {
+        int var = literal_var(literals[i]);
+        if (var >= 64 * words)
+            continue;
+        int word = literal_is_negated(literals[i]) ? words + (var >> 6) : var >> 6;
+        bits[word] |= 1ull << (var & 63);
+    }
+}
+
+// Function to write the literals of non-tautological masks in canonical (sorted) order
+// Returns the number of literals written
+int bitset_to_literals(const uint64_t *bits, int words, Literal *literals)
+{
+    int size = 0;
+    for (int w = 0; w < words; w++)
+    {
+        uint64_t negative = bits[words + w];
+        uint64_t remaining = bits[w] | negative;
+        while (remaining)
+        {
+            int bit = __builtin_ctzll(remaining);
+            remaining &= remaining - 1;
+            literals[size++] = make_literal(64 * w + bit, (negative >> bit) & 1);
+        }
+    }
+    return size;
+}
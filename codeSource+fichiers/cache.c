@@ -0,0 +1,197 @@
+/*
+ * Persistent cache of answers, keyed by the canonical form of formulas
+ *
+ * The cache is one file of fixed size that every solver using it maps into memory, so answers
+ * are shared between processes and outlive them. Entries are grouped in sets of CACHE_WAYS and
+ * the key of a formula picks its set. Lookups hold the lock of the file together with the
+ * other readers; a store holds it alone and replaces, when the set is full, the entry used
+ * least recently. Recency is a clock in the header: every hit or store takes its next tick,
+ * with atomic operations since readers write ticks while sharing the lock.
+ * A model is one bit per canonical variable, so it applies to any renaming of the formula
+ * through the numbering of its own canonical form.
+ */
+
+#include "solver_internal.h"
+
+#define CACHE_MAGIC 0x3148434143564c53ull // "SLVCACH1"
+#define CACHE_VERSION 1
+
+// Structure to represent the header at the start of a cache file
+typedef struct
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_sets;
+    uint32_t ways;
+    uint32_t model_words; // 64-bit words of model after each entry
+    uint64_t clock;       // Last tick given to an entry
+} CacheHeader;
+
+// Structure to represent an entry of a cache file; the words of its model follow it
+typedef struct
+{
+    uint64_t key;
+    uint64_t check;
+    uint64_t last_used;    // Tick of the last hit or store, 0 for an empty entry
+    int32_t result;        // SEARCH_SATISFIABLE or SEARCH_UNSATISFIABLE
+    int32_t num_variables; // Canonical variables of the formula
+    CachedStats stats;
+} CacheEntry;
+
+// Function to read the tick of an entry
+static inline uint64_t load_tick(uint64_t *tick)
+{
+#ifdef _MSC_VER
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)tick, 0, 0);
+#else
+    return __atomic_load_n(tick, __ATOMIC_RELAXED);
+#endif
+}
+
+// Function to give the next tick of the clock to an entry
+static inline void touch_entry(CacheHeader *header, CacheEntry *entry)
+{
+#ifdef _MSC_VER
+    LONG64 tick = InterlockedIncrement64((volatile LONG64 *)&header->clock);
+    InterlockedExchange64((volatile LONG64 *)&entry->last_used, tick);
+#else
+    uint64_t tick = __atomic_add_fetch(&header->clock, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->last_used, tick, __ATOMIC_RELAXED);
+#endif
+}
+
+// Function to get the bytes of an entry with its model
+static inline size_t entry_size(const CacheHeader *header)
+{
+    return sizeof(CacheEntry) + header->model_words * sizeof(uint64_t);
+}
+
+// Function to get an entry of a set
+static inline CacheEntry *cache_entry(ResultCache *cache, uint32_t set, uint32_t way)
+{
+    CacheHeader *header = (CacheHeader *)cache->file.data;
+    size_t index = (size_t)set * header->ways + way;
+    return (CacheEntry *)(cache->file.data + sizeof(CacheHeader) + index * entry_size(header));
+}
+
+// Function to open a cache file, creating it if it does not exist
+// Returns false (after printing the reason) if it cannot be opened or is not a cache file
+bool cache_open(ResultCache *cache, const char *filename)
+{
+    CacheHeader fresh = {CACHE_MAGIC, CACHE_VERSION, CACHE_ENTRIES / CACHE_WAYS, CACHE_WAYS,
+                         (CACHE_MODEL_VARIABLES + 63) / 64, 0};
+    size_t new_size = sizeof(CacheHeader) + (size_t)CACHE_ENTRIES * entry_size(&fresh);
+    if (!open_shared_file(filename, new_size, &cache->file))
+    {
+        printf("Error: Unable to open the cache file %s\n", filename);
+        return false;
+    }
+
+    // A file just created is all zeros: the first solver to lock it writes the header
+    lock_shared_file(&cache->file, true);
+    CacheHeader *header = (CacheHeader *)cache->file.data;
+    static const CacheHeader zero;
+    if (cache->file.size == new_size && memcmp(header, &zero, sizeof(CacheHeader)) == 0)
+        *header = fresh;
+    bool ok = cache->file.size >= sizeof(CacheHeader) && header->magic == CACHE_MAGIC &&
+              header->version == CACHE_VERSION && header->num_sets > 0 && header->ways > 0 &&
+              cache->file.size >= sizeof(CacheHeader) + (size_t)header->num_sets * header->ways * entry_size(header);
+    unlock_shared_file(&cache->file);
+    if (!ok)
+    {
+        printf("Error: %s is not a result cache of this version\n", filename);
+        close_shared_file(&cache->file);
+        return false;
+    }
+    return true;
+}
+
+// Function to close a cache file
+void cache_close(ResultCache *cache)
+{
+    close_shared_file(&cache->file);
+}
+
+// Function to look up the answer of a formula by its canonical form
+// On SEARCH_SATISFIABLE, the variables of the form get their value in model (indexed by
+// formula variable) and the others are left as they are; the counters of the solve that
+// stored the answer go to stats. Returns SEARCH_UNKNOWN if the formula is not in the cache
+SearchResult cache_lookup(ResultCache *cache, const CanonicalForm *form, int8_t *model, CachedStats *stats)
+{
+    CacheHeader *header = (CacheHeader *)cache->file.data;
+    uint32_t set = (uint32_t)(form->key % header->num_sets);
+    SearchResult result = SEARCH_UNKNOWN;
+
+    lock_shared_file(&cache->file, false);
+    for (uint32_t way = 0; way < header->ways; way++)
+    {
+        CacheEntry *entry = cache_entry(cache, set, way);
+        if (!load_tick(&entry->last_used) || entry->key != form->key || entry->check != form->check ||
+            entry->num_variables != form->num_variables)
+            continue;
+
+        result = (SearchResult)entry->result;
+        *stats = entry->stats;
+        if (result == SEARCH_SATISFIABLE)
+        {
+            const uint64_t *bits = (const uint64_t *)(entry + 1);
+            for (int k = 0; k < form->num_variables; k++)
+            {
+                model[form->order[k]] = (bits[k >> 6] >> (k & 63)) & 1 ? VALUE_TRUE : VALUE_FALSE;
+            }
+        }
+        touch_entry(header, entry);
+        break;
+    }
+    unlock_shared_file(&cache->file);
+    return result;
+}
+
+// Function to store the answer of a formula, with its model (indexed by formula variable)
+// when it is satisfiable; unknown answers, and models with more canonical variables than the
+// file has room for, are not stored
+void cache_store(ResultCache *cache, const CanonicalForm *form, SearchResult result, const int8_t *model,
+                 const CachedStats *stats)
+{
+    CacheHeader *header = (CacheHeader *)cache->file.data;
+    if (result == SEARCH_UNKNOWN ||
+        (result == SEARCH_SATISFIABLE && (!model || form->num_variables > 64 * (int64_t)header->model_words)))
+        return;
+    uint32_t set = (uint32_t)(form->key % header->num_sets);
+
+    lock_shared_file(&cache->file, true);
+
+    // The entry of the formula if another solver stored it meanwhile, else an empty one, else
+    // the one used least recently
+    CacheEntry *target = NULL;
+    for (uint32_t way = 0; way < header->ways; way++)
+    {
+        CacheEntry *entry = cache_entry(cache, set, way);
+        if (entry->last_used && entry->key == form->key && entry->check == form->check &&
+            entry->num_variables == form->num_variables)
+        {
+            target = entry;
+            break;
+        }
+        if (!target || entry->last_used < target->last_used)
+            target = entry;
+    }
+
+    target->key = form->key;
+    target->check = form->check;
+    target->result = (int32_t)result;
+    target->num_variables = form->num_variables;
+    target->stats = *stats;
+    uint64_t *bits = (uint64_t *)(target + 1);
+    memset(bits, 0, header->model_words * sizeof(uint64_t));
+    if (result == SEARCH_SATISFIABLE)
+    {
+        for (int k = 0; k < form->num_variables; k++)
+        {
+            if (model[form->order[k]] == VALUE_TRUE)
+                bits[k >> 6] |= 1ull << (k & 63);
+        }
+    }
+    touch_entry(header, target);
+    unlock_shared_file(&cache->file);
+}
@@ -0,0 +1,453 @@
+/*
+ * Canonical form of a formula: the same whatever the names of its variables and the order of
+ * its clauses and of their literals
+ *
+ * Variables are told apart by colour refinement on the clauses: the colour of a clause is
+ * hashed from the colours and polarities of its literals, then the colour of each variable
+ * from its own and those of the clauses it occurs in, until the variables stop splitting into
+ * more classes. Colour refinement does not always tell apart variables that no symmetry of the
+ * formula exchanges, so the variables left sharing a colour are singled out by a search: each
+ * variable of the tied class of smallest colour is tried in turn, refining again after each,
+ * until every variable has a colour of its own. Each leaf of the search numbers the variables
+ * by colour and sorts the renamed clauses; the smallest of these forms is the canonical one,
+ * and it is hashed. A search that would take more than CANONICAL_SEARCH_ROUNDS times the work
+ * of the first refinement (very symmetric formulas) stops, and the variables are then singled
+ * out in the order of their names, so such formulas are only recognized under renamings that
+ * keep that order.
+ */
+
+#include "solver_internal.h"
+
+#define CANONICAL_MAX_SPLITS 64               // Splits by name once the search stopped
+#define CANONICAL_SEARCH_ROUNDS 64            // Search work, in first refinements of the formula
+#define CANONICAL_MIN_WORK ((int64_t)1 << 20) // Search work allowed whatever the formula
+#define NEGATIVE_SALT 0x9e3779b97f4a7c15ull   // Tells the polarities of a variable apart
+#define SPLIT_SALT 0x632be59bd9b4e019ull      // Colours a variable singled out from its class
+#define KEY_SEED 0x243f6a8885a308d3ull
+#define CHECK_SEED 0x13198a2e03707344ull
+
+// Function to mix the bits of a 64-bit value (splitmix64 finalizer)
+static inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Structure to represent a variable by its colour, for sorting
+typedef struct
+{
+    uint64_t color;
+    int var;
+    const char *name;
+} ColoredVariable;
+
+// Structure to represent the clauses of a formula while its variables are coloured
+typedef struct
+{
+    Literal *literals; // Literals of every clause without tautologies, one clause after the other
+    int *starts;       // Where each clause starts; starts[num_clauses] is the end
+    int num_clauses;
+    int num_variables; // Variables of the formula, occurring in a clause or not
+    uint64_t *colors;  // Colour of each variable, 0 for those in no clause
+    uint64_t *next;    // Colours being computed
+    ColoredVariable *sorted; // Variables occurring in a clause, sorted as needed
+    int num_sorted;
+    int64_t work; // Literals and variables visited so far
+} Refinement;
+
+// Structure to represent the search for the smallest form over the ways of breaking ties
+typedef struct
+{
+    Refinement *refinement;
+    int64_t max_work; // Work of refinement and forms after which the search stops
+    bool stopped;     // The search went over it
+    bool found;       // A form was recorded
+    int length;       // Words of a form: the size and literals of each sorted clause
+    uint32_t *form;
+    uint32_t *best;
+    int *best_order; // Formula variable of each canonical variable of the best form
+    int *number;     // Canonical variable of each formula variable
+    Literal *renamed;
+    Clause *clauses;
+} CanonicalSearch;
+
+// Function to order coloured variables by colour, then by name
+static int compare_colored(const void *a, const void *b)
+{
+    const ColoredVariable *x = a;
+    const ColoredVariable *y = b;
+    if (x->color != y->color)
+        return x->color < y->color ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// Function to sort the variables of a refinement by their current colour
+static void sort_variables(Refinement *refinement)
+{
+    for (int i = 0; i < refinement->num_sorted; i++)
+    {
+        refinement->sorted[i].color = refinement->colors[refinement->sorted[i].var];
+    }
+    qsort(refinement->sorted, refinement->num_sorted, sizeof(ColoredVariable), compare_colored);
+}
+
+// Function to count the colours of the variables
+static int count_colors(Refinement *refinement)
+{
+    sort_variables(refinement);
+    int count = 0;
+    for (int i = 0; i < refinement->num_sorted; i++)
+    {
+        if (i == 0 || refinement->sorted[i].color != refinement->sorted[i - 1].color)
+            count++;
+    }
+    return count;
+}
+
+// Function to recolour the variables until they stop splitting into more classes
+// Returns the number of classes
+static int refine(Refinement *refinement, int classes)
+{
+    uint64_t *colors = refinement->colors;
+    for (;;)
+    {
+        uint64_t *next = refinement->next;
+        memset(next, 0, refinement->num_variables * sizeof(uint64_t));
+        for (int c = 0; c < refinement->num_clauses; c++)
+        {
+            const Literal *lits = refinement->literals + refinement->starts[c];
+            int size = refinement->starts[c + 1] - refinement->starts[c];
+
+            // Sums of mixed colours do not depend on the order of the literals
+            uint64_t sum = 0;
+            for (int i = 0; i < size; i++)
+            {
+                sum += mix64(colors[literal_var(lits[i])] ^ (literal_is_negated(lits[i]) ? NEGATIVE_SALT : 0));
+            }
+            uint64_t clause_color = mix64(sum + (uint64_t)size);
+            for (int i = 0; i < size; i++)
+            {
+                next[literal_var(lits[i])] += mix64(clause_color ^ (literal_is_negated(lits[i]) ? NEGATIVE_SALT : 0));
+            }
+        }
+
+        // The old colour takes part, so classes only ever split
+        for (int i = 0; i < refinement->num_sorted; i++)
+        {
+            int var = refinement->sorted[i].var;
+            next[var] = mix64(colors[var] + mix64(next[var] + 1));
+        }
+        refinement->next = colors;
+        refinement->colors = colors = next;
+        refinement->work += refinement->starts[refinement->num_clauses] + refinement->num_sorted;
+
+        int count = count_colors(refinement);
+        if (count <= classes)
+            return count;
+        classes = count;
+    }
+}
+
+// Function to order canonical clauses by size, then literal by literal
+static int compare_clauses(const void *a, const void *b)
+{
+    const Clause *x = a;
+    const Clause *y = b;
+    if (x->num_literals != y->num_literals)
+        return x->num_literals < y->num_literals ? -1 : 1;
+    for (int i = 0; i < x->num_literals; i++)
+    {
+        if (x->literals[i] != y->literals[i])
+            return x->literals[i] < y->literals[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// Function to hash the sorted canonical clauses, repeats counted once
+static uint64_t hash_clauses(const Clause *clauses, int num_clauses, int num_variables, uint64_t seed)
+{
+    uint64_t hash = mix64(seed ^ (uint64_t)num_variables);
+    for (int c = 0; c < num_clauses; c++)
+    {
+        if (c > 0 && compare_clauses(&clauses[c - 1], &clauses[c]) == 0)
+            continue;
+        hash = mix64(hash ^ (0x100000000ull | (uint64_t)clauses[c].num_literals));
+        for (int i = 0; i < clauses[c].num_literals; i++)
+        {
+            hash = mix64(hash ^ clauses[c].literals[i]);
+        }
+    }
+    return hash;
+}
+
+// Function to free the working data of a refinement
+static void free_refinement(Refinement *refinement)
+{
+    free(refinement->literals);
+    free(refinement->starts);
+    free(refinement->colors);
+    free(refinement->next);
+    free(refinement->sorted);
+}
+
+// Function to copy the clauses of a formula into a refinement, sorted and without
+// tautologies, and give every variable occurring in them the same colour
+// Returns false if out of memory
+static bool init_refinement(Refinement *refinement, Formula *formula)
+{
+    memset(refinement, 0, sizeof(*refinement));
+    size_t total = 0;
+    for (int c = 0; c < formula->num_clauses; c++)
+    {
+        total += formula->clauses[c].num_literals;
+    }
+    int num_variables = formula->num_variables;
+    refinement->num_variables = num_variables;
+    refinement->literals = malloc((total > 0 ? total : 1) * sizeof(Literal));
+    refinement->starts = malloc((formula->num_clauses + 1) * sizeof(int));
+    refinement->colors = calloc(num_variables > 0 ? num_variables : 1, sizeof(uint64_t));
+    refinement->next = calloc(num_variables > 0 ? num_variables : 1, sizeof(uint64_t));
+    refinement->sorted = malloc((num_variables > 0 ? num_variables : 1) * sizeof(ColoredVariable));
+    if (!refinement->literals || !refinement->starts || !refinement->colors || !refinement->next ||
+        !refinement->sorted)
+    {
+        free_refinement(refinement);
+        return false;
+    }
+
+    int used = 0;
+    for (int c = 0; c < formula->num_clauses; c++)
+    {
+        Clause clause = {refinement->literals + used, formula->clauses[c].num_literals, 0, false};
+        memcpy(clause.literals, formula->clauses[c].literals, clause.num_literals * sizeof(Literal));
+        if (!canonicalize_clause(&clause))
+            continue;
+        refinement->starts[refinement->num_clauses++] = used;
+        used += clause.num_literals;
+        for (int i = 0; i < clause.num_literals; i++)
+        {
+            refinement->colors[literal_var(clause.literals[i])] = 1;
+        }
+    }
+    refinement->starts[refinement->num_clauses] = used;
+
+    for (int v = 0; v < num_variables; v++)
+    {
+        if (refinement->colors[v])
+        {
+            ColoredVariable entry = {1, v, formula->variables[v].name};
+            refinement->sorted[refinement->num_sorted++] = entry;
+        }
+    }
+    return true;
+}
+
+// Function to free the working data of a search
+static void free_search(CanonicalSearch *search)
+{
+    free(search->form);
+    free(search->best);
+    free(search->best_order);
+    free(search->number);
+    free(search->renamed);
+    free(search->clauses);
+}
+
+// Function to set up the search over a refinement
+// Returns false if out of memory
+static bool init_search(CanonicalSearch *search, Refinement *refinement)
+{
+    memset(search, 0, sizeof(*search));
+    search->refinement = refinement;
+    int total = refinement->starts[refinement->num_clauses];
+    search->length = refinement->num_clauses + total;
+    search->form = malloc((search->length > 0 ? search->length : 1) * sizeof(uint32_t));
+    search->best = malloc((search->length > 0 ? search->length : 1) * sizeof(uint32_t));
+    search->best_order = malloc((refinement->num_sorted > 0 ? refinement->num_sorted : 1) * sizeof(int));
+    search->number = malloc((refinement->num_variables > 0 ? refinement->num_variables : 1) * sizeof(int));
+    search->renamed = malloc((total > 0 ? total : 1) * sizeof(Literal));
+    search->clauses = malloc((refinement->num_clauses > 0 ? refinement->num_clauses : 1) * sizeof(Clause));
+    if (!search->form || !search->best || !search->best_order || !search->number || !search->renamed ||
+        !search->clauses)
+    {
+        free_search(search);
+        return false;
+    }
+    return true;
+}
+
+// Function to number the variables in their current order, rename and sort the clauses, and
+// keep the result if it is the smallest form so far
+static void record_form(CanonicalSearch *search)
+{
+    Refinement *refinement = search->refinement;
+    for (int k = 0; k < refinement->num_sorted; k++)
+    {
+        search->number[refinement->sorted[k].var] = k;
+    }
+    for (int c = 0; c < refinement->num_clauses; c++)
+    {
+        Clause *clause = &search->clauses[c];
+        clause->literals = search->renamed + refinement->starts[c];
+        clause->num_literals = refinement->starts[c + 1] - refinement->starts[c];
+        clause->capacity = 0;
+        clause->is_goal = false;
+        const Literal *lits = refinement->literals + refinement->starts[c];
+        for (int i = 0; i < clause->num_literals; i++)
+        {
+            clause->literals[i] = make_literal(search->number[literal_var(lits[i])], literal_is_negated(lits[i]));
+        }
+        canonicalize_clause(clause); // Only reorders: no tautology is left
+    }
+    qsort(search->clauses, refinement->num_clauses, sizeof(Clause), compare_clauses);
+    refinement->work += search->length;
+
+    int used = 0;
+    for (int c = 0; c < refinement->num_clauses; c++)
+    {
+        search->form[used++] = (uint32_t)search->clauses[c].num_literals;
+        for (int i = 0; i < search->clauses[c].num_literals; i++)
+        {
+            search->form[used++] = search->clauses[c].literals[i];
+        }
+    }
+    // Any fixed order of the forms will do, so they are compared as bytes
+    if (search->found && memcmp(search->form, search->best, search->length * sizeof(uint32_t)) >= 0)
+        return;
+    uint32_t *swap = search->best;
+    search->best = search->form;
+    search->form = swap;
+    for (int k = 0; k < refinement->num_sorted; k++)
+    {
+        search->best_order[k] = refinement->sorted[k].var;
+    }
+    search->found = true;
+}
+
+// Function to single out in turn each variable of the tied class of smallest colour, refining
+// after each, down to classes of one variable, and record the forms reached
+// Returns false if out of memory
+static bool search_forms(CanonicalSearch *search, int classes)
+{
+    Refinement *refinement = search->refinement;
+    if (classes == refinement->num_sorted)
+    {
+        record_form(search);
+        return true;
+    }
+    if (refinement->work > search->max_work)
+    {
+        search->stopped = true;
+        return true;
+    }
+
+    // The class is chosen by colour, and every variable of it is tried, so the forms reached
+    // do not depend on the names
+    ColoredVariable *sorted = refinement->sorted;
+    int first = 0;
+    while (first + 1 < refinement->num_sorted && sorted[first].color != sorted[first + 1].color)
+        first++;
+    int size = 1;
+    while (first + size < refinement->num_sorted && sorted[first + size].color == sorted[first].color)
+        size++;
+    uint64_t color = sorted[first].color;
+    int *candidates = malloc(size * sizeof(int));
+    uint64_t *saved = malloc((refinement->num_variables > 0 ? refinement->num_variables : 1) * sizeof(uint64_t));
+    if (!candidates || !saved)
+    {
+        free(candidates);
+        free(saved);
+        return false;
+    }
+    for (int i = 0; i < size; i++)
+    {
+        candidates[i] = sorted[first + i].var;
+    }
+    memcpy(saved, refinement->colors, refinement->num_variables * sizeof(uint64_t));
+
+    bool ok = true;
+    for (int i = 0; i < size && ok && !search->stopped; i++)
+    {
+        memcpy(refinement->colors, saved, refinement->num_variables * sizeof(uint64_t));
+        refinement->colors[candidates[i]] = mix64(color ^ SPLIT_SALT);
+        ok = search_forms(search, refine(refinement, classes + 1));
+    }
+    memcpy(refinement->colors, saved, refinement->num_variables * sizeof(uint64_t));
+    free(candidates);
+    free(saved);
+    return ok;
+}
+
+// Function to compute the canonical form of a formula
+// Returns false if out of memory
+bool canonical_form(Formula *formula, CanonicalForm *form)
+{
+    memset(form, 0, sizeof(*form));
+    Refinement refinement;
+    CanonicalSearch search;
+    if (!init_refinement(&refinement, formula))
+        return false;
+    if (!init_search(&search, &refinement))
+    {
+        free_refinement(&refinement);
+        return false;
+    }
+
+    int classes = refine(&refinement, refinement.num_sorted > 0 ? 1 : 0);
+    search.max_work = refinement.work * CANONICAL_SEARCH_ROUNDS + CANONICAL_MIN_WORK;
+    bool ok = search_forms(&search, classes);
+    if (ok && search.stopped)
+    {
+        // Too symmetric to search: single out the first variable, by name, of the class with
+        // the smallest colour among those of several variables
+        count_colors(&refinement);
+        for (int split = 0; split < CANONICAL_MAX_SPLITS && classes < refinement.num_sorted; split++)
+        {
+            ColoredVariable *sorted = refinement.sorted;
+            int first = 0;
+            while (first + 1 < refinement.num_sorted && sorted[first].color != sorted[first + 1].color)
+                first++;
+            refinement.colors[sorted[first].var] = mix64(sorted[first].color ^ SPLIT_SALT);
+            classes = refine(&refinement, classes + 1);
+        }
+        search.found = false;
+        record_form(&search);
+    }
+
+    form->num_variables = refinement.num_sorted;
+    form->order = ok ? malloc((refinement.num_sorted > 0 ? refinement.num_sorted : 1) * sizeof(int)) : NULL;
+    if (!form->order)
+    {
+        free_search(&search);
+        free_refinement(&refinement);
+        free_canonical_form(form);
+        return false;
+    }
+    memcpy(form->order, search.best_order, refinement.num_sorted * sizeof(int));
+
+    // Hash the clauses of the best form back from its words
+    int used = 0;
+    for (int c = 0; c < refinement.num_clauses; c++)
+    {
+        search.clauses[c].num_literals = (int)search.best[used++];
+        search.clauses[c].literals = (Literal *)&search.best[used];
+        used += search.clauses[c].num_literals;
+    }
+    form->key = hash_clauses(search.clauses, refinement.num_clauses, form->num_variables, KEY_SEED);
+    form->check = hash_clauses(search.clauses, refinement.num_clauses, form->num_variables, CHECK_SEED);
+
+    free_search(&search);
+    free_refinement(&refinement);
+    return true;
+}
+
+// Function to free a canonical form
+void free_canonical_form(CanonicalForm *form)
+{
+    free(form->order);
+    memset(form, 0, sizeof(*form));
+}
@@ -0,0 +1,586 @@
+/*
+ * Conflict-driven clause learning (CDCL) search engine
+ */
+
+#include "solver_internal.h"
+
+#define RESTART_BASE 100          // Conflicts per unit of the Luby restart sequence
+#define VAR_DECAY 0.95            // EVSIDS: the bump grows by 1 / VAR_DECAY after each conflict
+#define ACTIVITY_LIMIT 1e100      // Rescale activities before they overflow
+#define LEARNED_GROWTH 1.1        // Growth of the learned clause limit after each reduction
+#define MIN_LEARNED_LIMIT 2000
+#define GLUE_LBD 2                // Learned clauses with LBD at most this are never deleted
+#define BUDGET_POLL_INTERVAL 256  // Decisions between two checks of the clock and memory budgets
+
+// Function to move a variable up the heap until its parent is at least as active
+static void heap_sift_up(CdclSolver *solver, int pos)
+{
+    int var = solver->heap[pos];
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (solver->activity[solver->heap[parent]] >= solver->activity[var])
+            break;
+        solver->heap[pos] = solver->heap[parent];
+        solver->heap_index[solver->heap[pos]] = pos;
+        pos = parent;
+    }
+    solver->heap[pos] = var;
+    solver->heap_index[var] = pos;
+}
+
+// Function to move a variable down the heap until its children are at most as active
+static void heap_sift_down(CdclSolver *solver, int pos)
+{
+    int var = solver->heap[pos];
+    for (;;)
+    {
+        int child = 2 * pos + 1;
+        if (child >= solver->heap_size)
+            break;
+        if (child + 1 < solver->heap_size &&
+            solver->activity[solver->heap[child + 1]] > solver->activity[solver->heap[child]])
+            child++;
+        if (solver->activity[solver->heap[child]] <= solver->activity[var])
+            break;
+        solver->heap[pos] = solver->heap[child];
+        solver->heap_index[solver->heap[pos]] = pos;
+        pos = child;
+    }
+    solver->heap[pos] = var;
+    solver->heap_index[var] = pos;
+}
+
+// Function to put a variable back into the decision heap
+static void heap_insert(CdclSolver *solver, int var)
+{
+    if (solver->heap_index[var] >= 0)
+        return;
+    solver->heap[solver->heap_size] = var;
+    solver->heap_index[var] = solver->heap_size;
+    solver->heap_size++;
+    heap_sift_up(solver, solver->heap_size - 1);
+}
+
+// Function to take the most active variable out of the decision heap
+static int heap_pop(CdclSolver *solver)
+{
+    int top = solver->heap[0];
+    solver->heap_index[top] = -1;
+    solver->heap_size--;
+    if (solver->heap_size > 0)
+    {
+        solver->heap[0] = solver->heap[solver->heap_size];
+        solver->heap_index[solver->heap[0]] = 0;
+        heap_sift_down(solver, 0);
+    }
+    return top;
+}
+
+// Function to increase the activity of a variable involved in a conflict
+static void bump_variable(CdclSolver *solver, int var)
+{
+    solver->activity[var] += solver->var_increment;
+    if (solver->activity[var] > ACTIVITY_LIMIT)
+    {
+        for (int v = 0; v < solver->prop.num_vars; v++)
+            solver->activity[v] *= 1.0 / ACTIVITY_LIMIT;
+        solver->var_increment *= 1.0 / ACTIVITY_LIMIT;
+    }
+    if (solver->heap_index[var] >= 0)
+        heap_sift_up(solver, solver->heap_index[var]);
+}
+
+// Function to free a CDCL solver
+void free_cdcl_solver(CdclSolver *solver)
+{
+    free_propagator(&solver->prop);
+    free(solver->saved_phases);
+    free(solver->activity);
+    free(solver->heap);
+    free(solver->heap_index);
+    free(solver->seen);
+    free(solver->learned);
+    free(solver->analyze_stack);
+    free(solver->analyze_toclear);
+    free(solver->level_stamps);
+    memset(solver, 0, sizeof(*solver));
+}
+
+// Function to make room for more variables in a CDCL solver; new variables join the decision heap
+// Returns false on memory error, leaving the solver usable with its old size
+bool cdcl_reserve_variables(CdclSolver *solver, int num_vars)
+{
+    int old_vars = solver->saved_phases ? solver->prop.num_vars : 0;
+    if (num_vars <= old_vars && solver->saved_phases)
+        return true;
+
+    // Allocate at least one entry so that an empty formula still gets valid arrays
+    size_t old_n = solver->saved_phases ? (size_t)old_vars + 1 : 0;
+    size_t n = (size_t)num_vars + 1;
+    bool *saved_phases = realloc(solver->saved_phases, n * sizeof(bool));
+    if (saved_phases)
+        solver->saved_phases = saved_phases;
+    double *activity = realloc(solver->activity, n * sizeof(double));
+    if (activity)
+        solver->activity = activity;
+    int *heap = realloc(solver->heap, n * sizeof(int));
+    if (heap)
+        solver->heap = heap;
+    int *heap_index = realloc(solver->heap_index, n * sizeof(int));
+    if (heap_index)
+        solver->heap_index = heap_index;
+    uint8_t *seen = realloc(solver->seen, n * sizeof(uint8_t));
+    if (seen)
+        solver->seen = seen;
+    Literal *learned = realloc(solver->learned, n * sizeof(Literal));
+    if (learned)
+        solver->learned = learned;
+    Literal *analyze_stack = realloc(solver->analyze_stack, n * sizeof(Literal));
+    if (analyze_stack)
+        solver->analyze_stack = analyze_stack;
+    Literal *analyze_toclear = realloc(solver->analyze_toclear, n * sizeof(Literal));
+    if (analyze_toclear)
+        solver->analyze_toclear = analyze_toclear;
+    int *level_stamps = realloc(solver->level_stamps, n * sizeof(int));
+    if (level_stamps)
+        solver->level_stamps = level_stamps;
+    if (!saved_phases || !activity || !heap || !heap_index || !seen || !learned || !analyze_stack ||
+        !analyze_toclear || !level_stamps || !propagator_reserve_variables(&solver->prop, num_vars))
+        return false;
+
+    for (size_t v = old_n; v < n; v++)
+    {
+        solver->saved_phases[v] = solver->initial_phase;
+        solver->activity[v] = 0.0;
+        solver->heap_index[v] = -1;
+        solver->seen[v] = 0;
+        solver->level_stamps[v] = 0;
+    }
+    for (int v = old_vars; v < num_vars; v++)
+    {
+        heap_insert(solver, v);
+    }
+    return true;
+}
+
+// Function to initialize a CDCL solver for a number of variables
+bool init_cdcl_solver(CdclSolver *solver, int num_vars)
+{
+    memset(solver, 0, sizeof(*solver));
+    if (!init_propagator(&solver->prop, 0))
+        return false;
+    solver->max_learned = MIN_LEARNED_LIMIT;
+    solver->var_increment = 1.0;
+    solver->initial_phase = true;
+    solver->restart_base = RESTART_BASE;
+    if (!cdcl_reserve_variables(solver, num_vars))
+    {
+        free_cdcl_solver(solver);
+        return false;
+    }
+    return true;
+}
+
+// Function to undo all assignments above a decision level, saving their phases
+static void cdcl_backtrack(CdclSolver *solver, int level)
+{
+    Propagator *prop = &solver->prop;
+    if (prop->decision_level <= level)
+        return;
+
+    for (int i = prop->trail_size - 1; i >= prop->trail_limits[level]; i--)
+    {
+        Literal lit = prop->trail[i];
+        solver->saved_phases[literal_var(lit)] = literal_is_negated(lit);
+        heap_insert(solver, literal_var(lit));
+    }
+    propagator_backtrack(prop, level);
+}
+
+// Function to record the peak size of the clause database
+static inline void note_peak(CdclSolver *solver)
+{
+    COUNTER_MAX(solver->stats.peak_clauses, solver->prop.num_clauses);
+    COUNTER_MAX(solver->stats.peak_bytes, (long long)solver->prop.pool.size * (long long)sizeof(uint32_t));
+    (void)solver; // Unused once the counters are compiled out
+}
+
+// Function to add a learned clause and record its LBD; returns it or NO_REASON
+static ClauseRef cdcl_add_learned(CdclSolver *solver, const Literal *literals, int size, int lbd)
+{
+    ClauseRef ref = propagator_add_clause(&solver->prop, literals, size, true);
+    if (ref == NO_REASON)
+        return NO_REASON;
+
+    pool_clause(&solver->prop.pool, ref)->lbd = (uint16_t)(lbd < UINT16_MAX ? lbd : UINT16_MAX);
+    solver->num_learned++;
+    return ref;
+}
+
+// Function to map a decision level to one bit of a 32-bit level summary
+static inline uint32_t abstract_level(int level)
+{
+    return 1u << (level & 31);
+}
+
+// Function to check if a learned literal is implied by the other literals of the learned
+// clause, following reason clauses recursively (all visited literals must end in the clause)
+// Literals marked seen on the way are recorded in analyze_toclear
+static bool literal_is_redundant(CdclSolver *solver, Literal lit, uint32_t levels)
+{
+    Propagator *prop = &solver->prop;
+    int stack_size = 0;
+    int top = solver->toclear_size;
+    solver->analyze_stack[stack_size++] = lit;
+
+    while (stack_size > 0)
+    {
+        PoolClause *clause = pool_clause(&prop->pool, prop->reasons[literal_var(solver->analyze_stack[--stack_size])]);
+        for (int k = 1; k < (int)clause->num_literals; k++)
+        {
+            Literal q = clause->literals[k];
+            int var = literal_var(q);
+            if (solver->seen[var] || prop->levels[var] == 0)
+                continue;
+
+            // Decisions and literals from levels absent from the clause cannot be implied by it
+            if (prop->reasons[var] == NO_REASON || !(abstract_level(prop->levels[var]) & levels))
+            {
+                for (int i = top; i < solver->toclear_size; i++)
+                    solver->seen[literal_var(solver->analyze_toclear[i])] = 0;
+                solver->toclear_size = top;
+                return false;
+            }
+            solver->seen[var] = 1;
+            solver->analyze_stack[stack_size++] = q;
+            solver->analyze_toclear[solver->toclear_size++] = q;
+        }
+    }
+    return true;
+}
+
+// Function to derive the first-UIP clause of a conflict
+// Fills solver->learned and returns its size; learned[0] is the asserting literal and
+// learned[1] (if any) has the highest decision level among the others
+static int cdcl_analyze(CdclSolver *solver, ClauseRef conflict, int *backtrack_level, int *lbd)
+{
+    Propagator *prop = &solver->prop;
+    int size = 1; // learned[0] is filled in at the end
+    int pending = 0;
+    Literal lit = LITERAL_UNDEF;
+    int index = prop->trail_size - 1;
+
+    do
+    {
+        PoolClause *clause = pool_clause(&prop->pool, conflict);
+        // The implied literal of a reason clause is its literals[0]
+        for (int k = (lit == LITERAL_UNDEF) ? 0 : 1; k < (int)clause->num_literals; k++)
+        {
+            Literal q = clause->literals[k];
+            int var = literal_var(q);
+            if (solver->seen[var] || prop->levels[var] == 0)
+                continue;
+
+            solver->seen[var] = 1;
+            bump_variable(solver, var);
+            if (prop->levels[var] >= prop->decision_level)
+                pending++;
+            else
+                solver->learned[size++] = q;
+        }
+
+        // Walk back the trail to the next literal of the conflict at the current level
+        while (!solver->seen[literal_var(prop->trail[index])])
+            index--;
+        lit = prop->trail[index--];
+        conflict = prop->reasons[literal_var(lit)];
+        solver->seen[literal_var(lit)] = 0;
+        pending--;
+    } while (pending > 0);
+    solver->learned[0] = negate_literal(lit);
+
+    // Drop literals implied by the rest of the clause through their reasons; dropped
+    // literals stay seen since they are still implied by the clause
+    uint32_t levels = 0;
+    solver->toclear_size = 0;
+    for (int i = 1; i < size; i++)
+    {
+        levels |= abstract_level(prop->levels[literal_var(solver->learned[i])]);
+        solver->analyze_toclear[solver->toclear_size++] = solver->learned[i];
+    }
+    int kept = 1;
+    for (int i = 1; i < size; i++)
+    {
+        Literal q = solver->learned[i];
+        if (prop->reasons[literal_var(q)] == NO_REASON || !literal_is_redundant(solver, q, levels))
+            solver->learned[kept++] = q;
+    }
+    for (int i = 0; i < solver->toclear_size; i++)
+        solver->seen[literal_var(solver->analyze_toclear[i])] = 0;
+    size = kept;
+
+    // Put the literal with the highest level second: it is watched and decides the backjump
+    *backtrack_level = 0;
+    if (size > 1)
+    {
+        int max_index = 1;
+        for (int i = 2; i < size; i++)
+        {
+            if (prop->levels[literal_var(solver->learned[i])] > prop->levels[literal_var(solver->learned[max_index])])
+                max_index = i;
+        }
+        Literal tmp = solver->learned[1];
+        solver->learned[1] = solver->learned[max_index];
+        solver->learned[max_index] = tmp;
+        *backtrack_level = prop->levels[literal_var(solver->learned[1])];
+    }
+
+    // Count the distinct decision levels of the clause
+    solver->stamp++;
+    *lbd = 0;
+    for (int i = 0; i < size; i++)
+    {
+        int level = prop->levels[literal_var(solver->learned[i])];
+        if (solver->level_stamps[level] != solver->stamp)
+        {
+            solver->level_stamps[level] = solver->stamp;
+            (*lbd)++;
+        }
+    }
+    return size;
+}
+
+// Structure to rank a learned clause for deletion
+typedef struct
+{
+    ClauseRef clause;
+    int lbd;
+    int size;
+} ReduceCandidate;
+
+// Function to compare learned clauses for reduction: least useful (highest LBD, longest) first
+static int compare_reduce_candidates(const void *a, const void *b)
+{
+    const ReduceCandidate *c1 = a;
+    const ReduceCandidate *c2 = b;
+    if (c1->lbd != c2->lbd)
+        return c2->lbd - c1->lbd;
+    if (c1->size != c2->size)
+        return c2->size - c1->size;
+    return (c1->clause > c2->clause) - (c1->clause < c2->clause);
+}
+
+// Function to delete about half of the learned clauses, keeping glue and reason clauses
+static void cdcl_reduce_learned(CdclSolver *solver)
+{
+    Propagator *prop = &solver->prop;
+    ReduceCandidate *candidates = malloc((solver->num_learned + 1) * sizeof(ReduceCandidate));
+    if (!candidates)
+        return;
+
+    int count = 0;
+    for (ClauseRef ref = 0; ref < prop->pool.size; ref = pool_next(&prop->pool, ref))
+    {
+        PoolClause *clause = pool_clause(&prop->pool, ref);
+        if ((clause->flags & (POOL_LEARNED | POOL_DELETED)) != POOL_LEARNED || clause->lbd <= GLUE_LBD ||
+            propagator_clause_is_reason(prop, ref))
+            continue;
+        candidates[count].clause = ref;
+        candidates[count].lbd = clause->lbd;
+        candidates[count].size = (int)clause->num_literals;
+        count++;
+    }
+
+    qsort(candidates, count, sizeof(ReduceCandidate), compare_reduce_candidates);
+    for (int i = 0; i < count / 2; i++)
+    {
+        PoolClause *clause = pool_clause(&prop->pool, candidates[i].clause);
+        proof_delete(solver->proof, clause->literals, (int)clause->num_literals);
+        propagator_remove_clause(prop, candidates[i].clause);
+        solver->num_learned--;
+        solver->stats.deleted_clauses++;
+    }
+    free(candidates);
+    propagator_collect_garbage(prop);
+}
+
+// Function to compute the Luby restart sequence 1, 1, 2, 1, 1, 2, 4, ...
+static long luby(long index)
+{
+    long size = 1, power = 1;
+    while (size < index + 1)
+    {
+        size = 2 * size + 1;
+        power *= 2;
+    }
+    while (size - 1 != index)
+    {
+        size = (size - 1) / 2;
+        power /= 2;
+        index %= size;
+    }
+    return power;
+}
+
+// Function to add the clauses of a formula, from a given index on, to a CDCL solver
+// Variables the formula gained since the last call are added too; returns false on memory error
+bool cdcl_load_formula(CdclSolver *solver, Formula *formula, int first)
+{
+    Propagator *prop = &solver->prop;
+    cdcl_backtrack(solver, 0);
+    if (!cdcl_reserve_variables(solver, formula->num_variables))
+        return false;
+
+    int conflict_clause;
+    if (!propagator_load_formula(prop, formula, first, &conflict_clause))
+        return false;
+    if (conflict_clause >= 0 && !solver->unsatisfiable)
+    {
+        proof_add(solver->proof, NULL, 0);
+        solver->unsatisfiable = true;
+    }
+
+    // Allow a third as many learned clauses as there are original ones before reducing
+    double limit = (prop->num_clauses - solver->num_learned) / 3.0;
+    if (solver->max_learned < limit)
+        solver->max_learned = limit;
+    return true;
+}
+
+// Function to search for an assignment of the loaded clauses that satisfies the assumptions
+// The assumptions (on distinct variables) are decided first, one decision level each, and
+// only hold for this call; learned clauses are kept for later calls. The assignment found
+// stays on the trail until the next call. Returns SEARCH_UNKNOWN, with the reason in
+// stopped, when the budget runs out, the cancel flag is raised or memory runs out
+SearchResult cdcl_search(CdclSolver *solver, const Literal *assumptions, int num_assumptions)
+{
+    Propagator *prop = &solver->prop;
+    cdcl_backtrack(solver, 0);
+
+    SearchResult result = SEARCH_UNSATISFIABLE;
+    long conflicts_until_restart = solver->restart_base * luby(solver->stats.restarts);
+    long max_conflicts = solver->budget.conflicts > 0 ? solver->stats.conflicts + solver->budget.conflicts : -1;
+    double deadline = budget_deadline(&solver->budget);
+    int steps_until_poll = 0;
+    solver->stopped = STOP_NONE;
+
+    while (!solver->unsatisfiable && !solver->stopped)
+    {
+        ClauseRef conflict = propagator_propagate(prop);
+        if (prop->out_of_memory)
+        {
+            solver->stopped = STOP_MEMORY;
+            break;
+        }
+        if (conflict != NO_REASON)
+        {
+            solver->stats.conflicts++;
+            if (prop->decision_level == 0)
+            {
+                proof_add(solver->proof, NULL, 0);
+                solver->unsatisfiable = true;
+                break;
+            }
+
+            int backtrack_level, lbd;
+            int size = cdcl_analyze(solver, conflict, &backtrack_level, &lbd);
+            cdcl_backtrack(solver, backtrack_level);
+
+            proof_add(solver->proof, solver->learned, size);
+            if (size == 1)
+            {
+                propagator_assign(prop, solver->learned[0], NO_REASON);
+            }
+            else
+            {
+                ClauseRef learned = cdcl_add_learned(solver, solver->learned, size, lbd);
+                if (learned == NO_REASON)
+                {
+                    prop->out_of_memory = true;
+                    solver->stopped = STOP_MEMORY;
+                    break;
+                }
+                propagator_assign(prop, solver->learned[0], learned);
+            }
+            solver->stats.learned_clauses++;
+            note_peak(solver);
+            solver->var_increment *= 1.0 / VAR_DECAY;
+            conflicts_until_restart--;
+            if (solver->stats.conflicts == max_conflicts)
+                solver->stopped = STOP_CONFLICTS;
+            continue;
+        }
+
+        if (conflicts_until_restart <= 0)
+        {
+            solver->stats.restarts++;
+            conflicts_until_restart = solver->restart_base * luby(solver->stats.restarts);
+            cdcl_backtrack(solver, 0);
+        }
+
+        // The clock, the cancel flag and the clause database are checked every few
+        // hundred decisions
+        if (--steps_until_poll <= 0)
+        {
+            steps_until_poll = BUDGET_POLL_INTERVAL;
+            solver->stopped = budget_check_clock(deadline, solver->cancel);
+            if (!solver->stopped)
+                solver->stopped = budget_check_clauses(&solver->budget, prop->num_clauses, &prop->pool);
+            if (solver->stopped)
+                break;
+        }
+
+        if (solver->num_learned - prop->trail_size >= solver->max_learned)
+        {
+            cdcl_reduce_learned(solver);
+            solver->max_learned *= LEARNED_GROWTH;
+        }
+
+        // Decide the next assumption; one already true gets an empty level so that level
+        // i + 1 always belongs to assumption i
+        Literal decision = LITERAL_UNDEF;
+        bool failed = false;
+        while (prop->decision_level < num_assumptions && decision == LITERAL_UNDEF && !failed)
+        {
+            Literal assumption = assumptions[prop->decision_level];
+            if (prop->values[assumption] == VALUE_TRUE)
+                propagator_new_level(prop);
+            else if (prop->values[assumption] == VALUE_FALSE)
+                failed = true;
+            else
+                decision = assumption;
+        }
+        if (failed)
+            break;
+
+        // Otherwise pick the most active unassigned variable, with its saved polarity
+        while (decision == LITERAL_UNDEF && solver->heap_size > 0)
+        {
+            int candidate = heap_pop(solver);
+            if (prop->values[make_literal(candidate, false)] == VALUE_UNASSIGNED)
+                decision = make_literal(candidate, solver->saved_phases[candidate]);
+        }
+        if (decision == LITERAL_UNDEF)
+        {
+            result = SEARCH_SATISFIABLE;
+            break;
+        }
+
+        COUNTER_ADD(solver->stats.decisions, 1);
+        propagator_new_level(prop);
+        propagator_assign(prop, decision, NO_REASON);
+    }
+
+    solver->stats.propagations = prop->propagations;
+    note_peak(solver);
+    return solver->stopped ? SEARCH_UNKNOWN : result;
+}
+
+// Function to read the model off the trail after a satisfiable search
+// Every variable is assigned at that point; model gets the VALUE_* of each of them
+void cdcl_copy_model(CdclSolver *solver, int8_t *model, int num_vars)
+{
+    for (int v = 0; v < num_vars; v++)
+        model[v] = v < solver->prop.num_vars ? solver->prop.values[make_literal(v, false)] : VALUE_FALSE;
+}
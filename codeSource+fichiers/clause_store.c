@@ -0,0 +1,703 @@
+/*
+ * Flat clause pool and the canonical clause store used by resolution
+ */
+
+#include "solver_internal.h"
+
+// Function to initialize an empty clause pool
+void init_clause_pool(ClausePool *pool)
+{
+    pool->words = NULL;
+    pool->size = 0;
+    pool->capacity = 0;
+    pool->wasted = 0;
+}
+
+// Function to free a clause pool
+void free_clause_pool(ClausePool *pool)
+{
+    free(pool->words);
+    init_clause_pool(pool);
+}
+
+// Function to make room for a number of additional words in a pool
+bool pool_reserve(ClausePool *pool, size_t words)
+{
+    size_t needed = (size_t)pool->size + words;
+    if (needed <= pool->capacity)
+        return true;
+    if (needed >= CLAUSE_REF_UNDEF)
+        return false; // References must fit in 32 bits
+
+    size_t new_capacity = pool->capacity ? pool->capacity : INITIAL_CAPACITY * POOL_HEADER_WORDS;
+    while (new_capacity < needed)
+        new_capacity *= GROWTH_FACTOR;
+    if (new_capacity >= CLAUSE_REF_UNDEF)
+        new_capacity = CLAUSE_REF_UNDEF - 1;
+
+    uint32_t *new_words = realloc(pool->words, new_capacity * sizeof(uint32_t));
+    if (!new_words)
+        return false;
+    pool->words = new_words;
+    pool->capacity = (uint32_t)new_capacity;
+    return true;
+}
+
+// Function to append a clause to a pool; returns its reference or CLAUSE_REF_UNDEF
+ClauseRef pool_add_clause(ClausePool *pool, const Literal *literals, int num_literals, uint16_t flags)
+{
+    if (!pool_reserve(pool, POOL_HEADER_WORDS + (size_t)num_literals))
+        return CLAUSE_REF_UNDEF;
+
+    ClauseRef ref = pool->size;
+    PoolClause *clause = pool_clause(pool, ref);
+    clause->num_literals = (uint32_t)num_literals;
+    clause->flags = flags;
+    clause->lbd = 0;
+    clause->forward = ref;
+    memcpy(clause->literals, literals, num_literals * sizeof(Literal));
+    pool->size += POOL_HEADER_WORDS + (uint32_t)num_literals;
+    return ref;
+}
+
+// Function to mark a clause deleted; its space is reclaimed by the next compaction
+void pool_delete_clause(ClausePool *pool, ClauseRef ref)
+{
+    PoolClause *clause = pool_clause(pool, ref);
+    if (clause->flags & POOL_DELETED)
+        return;
+    clause->flags |= POOL_DELETED;
+    pool->wasted += POOL_HEADER_WORDS + clause->num_literals;
+}
+
+// Function to check whether enough of a pool is deleted to be worth compacting
+bool pool_needs_compaction(ClausePool *pool)
+{
+    return pool->wasted > pool->size / 4;
+}
+
+// Function to plan a compaction: each live clause records in its forward field the
+// reference it will have afterwards, and deleted clauses get CLAUSE_REF_UNDEF
+// Until pool_compact runs, pool_forward translates old references to new ones
+void pool_plan_compaction(ClausePool *pool)
+{
+    ClauseRef next_free = 0;
+    for (ClauseRef ref = 0; ref < pool->size; ref = pool_next(pool, ref))
+    {
+        PoolClause *clause = pool_clause(pool, ref);
+        if (clause->flags & POOL_DELETED)
+        {
+            clause->forward = CLAUSE_REF_UNDEF;
+        }
+        else
+        {
+            clause->forward = next_free;
+            next_free += POOL_HEADER_WORDS + clause->num_literals;
+        }
+    }
+}
+
+// Function to slide live clauses down over deleted ones, in place and in order
+void pool_compact(ClausePool *pool)
+{
+    ClauseRef ref = 0;
+    ClauseRef end = pool->size;
+    uint32_t size = 0;
+    while (ref < end)
+    {
+        PoolClause *clause = pool_clause(pool, ref);
+        uint32_t words = POOL_HEADER_WORDS + clause->num_literals;
+        if (!(clause->flags & POOL_DELETED))
+        {
+            // Clauses only ever move towards the start, so memmove never overwrites
+            // a clause that has not been moved yet
+            if (clause->forward != ref)
+                memmove(pool->words + clause->forward, clause, words * sizeof(uint32_t));
+            pool_clause(pool, size)->forward = size;
+            size += words;
+        }
+        ref += words;
+    }
+    pool->size = size;
+    pool->wasted = 0;
+}
+
+// Function to make room for a number of ids in a list, so pushing that many cannot fail
+bool id_list_reserve(IdList *list, int needed)
+{
+    if (needed <= list->capacity)
+        return true;
+    int new_capacity = list->capacity ? list->capacity : 4;
+    while (new_capacity < needed)
+        new_capacity *= GROWTH_FACTOR;
+    int *new_ids = realloc(list->ids, new_capacity * sizeof(int));
+    if (!new_ids)
+        return false;
+    list->ids = new_ids;
+    list->capacity = new_capacity;
+    return true;
+}
+
+// Function to append a clause id to a list
+bool id_list_push(IdList *list, int id)
+{
+    if (list->size >= list->capacity && !id_list_reserve(list, list->size + 1))
+        return false;
+    list->ids[list->size++] = id;
+    return true;
+}
+
+// Function to initialize a clause store
+bool init_clause_store(ClauseStore *store)
+{
+    store->refs = malloc(INITIAL_CAPACITY * sizeof(ClauseRef));
+    store->hashes = malloc(INITIAL_CAPACITY * sizeof(uint32_t));
+    store->signatures = malloc(INITIAL_CAPACITY * sizeof(uint64_t));
+    store->flags = malloc(INITIAL_CAPACITY * sizeof(uint8_t));
+    store->index = malloc(INITIAL_INDEX_CAPACITY * sizeof(int));
+    if (!store->refs || !store->hashes || !store->signatures || !store->flags || !store->index)
+    {
+        free(store->refs);
+        free(store->hashes);
+        free(store->signatures);
+        free(store->flags);
+        free(store->index);
+        return false;
+    }
+    for (int i = 0; i < INITIAL_INDEX_CAPACITY; i++)
+    {
+        store->index[i] = -1;
+    }
+    store->num_clauses = 0;
+    store->num_live = 0;
+    store->capacity = INITIAL_CAPACITY;
+    store->index_capacity = INITIAL_INDEX_CAPACITY;
+    store->occurrences = NULL;
+    store->num_occurrence_lists = 0;
+    store->kernels = bitset_kernels(1);
+    store->bits = malloc(INITIAL_CAPACITY * 2 * store->kernels->words * sizeof(uint64_t));
+    if (!store->bits)
+        store->kernels = NULL;
+    store->num_duplicates = 0;
+    store->num_forward_subsumed = 0;
+    store->num_backward_subsumed = 0;
+    init_clause_pool(&store->pool);
+    return true;
+}
+
+// Function to free a clause store and all its clauses
+void free_clause_store(ClauseStore *store)
+{
+    free_clause_pool(&store->pool);
+    for (int i = 0; i < store->num_occurrence_lists; i++)
+    {
+        free(store->occurrences[i].ids);
+    }
+    free(store->refs);
+    free(store->hashes);
+    free(store->signatures);
+    free(store->flags);
+    free(store->index);
+    free(store->occurrences);
+    free(store->bits);
+    store->refs = NULL;
+    store->hashes = NULL;
+    store->signatures = NULL;
+    store->flags = NULL;
+    store->index = NULL;
+    store->occurrences = NULL;
+    store->kernels = NULL;
+    store->bits = NULL;
+    store->num_clauses = 0;
+    store->num_live = 0;
+    store->capacity = 0;
+    store->index_capacity = 0;
+    store->num_occurrence_lists = 0;
+}
+
+// Function to compute the literal signature of a clause
+// If c1 subsumes c2 then every bit of signature(c1) is also set in signature(c2)
+uint64_t clause_signature(Clause *clause)
+{
+    uint64_t signature = 0;
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        signature |= 1ull << ((clause->literals[i] * 2654435761u) >> 26);
+    }
+    return signature;
+}
+
+// Function to check if canonical clause c1 subsumes canonical clause c2 (c1 is a subset of c2)
+bool clause_subsumes(Clause *c1, Clause *c2)
+{
+    if (c1->num_literals > c2->num_literals)
+        return false;
+
+    int j = 0;
+    for (int i = 0; i < c1->num_literals; i++)
+    {
+        while (j < c2->num_literals && c2->literals[j] < c1->literals[i])
+            j++;
+        if (j >= c2->num_literals || c2->literals[j] != c1->literals[i])
+            return false;
+        j++;
+    }
+    return true;
+}
+
+// Function to find the id of a canonical clause in the store, or -1 if absent
+int clause_store_find(ClauseStore *store, Clause *clause, uint32_t hash)
+{
+    uint32_t mask = (uint32_t)(store->index_capacity - 1);
+    for (uint32_t slot = hash & mask; store->index[slot] != -1; slot = (slot + 1) & mask)
+    {
+        int id = store->index[slot];
+        if (store->hashes[id] != hash)
+            continue;
+        PoolClause *other = pool_clause(&store->pool, store->refs[id]);
+        if ((int)other->num_literals == clause->num_literals &&
+            memcmp(other->literals, clause->literals, clause->num_literals * sizeof(Literal)) == 0)
+        {
+            return id;
+        }
+    }
+    return -1;
+}
+
+// Function to rebuild the hash index of a clause store with a table of the given size
+// Deleted clauses are left out: each is subsumed by a live clause, which rejects it anyway
+static bool rebuild_clause_index(ClauseStore *store, int new_capacity)
+{
+    int *new_index = malloc(new_capacity * sizeof(int));
+    if (!new_index)
+        return false;
+    for (int i = 0; i < new_capacity; i++)
+    {
+        new_index[i] = -1;
+    }
+
+    uint32_t mask = (uint32_t)(new_capacity - 1);
+    for (int id = 0; id < store->num_clauses; id++)
+    {
+        if (store->flags[id] & CLAUSE_DELETED)
+            continue;
+        uint32_t slot = store->hashes[id] & mask;
+        while (new_index[slot] != -1)
+            slot = (slot + 1) & mask;
+        new_index[slot] = id;
+    }
+
+    free(store->index);
+    store->index = new_index;
+    store->index_capacity = new_capacity;
+    return true;
+}
+
+// Function to make sure the store has an occurrence list for every literal of a clause
+static bool reserve_occurrence_lists(ClauseStore *store, Clause *clause)
+{
+    int needed = 0;
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        if ((int)clause->literals[i] >= needed)
+            needed = (int)clause->literals[i] + 1;
+    }
+    if (needed <= store->num_occurrence_lists)
+        return true;
+
+    // Always cover both polarities of the largest variable
+    needed = (needed | 1) + 1;
+    if (needed < 2 * store->num_occurrence_lists)
+        needed = 2 * store->num_occurrence_lists;
+
+    IdList *new_lists = realloc(store->occurrences, needed * sizeof(IdList));
+    if (!new_lists)
+        return false;
+    for (int i = store->num_occurrence_lists; i < needed; i++)
+    {
+        new_lists[i].ids = NULL;
+        new_lists[i].size = 0;
+        new_lists[i].capacity = 0;
+    }
+    store->occurrences = new_lists;
+    store->num_occurrence_lists = needed;
+    return true;
+}
+
+// Function to get the masks of a clause of a store that keeps bitsets
+static inline uint64_t *clause_store_bits(ClauseStore *store, int id)
+{
+    return store->bits + (size_t)id * 2 * store->kernels->words;
+}
+
+// Function to stop keeping bitsets; the store works on literal lists alone from then on
+static void drop_bitsets(ClauseStore *store)
+{
+    free(store->bits);
+    store->bits = NULL;
+    store->kernels = NULL;
+}
+
+// Function to switch the bitsets of a store to kernels covering a number of variables,
+// rebuilding the masks of every clause, or to drop them past BITSET_MAX_VARIABLES
+// The bitsets only speed the store up, so running out of memory drops them too
+static void widen_bitsets(ClauseStore *store, int num_vars)
+{
+    const BitsetKernels *kernels = bitset_kernels(num_vars);
+    uint64_t *bits = kernels ? malloc((size_t)store->capacity * 2 * kernels->words * sizeof(uint64_t)) : NULL;
+    if (!bits)
+    {
+        drop_bitsets(store);
+        return;
+    }
+
+    for (int id = 0; id < store->num_clauses; id++)
+    {
+        uint64_t *clause_bits = bits + (size_t)id * 2 * kernels->words;
+        if (store->refs[id] == CLAUSE_REF_UNDEF)
+        {
+            // Compacted away: deleted clauses are never looked at again
+            memset(clause_bits, 0, 2 * kernels->words * sizeof(uint64_t));
+            continue;
+        }
+        Clause clause = clause_store_get(store, id);
+        bitset_from_literals(clause_bits, kernels->words, clause.literals, clause.num_literals);
+    }
+    free(store->bits);
+    store->bits = bits;
+    store->kernels = kernels;
+}
+
+// Function to insert a canonical clause known to be absent from the store
+static int clause_store_insert(ClauseStore *store, Clause *clause, uint32_t hash)
+{
+    if (store->num_clauses >= store->capacity)
+    {
+        int new_capacity = store->capacity * GROWTH_FACTOR;
+        ClauseRef *new_refs = realloc(store->refs, new_capacity * sizeof(ClauseRef));
+        if (!new_refs)
+            return CLAUSE_ERROR;
+        store->refs = new_refs;
+        uint32_t *new_hashes = realloc(store->hashes, new_capacity * sizeof(uint32_t));
+        if (!new_hashes)
+            return CLAUSE_ERROR;
+        store->hashes = new_hashes;
+        uint64_t *new_signatures = realloc(store->signatures, new_capacity * sizeof(uint64_t));
+        if (!new_signatures)
+            return CLAUSE_ERROR;
+        store->signatures = new_signatures;
+        uint8_t *new_flags = realloc(store->flags, new_capacity * sizeof(uint8_t));
+        if (!new_flags)
+            return CLAUSE_ERROR;
+        store->flags = new_flags;
+        if (store->kernels)
+        {
+            uint64_t *new_bits = realloc(store->bits, (size_t)new_capacity * 2 * store->kernels->words * sizeof(uint64_t));
+            if (new_bits)
+                store->bits = new_bits;
+            else
+                drop_bitsets(store);
+        }
+        store->capacity = new_capacity;
+    }
+    if (2 * (store->num_clauses + 1) > store->index_capacity &&
+        !rebuild_clause_index(store, store->index_capacity * GROWTH_FACTOR))
+        return CLAUSE_ERROR;
+    if (!reserve_occurrence_lists(store, clause))
+        return CLAUSE_ERROR;
+    ClauseRef ref = pool_add_clause(&store->pool, clause->literals, clause->num_literals, 0);
+    if (ref == CLAUSE_REF_UNDEF)
+        return CLAUSE_ERROR;
+
+    int id = store->num_clauses;
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        if (!id_list_push(&store->occurrences[clause->literals[i]], id))
+        {
+            // Undo the pushes already made so the lists never name a missing clause
+            for (int k = 0; k < i; k++)
+                store->occurrences[clause->literals[k]].size--;
+            pool_delete_clause(&store->pool, ref);
+            return CLAUSE_ERROR;
+        }
+    }
+
+    store->num_clauses++;
+    store->num_live++;
+    store->refs[id] = ref;
+    store->hashes[id] = hash;
+    store->signatures[id] = clause_signature(clause);
+    store->flags[id] = 0;
+    if (store->kernels)
+    {
+        // Canonical clauses end with their largest variable
+        int num_vars = clause->num_literals > 0 ? literal_var(clause->literals[clause->num_literals - 1]) + 1 : 0;
+        if (num_vars > 64 * store->kernels->words)
+            widen_bitsets(store, num_vars);
+        else
+            bitset_from_literals(clause_store_bits(store, id), store->kernels->words, clause->literals, clause->num_literals);
+    }
+
+    uint32_t mask = (uint32_t)(store->index_capacity - 1);
+    uint32_t slot = hash & mask;
+    while (store->index[slot] != -1)
+        slot = (slot + 1) & mask;
+    store->index[slot] = id;
+    return id;
+}
+
+// Function to add a canonical clause to the store
+// The store keeps its own copy in its pool, so the caller can reuse the clause buffer;
+// returns the new id, CLAUSE_DUPLICATE or CLAUSE_ERROR
+int clause_store_add(ClauseStore *store, Clause *clause)
+{
+    uint32_t hash = hash_clause(clause);
+    if (clause_store_find(store, clause, hash) != -1)
+    {
+        COUNTER_ADD(store->num_duplicates, 1);
+        return CLAUSE_DUPLICATE;
+    }
+    return clause_store_insert(store, clause, hash);
+}
+
+// Function to check if a live clause of the store subsumes the given clause
+bool clause_store_is_subsumed(ClauseStore *store, Clause *clause, uint64_t signature)
+{
+    uint64_t bits[2 * BITSET_MAX_WORDS];
+    if (store->kernels)
+        bitset_from_literals(bits, store->kernels->words, clause->literals, clause->num_literals);
+
+    // Any subsuming clause shares all its literals with the clause, so it sits in
+    // the occurrence list of each of them; the signature filters most candidates
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        Literal lit = clause->literals[i];
+        if ((int)lit >= store->num_occurrence_lists)
+            continue;
+
+        IdList *list = &store->occurrences[lit];
+        for (int k = 0; k < list->size; k++)
+        {
+            int id = list->ids[k];
+            if (store->flags[id] & CLAUSE_DELETED || (store->signatures[id] & ~signature) != 0)
+                continue;
+            if (store->kernels)
+            {
+                if (store->kernels->subsumes(clause_store_bits(store, id), bits))
+                    return true;
+                continue;
+            }
+            Clause other = clause_store_get(store, id);
+            if (clause_subsumes(&other, clause))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Function to delete a live clause; it stays in the hash index until the next compaction,
+// so it must be subsumed by a clause that stays live
+void clause_store_delete(ClauseStore *store, int id)
+{
+    store->flags[id] |= CLAUSE_DELETED;
+    pool_delete_clause(&store->pool, store->refs[id]);
+    store->num_live--;
+}
+
+// Function to delete every live clause subsumed by the clause with the given id
+int clause_store_remove_subsumed(ClauseStore *store, int id)
+{
+    Clause clause = clause_store_get(store, id);
+    uint64_t signature = store->signatures[id];
+    if (clause.num_literals == 0)
+        return 0;
+
+    // Subsumed clauses contain every literal of the clause; scan the shortest list
+    IdList *list = &store->occurrences[clause.literals[0]];
+    for (int i = 1; i < clause.num_literals; i++)
+    {
+        IdList *candidate = &store->occurrences[clause.literals[i]];
+        if (candidate->size < list->size)
+            list = candidate;
+    }
+
+    int removed = 0;
+    for (int k = 0; k < list->size; k++)
+    {
+        int other = list->ids[k];
+        if (other == id || store->flags[other] & CLAUSE_DELETED || (signature & ~store->signatures[other]) != 0)
+            continue;
+        bool subsumed;
+        if (store->kernels)
+        {
+            subsumed = store->kernels->subsumes(clause_store_bits(store, id), clause_store_bits(store, other));
+        }
+        else
+        {
+            Clause candidate = clause_store_get(store, other);
+            subsumed = clause_subsumes(&clause, &candidate);
+        }
+        if (subsumed)
+        {
+            clause_store_delete(store, other);
+            removed++;
+        }
+    }
+    COUNTER_ADD(store->num_backward_subsumed, removed);
+    return removed;
+}
+
+// Function to add a canonical clause unless it is already present or subsumed,
+// deleting any live clause the new one subsumes
+// Copying and return values follow clause_store_add, plus CLAUSE_SUBSUMED
+int clause_store_add_irredundant(ClauseStore *store, Clause *clause)
+{
+    uint32_t hash = hash_clause(clause);
+    if (clause_store_find(store, clause, hash) != -1)
+    {
+        COUNTER_ADD(store->num_duplicates, 1);
+        return CLAUSE_DUPLICATE;
+    }
+
+    if (clause_store_is_subsumed(store, clause, clause_signature(clause)))
+    {
+        COUNTER_ADD(store->num_forward_subsumed, 1);
+        return CLAUSE_SUBSUMED;
+    }
+
+    int id = clause_store_insert(store, clause, hash);
+    if (id >= 0)
+        clause_store_remove_subsumed(store, id);
+    return id;
+}
+
+// Function to resolve two clauses of the store on a literal (lit in id1, its negation in id2)
+// Same contract as resolve(), which it falls back to once the store has dropped its bitsets
+bool clause_store_resolve(ClauseStore *store, int id1, int id2, Literal lit, Clause *result)
+{
+    Clause c1 = clause_store_get(store, id1);
+    Clause c2 = clause_store_get(store, id2);
+    if (!store->kernels)
+        return resolve(&c1, &c2, lit, result);
+
+    uint64_t bits[2 * BITSET_MAX_WORDS];
+    result->num_literals = 0;
+    result->is_goal = false;
+    if (!store->kernels->resolve(clause_store_bits(store, id1), clause_store_bits(store, id2), literal_var(lit), bits))
+        return false;
+    if (!reserve_literals(result, c1.num_literals + c2.num_literals))
+    {
+        result->num_literals = -1;
+        return false;
+    }
+    result->num_literals = bitset_to_literals(bits, store->kernels->words, result->literals);
+    return true;
+}
+
+// Function to find the root of a variable in a union-find forest, halving the path to it
+static int find_root(int *parent, int var)
+{
+    while (parent[var] != var)
+    {
+        parent[var] = parent[parent[var]];
+        var = parent[var];
+    }
+    return var;
+}
+
+// Function to number the variable-disjoint components of the live clauses of a store
+// Clauses sharing a variable, directly or through other clauses, are in the same component;
+// they are found by union-find over the variables. Each live clause gets the number of its
+// component in component[id], from 0 in order of first clause, and deleted clauses get -1
+// Returns the number of components, or -1 if out of memory
+int clause_store_components(ClauseStore *store, int *component)
+{
+    int num_vars = (store->num_occurrence_lists + 1) / 2;
+    int *parent = malloc((num_vars > 0 ? num_vars : 1) * sizeof(int));
+    if (!parent)
+        return -1;
+    for (int v = 0; v < num_vars; v++)
+    {
+        parent[v] = v;
+    }
+
+    // Join the variables of each clause to its first one
+    for (int id = 0; id < store->num_clauses; id++)
+    {
+        if (store->flags[id] & CLAUSE_DELETED)
+            continue;
+        Clause clause = clause_store_get(store, id);
+        int root = find_root(parent, literal_var(clause.literals[0]));
+        for (int i = 1; i < clause.num_literals; i++)
+        {
+            int other = find_root(parent, literal_var(clause.literals[i]));
+            if (other == root)
+                continue;
+            // Link the larger root under the smaller one
+            if (other < root)
+            {
+                parent[root] = other;
+                root = other;
+            }
+            else
+            {
+                parent[other] = root;
+            }
+        }
+    }
+
+    // Number the components by their roots, in order of first clause
+    int *number = malloc((num_vars > 0 ? num_vars : 1) * sizeof(int));
+    if (!number)
+    {
+        free(parent);
+        return -1;
+    }
+    for (int v = 0; v < num_vars; v++)
+    {
+        number[v] = -1;
+    }
+    int num_components = 0;
+    for (int id = 0; id < store->num_clauses; id++)
+    {
+        component[id] = -1;
+        if (store->flags[id] & CLAUSE_DELETED)
+            continue;
+        int root = find_root(parent, literal_var(clause_store_get(store, id).literals[0]));
+        if (number[root] < 0)
+            number[root] = num_components++;
+        component[id] = number[root];
+    }
+    free(number);
+    free(parent);
+    return num_components;
+}
+
+// Function to reclaim the pool space and occurrence list entries of deleted clauses
+// Clause ids stay valid for live clauses; deleted ones lose their literals
+bool clause_store_compact(ClauseStore *store)
+{
+    if (!rebuild_clause_index(store, store->index_capacity))
+        return false;
+
+    for (int lit = 0; lit < store->num_occurrence_lists; lit++)
+    {
+        IdList *list = &store->occurrences[lit];
+        int kept = 0;
+        for (int k = 0; k < list->size; k++)
+        {
+            if (!(store->flags[list->ids[k]] & CLAUSE_DELETED))
+                list->ids[kept++] = list->ids[k];
+        }
+        list->size = kept;
+    }
+
+    pool_plan_compaction(&store->pool);
+    for (int id = 0; id < store->num_clauses; id++)
+    {
+        if (store->refs[id] != CLAUSE_REF_UNDEF)
+            store->refs[id] = pool_forward(&store->pool, store->refs[id]);
+    }
+    pool_compact(&store->pool);
+    return true;
+}
@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <dirent.h>
+#include "solver.h"
 
 #define MAX_LINE 1024
 #define COLOR_BLUE 9
@@ -12,6 +15,10 @@
 #define COLOR_PURPLE 13
 #define COLOR_RESET 7
 #define MAX_FILES 100
+#define CACHE_ENVIRONMENT "SOLVER_CACHE" // Path of the result cache, or empty for none
+
+static int cache_state = 0; // 0 before the first solve, 1 if the cache is in use, -1 if not
+static char cache_path[MAX_LINE];
 
 typedef struct
 {
@@ -20,13 +27,77 @@ typedef struct
 
 void clear_screen()
 {
+#ifdef _WIN32
     system("cls");
+#else
+    printf("\033[H\033[2J");
+#endif
 }
 
 void set_color(int color)
 {
+#ifdef _WIN32
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, color);
+#else
+    (void)color;
+#endif
+}
+
+// Function to find the result cache of the menu: the file named by SOLVER_CACHE, else one in
+// the local application data (Windows) or home directory of the user
+// Returns NULL if there is no place for it
+const char *cache_file_path()
+{
+    const char *path = getenv(CACHE_ENVIRONMENT);
+    if (path)
+        return *path ? path : NULL;
+#ifdef _WIN32
+    const char *directory = getenv("LOCALAPPDATA");
+    const char *name = "solver_results.cache";
+    char separator = '\\';
+#else
+    const char *directory = getenv("HOME");
+    const char *name = ".solver_results.cache";
+    char separator = '/';
+#endif
+    if (!directory || !*directory)
+        return NULL;
+    snprintf(cache_path, sizeof(cache_path), "%s%c%s", directory, separator, name);
+    return cache_path;
+}
+
+// Function to solve a formula file with the solver library and print the verdict
+void solve_formula_file(const char *filename)
+{
+    Solver *solver = solver_create();
+    if (!solver)
+    {
+        set_color(COLOR_RED);
+        printf("Error: Failed to create solver\n");
+        set_color(COLOR_RESET);
+        return;
+    }
+
+    // Formulas solved before, even with other variable names, are answered from the cache;
+    // if it cannot be opened (a read-only directory, say) formulas are simply solved again
+    if (cache_state == 0)
+        cache_state = cache_file_path() ? 1 : -1;
+    if (cache_state == 1 && !solver_set_cache(solver, cache_file_path()))
+    {
+        cache_state = -1;
+        printf("Continuing without the result cache\n");
+    }
+    if (solver_read_file(solver, filename, SOLVER_FORMAT_AUTO))
+    {
+        SolverResult result = solver_solve(solver);
+        SolverStats stats;
+        solver_get_stats(solver, &stats);
+        set_color(result == SOLVER_SATISFIABLE ? COLOR_GREEN : result == SOLVER_UNSATISFIABLE ? COLOR_BLUE : COLOR_RED);
+        printf("%s%s\n", solver_result_name(result), stats.cached ? " (cached)" : "");
+        set_color(COLOR_RESET);
+    }
+    solver_destroy(solver);
 }
 
 void print_credits()
@@ -153,9 +224,7 @@ void create_new_formula()
 
     if (choice == 'y' || choice == 'Y')
     {
-        char command[200];
-        sprintf(command, "solver_engine %s", full_filename);
-        system(command);
+        solve_formula_file(full_filename);
     }
 
     printf("\nPress Enter to continue...");
@@ -219,9 +288,7 @@ void test_existing_formula()
     }
     getchar();
 
-    char command[200];
-    sprintf(command, "solver_engine %s", files[choice - 1].filename);
-    system(command);
+    solve_formula_file(files[choice - 1].filename);
 
     printf("\nPress Enter to continue...");
     getchar();
@@ -301,9 +368,7 @@ void show_formulas()
                 }
                 getchar();
 
-                char command[200];
-                sprintf(command, "solver_engine %s", files[file_choice - 1].filename);
-                system(command);
+                solve_formula_file(files[file_choice - 1].filename);
 
                 printf("\nPress Enter to continue...");
                 getchar();
@@ -327,7 +392,9 @@ void show_formulas()
 
 int main()
 {
+#ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
+#endif
     char choice;
 
     while (1)
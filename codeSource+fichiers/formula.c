@@ -0,0 +1,615 @@
+/*
+ * Literals, clauses, arenas and formulas
+ */
+
+#include "solver_internal.h"
+
+// Function to initialize an empty arena
+void init_arena(Arena *arena)
+{
+    arena->blocks = NULL;
+    arena->bytes_used = 0;
+}
+
+// Function to release every block of an arena
+void free_arena(Arena *arena)
+{
+    ArenaBlock *block = arena->blocks;
+    while (block)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    init_arena(arena);
+}
+
+// Function to allocate memory that lives until the arena is freed
+void *arena_alloc(Arena *arena, size_t bytes)
+{
+    bytes = (bytes + 7) & ~(size_t)7; // Keep every allocation 8-byte aligned
+    ArenaBlock *head = arena->blocks;
+    if (head && head->size - head->used >= bytes)
+    {
+        void *memory = (char *)(head + 1) + head->used;
+        head->used += bytes;
+        arena->bytes_used += bytes;
+        return memory;
+    }
+
+    // Blocks grow with the arena so large formulas need few of them
+    size_t size = head ? head->size * GROWTH_FACTOR : ARENA_BLOCK_SIZE;
+    if (size > ARENA_MAX_BLOCK_SIZE)
+        size = ARENA_MAX_BLOCK_SIZE;
+    bool dedicated = bytes > size / 4;
+    if (dedicated)
+        size = bytes;
+
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+    if (!block)
+        return NULL;
+    block->used = bytes;
+    block->size = size;
+    if (dedicated && head)
+    {
+        // A huge request gets its own block behind the head, which keeps serving small ones
+        block->next = head->next;
+        head->next = block;
+    }
+    else
+    {
+        block->next = head;
+        arena->blocks = block;
+    }
+    arena->bytes_used += bytes;
+    return block + 1;
+}
+
+// Function to copy a clause into an arena with exactly as many literals as it has
+bool arena_copy_clause(Arena *arena, Clause *dest, Clause *src)
+{
+    Literal *literals = arena_alloc(arena, src->num_literals * sizeof(Literal));
+    if (!literals)
+        return false;
+    if (src->num_literals > 0) // The empty clause may have no literal array at all
+        memcpy(literals, src->literals, src->num_literals * sizeof(Literal));
+    dest->literals = literals;
+    dest->num_literals = src->num_literals;
+    dest->capacity = 0;
+    dest->is_goal = src->is_goal;
+    return true;
+}
+
+// Function to initialize a variable
+void init_variable(Variable *var)
+{
+    var->name[0] = '\0';
+}
+
+// Function to compare variables
+bool variables_equal(Variable *v1, Variable *v2)
+{
+    return strcmp(v1->name, v2->name) == 0;
+}
+
+// Function to hash a variable name (FNV-1a)
+static uint32_t hash_name(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++)
+    {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Function to initialize a clause
+bool init_clause(Clause *clause)
+{
+    clause->literals = malloc(INITIAL_CLAUSE_CAPACITY * sizeof(Literal));
+    if (!clause->literals)
+        return false;
+    clause->num_literals = 0;
+    clause->capacity = INITIAL_CLAUSE_CAPACITY;
+    clause->is_goal = false;
+    return true;
+}
+
+// Function to free a clause (arena literals are released with their arena)
+void free_clause(Clause *clause)
+{
+    if (clause->capacity > 0)
+        free(clause->literals);
+    clause->literals = NULL;
+    clause->num_literals = 0;
+    clause->capacity = 0;
+}
+
+// Function to initialize a formula
+bool init_formula(Formula *formula)
+{
+    formula->clauses = malloc(INITIAL_CAPACITY * sizeof(Clause));
+    formula->variables = malloc(INITIAL_CAPACITY * sizeof(Variable));
+    formula->var_index = malloc(INITIAL_INDEX_CAPACITY * sizeof(int));
+    if (!formula->clauses || !formula->variables || !formula->var_index)
+    {
+        free(formula->clauses);
+        free(formula->variables);
+        free(formula->var_index);
+        return false;
+    }
+    for (int i = 0; i < INITIAL_INDEX_CAPACITY; i++)
+    {
+        formula->var_index[i] = -1;
+    }
+    formula->num_clauses = 0;
+    formula->capacity = INITIAL_CAPACITY;
+    formula->num_variables = 0;
+    formula->var_capacity = INITIAL_CAPACITY;
+    formula->var_index_capacity = INITIAL_INDEX_CAPACITY;
+    init_arena(&formula->arena);
+    return true;
+}
+
+// Function to free a formula
+void free_formula(Formula *formula)
+{
+    free_arena(&formula->arena);
+    free(formula->clauses);
+    free(formula->variables);
+    free(formula->var_index);
+    formula->clauses = NULL;
+    formula->variables = NULL;
+    formula->var_index = NULL;
+    formula->num_clauses = 0;
+    formula->capacity = 0;
+    formula->num_variables = 0;
+    formula->var_capacity = 0;
+    formula->var_index_capacity = 0;
+}
+
+// Function to rebuild the variable index with a larger table
+static bool grow_variable_index(Formula *formula)
+{
+    int new_capacity = formula->var_index_capacity * GROWTH_FACTOR;
+    int *new_index = malloc(new_capacity * sizeof(int));
+    if (!new_index)
+        return false;
+    for (int i = 0; i < new_capacity; i++)
+    {
+        new_index[i] = -1;
+    }
+
+    for (int id = 0; id < formula->num_variables; id++)
+    {
+        uint32_t slot = hash_name(formula->variables[id].name) & (uint32_t)(new_capacity - 1);
+        while (new_index[slot] != -1)
+            slot = (slot + 1) & (uint32_t)(new_capacity - 1);
+        new_index[slot] = id;
+    }
+
+    free(formula->var_index);
+    formula->var_index = new_index;
+    formula->var_index_capacity = new_capacity;
+    return true;
+}
+
+// Function to look a (truncated) name up in the variable index
+// Returns the variable id, or -1 with slot set to the empty slot where it would go
+static int lookup_variable(const Formula *formula, const char *key, uint32_t *slot)
+{
+    uint32_t mask = (uint32_t)(formula->var_index_capacity - 1);
+    *slot = hash_name(key) & mask;
+    while (formula->var_index[*slot] != -1)
+    {
+        int id = formula->var_index[*slot];
+        if (strcmp(formula->variables[id].name, key) == 0)
+        {
+            return id;
+        }
+        *slot = (*slot + 1) & mask;
+    }
+    return -1;
+}
+
+// Function to find a variable of the formula by name, or -1 if it has none
+int find_variable(const Formula *formula, const char *name)
+{
+    char key[MAX_VAR_NAME];
+    strncpy(key, name, MAX_VAR_NAME - 1);
+    key[MAX_VAR_NAME - 1] = '\0';
+    uint32_t slot;
+    return lookup_variable(formula, key, &slot);
+}
+
+// Function to find or add a variable to the formula
+int find_or_add_variable(Formula *formula, const char *name)
+{
+    // Names are truncated on insertion, so look them up truncated as well
+    char key[MAX_VAR_NAME];
+    strncpy(key, name, MAX_VAR_NAME - 1);
+    key[MAX_VAR_NAME - 1] = '\0';
+
+    // First try to find the variable
+    uint32_t slot;
+    int found = lookup_variable(formula, key, &slot);
+    if (found >= 0)
+        return found;
+
+    // If not found, add it
+    if (formula->num_variables >= formula->var_capacity)
+    {
+        int new_capacity = formula->var_capacity * GROWTH_FACTOR;
+        Variable *new_vars = realloc(formula->variables, new_capacity * sizeof(Variable));
+        if (!new_vars)
+            return -1;
+        formula->variables = new_vars;
+        formula->var_capacity = new_capacity;
+    }
+
+    int id = formula->num_variables;
+    strcpy(formula->variables[id].name, key);
+    formula->num_variables++;
+
+    if (2 * formula->num_variables > formula->var_index_capacity)
+    {
+        // Rehashing re-inserts every variable, including the new one
+        if (!grow_variable_index(formula))
+        {
+            formula->num_variables--;
+            return -1;
+        }
+    }
+    else
+    {
+        formula->var_index[slot] = id;
+    }
+    return id;
+}
+
+// Function to make room for a number of literals in a clause
+bool reserve_literals(Clause *clause, int needed)
+{
+    if (needed <= clause->capacity)
+        return true;
+
+    int new_capacity = clause->capacity > 0 ? clause->capacity : INITIAL_CLAUSE_CAPACITY;
+    while (new_capacity < needed)
+        new_capacity *= GROWTH_FACTOR;
+
+    Literal *new_literals;
+    if (clause->capacity > 0)
+    {
+        new_literals = realloc(clause->literals, new_capacity * sizeof(Literal));
+    }
+    else
+    {
+        // Arena literals cannot grow in place: move them to the heap
+        new_literals = malloc(new_capacity * sizeof(Literal));
+        if (new_literals && clause->num_literals > 0)
+            memcpy(new_literals, clause->literals, clause->num_literals * sizeof(Literal));
+    }
+    if (!new_literals)
+        return false;
+    clause->literals = new_literals;
+    clause->capacity = new_capacity;
+    return true;
+}
+
+// Function to add a literal to a clause
+bool add_literal(Clause *clause, Literal lit)
+{
+    if (clause->num_literals >= clause->capacity && !reserve_literals(clause, clause->num_literals + 1))
+        return false;
+
+    clause->literals[clause->num_literals++] = lit;
+    return true;
+}
+
+// Function to check if a clause contains a literal
+bool clause_contains(Clause *clause, Literal lit)
+{
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        if (clause->literals[i] == lit)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to check if a clause is a tautology (contains both p and ¬p)
+bool is_tautology(Clause *clause)
+{
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        // Check if the opposite polarity exists in the clause
+        if (clause_contains(clause, negate_literal(clause->literals[i])))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to check if a clause is empty (contradiction)
+bool is_empty_clause(Clause *clause)
+{
+    return clause->num_literals == 0;
+}
+
+// Function to put a clause in canonical form: literals sorted by code, repeats removed
+// Returns false if the clause is a tautology (x and !x end up adjacent once sorted)
+bool canonicalize_clause(Clause *clause)
+{
+    Literal *lits = clause->literals;
+    int n = clause->num_literals;
+
+    // Clauses are short in practice, so insertion sort beats qsort here
+    for (int i = 1; i < n; i++)
+    {
+        Literal lit = lits[i];
+        int j = i - 1;
+        while (j >= 0 && lits[j] > lit)
+        {
+            lits[j + 1] = lits[j];
+            j--;
+        }
+        lits[j + 1] = lit;
+    }
+
+    int size = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (size > 0 && lits[size - 1] == lits[i])
+            continue;
+        if (size > 0 && lits[size - 1] == negate_literal(lits[i]))
+            return false;
+        lits[size++] = lits[i];
+    }
+    clause->num_literals = size;
+    return true;
+}
+
+// Function to hash a canonical clause
+uint32_t hash_clause(Clause *clause)
+{
+    uint32_t hash = 2166136261u ^ (uint32_t)clause->num_literals;
+    for (int i = 0; i < clause->num_literals; i++)
+    {
+        hash ^= clause->literals[i];
+        hash *= 16777619u;
+        hash ^= hash >> 15;
+    }
+    return hash;
+}
+
+// Function to check if two clauses are identical
+bool clauses_equal(Clause *c1, Clause *c2)
+{
+    if (c1->num_literals != c2->num_literals)
+    {
+        return false;
+    }
+
+    // Check if every literal in c1 is in c2
+    for (int i = 0; i < c1->num_literals; i++)
+    {
+        if (!clause_contains(c2, c1->literals[i]))
+        {
+            return false;
+        }
+    }
+
+    // Check if every literal in c2 is in c1
+    for (int i = 0; i < c2->num_literals; i++)
+    {
+        if (!clause_contains(c1, c2->literals[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Function to check if a formula already contains a clause
+bool formula_contains(Formula *formula, Clause *clause)
+{
+    for (int i = 0; i < formula->num_clauses; i++)
+    {
+        if (clauses_equal(&formula->clauses[i], clause))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to resolve two canonical clauses on a literal (lit in c1, its negation in c2)
+// Both clauses are sorted, so the resolvent is built canonical by merging them into result,
+// an initialized clause whose buffer is reused from one call to the next
+// Returns false for a tautology or on memory error (result->num_literals is -1 then)
+bool resolve(Clause *c1, Clause *c2, Literal lit, Clause *result)
+{
+    result->num_literals = 0;
+    result->is_goal = false;
+    if (!reserve_literals(result, c1->num_literals + c2->num_literals))
+    {
+        result->num_literals = -1;
+        return false;
+    }
+
+    Literal complement = negate_literal(lit);
+    Literal *out = result->literals;
+    int size = 0;
+    int i = 0, j = 0;
+    while (i < c1->num_literals || j < c2->num_literals)
+    {
+        Literal next;
+        if (j >= c2->num_literals || (i < c1->num_literals && c1->literals[i] <= c2->literals[j]))
+            next = c1->literals[i++];
+        else
+            next = c2->literals[j++];
+
+        // Drop the resolved literal and its complement
+        if (next == lit || next == complement)
+            continue;
+
+        if (size > 0)
+        {
+            Literal last = out[size - 1];
+            if (last == next)
+                continue;
+            if (last == negate_literal(next))
+                return false; // Don't use tautologies
+        }
+        out[size++] = next;
+    }
+
+    result->num_literals = size;
+    return true;
+}
+
+// Function to check if a string is a valid variable name
+bool is_valid_variable_name(const char *name)
+{
+    if (!name || !*name)
+        return false;
+
+    // First character must be a letter or underscore
+    if (!isalpha(name[0]) && name[0] != '_')
+        return false;
+
+    // Rest can be letters, numbers, or underscores
+    for (int i = 1; name[i]; i++)
+    {
+        if (!isalnum(name[i]) && name[i] != '_')
+            return false;
+    }
+
+    return true;
+}
+
+// Function to copy a clause into a new, exactly sized heap array
+bool copy_clause(Clause *dest, Clause *src)
+{
+    int capacity = src->num_literals > 0 ? src->num_literals : 1;
+    dest->literals = malloc(capacity * sizeof(Literal));
+    if (!dest->literals)
+        return false;
+    memcpy(dest->literals, src->literals, src->num_literals * sizeof(Literal));
+    dest->num_literals = src->num_literals;
+    dest->capacity = capacity;
+    dest->is_goal = src->is_goal;
+    return true;
+}
+
+// Function to overwrite an initialized clause with the contents of another, reusing its buffer
+bool assign_clause(Clause *dest, Clause *src)
+{
+    if (!reserve_literals(dest, src->num_literals))
+        return false;
+    memcpy(dest->literals, src->literals, src->num_literals * sizeof(Literal));
+    dest->num_literals = src->num_literals;
+    dest->is_goal = src->is_goal;
+    return true;
+}
+
+// Function to add a clause to a formula
+bool add_clause(Formula *formula, Clause *clause)
+{
+    if (formula->num_clauses >= formula->capacity)
+    {
+        int new_capacity = formula->capacity * GROWTH_FACTOR;
+        Clause *new_clauses = realloc(formula->clauses, new_capacity * sizeof(Clause));
+        if (!new_clauses)
+            return false;
+        formula->clauses = new_clauses;
+        formula->capacity = new_capacity;
+    }
+
+    // Make a proper copy of the clause
+    if (!arena_copy_clause(&formula->arena, &formula->clauses[formula->num_clauses], clause))
+    {
+        return false;
+    }
+    formula->num_clauses++;
+    return true;
+}
+
+// Function to append the clauses of a formula to another one, matching variables by name
+bool append_formula(Formula *dest, Formula *src)
+{
+    int *var_map = malloc((src->num_variables > 0 ? src->num_variables : 1) * sizeof(int));
+    if (!var_map)
+        return false;
+
+    // Variables keep their order, so a copy into an empty formula keeps the same ids
+    for (int i = 0; i < src->num_variables; i++)
+    {
+        var_map[i] = find_or_add_variable(dest, src->variables[i].name);
+        if (var_map[i] < 0)
+        {
+            free(var_map);
+            return false;
+        }
+    }
+
+    Clause translated;
+    if (!init_clause(&translated))
+    {
+        free(var_map);
+        return false;
+    }
+    bool ok = true;
+    for (int i = 0; i < src->num_clauses && ok; i++)
+    {
+        Clause *clause = &src->clauses[i];
+        translated.num_literals = 0;
+        translated.is_goal = clause->is_goal;
+        for (int j = 0; j < clause->num_literals && ok; j++)
+        {
+            Literal lit = clause->literals[j];
+            ok = add_literal(&translated, make_literal(var_map[literal_var(lit)], literal_is_negated(lit)));
+        }
+        ok = ok && add_clause(dest, &translated);
+    }
+    free_clause(&translated);
+    free(var_map);
+    return ok;
+}
+
+// Function to make an independent copy of a formula
+bool copy_formula(Formula *dest, Formula *src)
+{
+    if (!init_formula(dest))
+        return false;
+    if (!append_formula(dest, src))
+    {
+        free_formula(dest);
+        return false;
+    }
+    return true;
+}
+
+// Function to check that an assignment satisfies every clause of a formula
+// model holds the VALUE_* of each variable; an unassigned variable satisfies nothing
+bool formula_satisfied_by(Formula *formula, const int8_t *model)
+{
+    for (int i = 0; i < formula->num_clauses; i++)
+    {
+        Clause *clause = &formula->clauses[i];
+        bool satisfied = false;
+        for (int k = 0; k < clause->num_literals && !satisfied; k++)
+        {
+            Literal lit = clause->literals[k];
+            satisfied = model[literal_var(lit)] == (literal_is_negated(lit) ? VALUE_FALSE : VALUE_TRUE);
+        }
+        if (!satisfied)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,345 @@
+/*
+ * Portable threads, locks, condition variables, wall-clock time and memory-mapped files
+ */
+
+#include "solver_internal.h"
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Function to start a thread running function(arg)
+bool thread_start(Thread *thread, ThreadFunction function, void *arg)
+{
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, function, arg, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, function, arg) == 0;
+#endif
+}
+
+// Function to wait for a thread to finish
+void thread_join(Thread thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// Function to initialize a mutex
+void mutex_init(Mutex *mutex)
+{
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+// Function to destroy a mutex
+void mutex_destroy(Mutex *mutex)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+// Function to lock a mutex
+void mutex_lock(Mutex *mutex)
+{
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+// Function to unlock a mutex
+void mutex_unlock(Mutex *mutex)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+// Function to initialize a condition variable
+void condition_init(Condition *condition)
+{
+#ifdef _WIN32
+    InitializeConditionVariable(condition);
+#else
+    pthread_cond_init(condition, NULL);
+#endif
+}
+
+// Function to destroy a condition variable
+void condition_destroy(Condition *condition)
+{
+#ifdef _WIN32
+    (void)condition; // Windows condition variables need no cleanup
+#else
+    pthread_cond_destroy(condition);
+#endif
+}
+
+// Function to release a locked mutex, wait for a signal and lock the mutex again
+void condition_wait(Condition *condition, Mutex *mutex)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(condition, mutex, INFINITE);
+#else
+    pthread_cond_wait(condition, mutex);
+#endif
+}
+
+// Function to wake every thread waiting on a condition variable
+void condition_broadcast(Condition *condition)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(condition);
+#else
+    pthread_cond_broadcast(condition);
+#endif
+}
+
+// Function to count the processors available to this process
+int cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+// Function to read a monotonic clock in seconds
+double now_seconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+// Function to get the CPU time used so far by all the threads of the process, in seconds
+double cpu_seconds(void)
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (double)(k.QuadPart + u.QuadPart) * 1e-7; // 100-nanosecond units
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return (double)now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+// Function to map a file into memory
+bool map_file(const char *filename, MappedFile *mapped)
+{
+    mapped->data = "";
+    mapped->size = 0;
+#ifdef _WIN32
+    mapped->mapping = NULL;
+    mapped->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (mapped->file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mapped->file, &size))
+    {
+        CloseHandle(mapped->file);
+        return false;
+    }
+    if (size.QuadPart == 0)
+        return true; // Empty files cannot be mapped
+
+    mapped->mapping = CreateFileMappingA(mapped->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const char *data = mapped->mapping ? MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!data)
+    {
+        if (mapped->mapping)
+            CloseHandle(mapped->mapping);
+        CloseHandle(mapped->file);
+        return false;
+    }
+    mapped->data = data;
+    mapped->size = (size_t)size.QuadPart;
+#else
+    mapped->fd = open(filename, O_RDONLY);
+    if (mapped->fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(mapped->fd, &info) != 0)
+    {
+        close(mapped->fd);
+        return false;
+    }
+    if (info.st_size == 0)
+        return true; // Empty files cannot be mapped
+
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, mapped->fd, 0);
+    if (data == MAP_FAILED)
+    {
+        close(mapped->fd);
+        return false;
+    }
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+    mapped->data = data;
+    mapped->size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+// Function to release a mapped file
+void unmap_file(MappedFile *mapped)
+{
+#ifdef _WIN32
+    if (mapped->size > 0)
+    {
+        UnmapViewOfFile(mapped->data);
+        CloseHandle(mapped->mapping);
+    }
+    CloseHandle(mapped->file);
+#else
+    if (mapped->size > 0)
+        munmap((void *)mapped->data, mapped->size);
+    close(mapped->fd);
+#endif
+    mapped->data = "";
+    mapped->size = 0;
+}
+
+// Function to open a file for reading and writing, creating it if needed, and map it whole
+// An empty file is first extended with zeros to new_size bytes, under the exclusive lock so
+// that no other process maps it half grown. Returns false if it cannot be opened or mapped
+bool open_shared_file(const char *filename, size_t new_size, SharedFile *shared)
+{
+    shared->data = NULL;
+    shared->size = 0;
+#ifdef _WIN32
+    shared->mapping = NULL;
+    shared->file = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                               OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (shared->file == INVALID_HANDLE_VALUE)
+        return false;
+
+    lock_shared_file(shared, true);
+    LARGE_INTEGER size;
+    bool ok = GetFileSizeEx(shared->file, &size);
+    if (ok && size.QuadPart == 0)
+    {
+        size.QuadPart = (LONGLONG)new_size;
+        ok = SetFilePointerEx(shared->file, size, NULL, FILE_BEGIN) && SetEndOfFile(shared->file);
+    }
+    unlock_shared_file(shared);
+    if (ok && size.QuadPart > 0)
+    {
+        shared->mapping = CreateFileMappingA(shared->file, NULL, PAGE_READWRITE, 0, 0, NULL);
+        shared->data = shared->mapping ? MapViewOfFile(shared->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0) : NULL;
+    }
+    if (!shared->data)
+    {
+        if (shared->mapping)
+            CloseHandle(shared->mapping);
+        CloseHandle(shared->file);
+        return false;
+    }
+    shared->size = (size_t)size.QuadPart;
+#else
+    shared->fd = open(filename, O_RDWR | O_CREAT, 0644);
+    if (shared->fd < 0)
+        return false;
+
+    lock_shared_file(shared, true);
+    struct stat info;
+    bool ok = fstat(shared->fd, &info) == 0;
+    if (ok && info.st_size == 0)
+    {
+        ok = ftruncate(shared->fd, (off_t)new_size) == 0;
+        info.st_size = (off_t)new_size;
+    }
+    unlock_shared_file(shared);
+    void *data = ok && info.st_size > 0
+                     ? mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shared->fd, 0)
+                     : MAP_FAILED;
+    if (data == MAP_FAILED)
+    {
+        close(shared->fd);
+        return false;
+    }
+    shared->data = data;
+    shared->size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+// Function to unmap and close a shared file; what was written to it stays in the file
+void close_shared_file(SharedFile *shared)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(shared->data);
+    CloseHandle(shared->mapping);
+    CloseHandle(shared->file);
+#else
+    munmap(shared->data, shared->size);
+    close(shared->fd);
+#endif
+    shared->data = NULL;
+    shared->size = 0;
+}
+
+// Function to wait for the lock of a shared file, shared with other readers or exclusive
+// Each opening of the file holds its own lock, even within one process
+void lock_shared_file(SharedFile *shared, bool exclusive)
+{
+#ifdef _WIN32
+    OVERLAPPED whole = {0};
+    LockFileEx(shared->file, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, MAXDWORD, MAXDWORD, &whole);
+#else
+    while (flock(shared->fd, exclusive ? LOCK_EX : LOCK_SH) != 0 && errno == EINTR)
+        ;
+#endif
+}
+
+// Function to release the lock of a shared file
+void unlock_shared_file(SharedFile *shared)
+{
+#ifdef _WIN32
+    OVERLAPPED whole = {0};
+    UnlockFileEx(shared->file, 0, MAXDWORD, MAXDWORD, &whole);
+#else
+    flock(shared->fd, LOCK_UN);
+#endif
+}
@@ -0,0 +1,272 @@
+/*
+ * Portfolio solving: differently configured engines race on the same formula, each on its
+ * own thread; the first definitive answer wins and the other engines are cancelled
+ */
+
+#include "solver_internal.h"
+
+#define MAX_STRATEGIES 4
+
+// Structure to describe one configuration of the portfolio
+typedef struct
+{
+    const char *name;
+    bool use_cdcl;
+    bool initial_phase;  // CDCL: polarity (is_negated) of first decisions
+    int restart_base;    // CDCL: conflicts per unit of the Luby restart sequence
+    bool set_of_support; // Resolution: only raced when the formula has goal clauses
+} PortfolioStrategy;
+
+// Strategies in order of preference; the first one runs on the calling thread
+static const PortfolioStrategy portfolio_strategies[MAX_STRATEGIES] = {
+    {"cdcl", true, true, 100, false},
+    {"cdcl-positive", true, false, 512, false},
+    {"resolution", false, false, 0, false},
+    {"resolution-sos", false, false, 0, true},
+};
+
+typedef struct Portfolio Portfolio;
+
+// Structure to represent a strategy running in a portfolio, with what it found
+typedef struct
+{
+    Portfolio *portfolio;
+    const PortfolioStrategy *strategy;
+    Thread thread;
+    bool started;
+    StopReason stopped; // Why the strategy gave up, if it did
+
+    CdclStats cdcl;
+    UnitPropagationResult units;
+    ResolutionStats resolution;
+    int8_t *model; // Satisfiable answer: VALUE_* of each variable, when it could be built
+} PortfolioLane;
+
+// Structure to represent the state shared by the strategies of a portfolio
+struct Portfolio
+{
+    Formula *formula; // Only read by the strategies
+    const Literal *assumptions;
+    int num_assumptions;
+    ResolutionOptions *options;
+    const Budget *budget; // Applies to each strategy
+
+    CancelFlag cancel; // Raised by the first strategy that answers
+    Mutex lock;        // Guards winner and result
+    PortfolioLane *winner;
+    SearchResult result;
+
+    PortfolioLane lanes[MAX_STRATEGIES];
+    int num_lanes;
+};
+
+// Function to report the outcome of a strategy; only the first definitive answer is kept
+// Set of support can only refute, so anything but unsatisfiable from it is no answer
+static void lane_answer(PortfolioLane *lane, SearchResult result, StopReason stopped)
+{
+    Portfolio *portfolio = lane->portfolio;
+    if (lane->strategy->set_of_support && result == SEARCH_SATISFIABLE)
+    {
+        result = SEARCH_UNKNOWN;
+        stopped = STOP_SUPPORT;
+    }
+    lane->stopped = stopped;
+    if (result == SEARCH_UNKNOWN)
+        return;
+
+    mutex_lock(&portfolio->lock);
+    if (!portfolio->winner)
+    {
+        portfolio->winner = lane;
+        portfolio->result = result;
+        cancel_flag_raise(&portfolio->cancel);
+    }
+    mutex_unlock(&portfolio->lock);
+}
+
+// Function to run a CDCL strategy on the shared formula
+static void run_cdcl_lane(PortfolioLane *lane)
+{
+    Portfolio *portfolio = lane->portfolio;
+    CdclSolver solver;
+    lane->stopped = STOP_MEMORY;
+    if (!init_cdcl_solver(&solver, 0))
+        return;
+    solver.initial_phase = lane->strategy->initial_phase;
+    solver.restart_base = lane->strategy->restart_base;
+    solver.budget = *portfolio->budget;
+    solver.cancel = &portfolio->cancel;
+
+    if (cdcl_load_formula(&solver, portfolio->formula, 0))
+    {
+        SearchResult result = cdcl_search(&solver, portfolio->assumptions, portfolio->num_assumptions);
+        lane->cdcl = solver.stats;
+        if (result == SEARCH_SATISFIABLE)
+        {
+            lane->model = malloc((portfolio->formula->num_variables + 1) * sizeof(int8_t));
+            if (lane->model)
+                cdcl_copy_model(&solver, lane->model, portfolio->formula->num_variables);
+        }
+        lane_answer(lane, result, solver.stopped);
+    }
+    free_cdcl_solver(&solver);
+}
+
+// Function to build the model of a resolution strategy that found its formula satisfiable
+// The values fixed by unit propagation, assumptions included, come first
+static void build_resolution_model(PortfolioLane *lane, ResolutionState *state, int num_vars)
+{
+    lane->model = calloc(num_vars + 1, sizeof(int8_t));
+    if (!lane->model)
+        return;
+    for (int i = 0; i < lane->units.num_assignments; i++)
+    {
+        Literal lit = lane->units.assignments[i];
+        lane->model[literal_var(lit)] = literal_is_negated(lit) ? VALUE_FALSE : VALUE_TRUE;
+    }
+    if (!resolution_build_model(state, lane->model, num_vars))
+    {
+        free(lane->model);
+        lane->model = NULL;
+    }
+}
+
+// Function to run a resolution strategy on a copy of the shared formula
+// Unit propagation simplifies its formula in place, and assumptions become unit clauses
+static void run_resolution_lane(PortfolioLane *lane)
+{
+    Portfolio *portfolio = lane->portfolio;
+    Formula work;
+    lane->stopped = STOP_MEMORY;
+    if (!copy_formula(&work, portfolio->formula))
+        return;
+
+    Clause unit;
+    if (!init_clause(&unit))
+    {
+        free_formula(&work);
+        return;
+    }
+    bool ok = true;
+    for (int i = 0; i < portfolio->num_assumptions && ok; i++)
+    {
+        unit.num_literals = 0;
+        ok = add_literal(&unit, portfolio->assumptions[i]) && add_clause(&work, &unit);
+    }
+    free_clause(&unit);
+    ok = ok && unit_propagation(&work, &lane->units);
+
+    ResolutionState state;
+    if (ok && init_resolution_state(&state, lane->strategy->set_of_support, portfolio->options->selection))
+    {
+        state.budget = *portfolio->budget;
+        state.cancel = &portfolio->cancel;
+        state.found_empty = lane->units.conflict;
+        for (int i = 0; i < work.num_clauses && ok && !state.found_empty; i++)
+            ok = resolution_add_clause(&state, &work.clauses[i]);
+
+        if (ok)
+        {
+            SearchResult result = resolution_saturate(&state, portfolio->options->threads, &lane->resolution);
+            if (result == SEARCH_SATISFIABLE)
+                build_resolution_model(lane, &state, work.num_variables);
+            lane_answer(lane, result, state.stopped);
+        }
+        free_resolution_state(&state);
+    }
+    free_formula(&work);
+}
+
+// Function run by the thread of each strategy
+static THREAD_FUNCTION portfolio_worker(void *arg)
+{
+    PortfolioLane *lane = arg;
+    if (lane->strategy->use_cdcl)
+        run_cdcl_lane(lane);
+    else
+        run_resolution_lane(lane);
+    return THREAD_RESULT;
+}
+
+// Function to free what a portfolio result owns
+void free_portfolio_result(PortfolioResult *result)
+{
+    free_unit_propagation_result(&result->units);
+    free(result->model);
+}
+
+// Function to decide a formula under assumptions by racing every strategy of the portfolio
+// The formula is shared by all strategies and must not change until the call returns. Set
+// of support resolution only joins the race on formulas with goal clauses and no assumptions.
+// The budget applies to each strategy; SEARCH_UNKNOWN means none of them could answer
+SearchResult portfolio_solve(Formula *formula, const Literal *assumptions, int num_assumptions,
+                             ResolutionOptions *options, const Budget *budget, PortfolioResult *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    bool has_goal = false;
+    for (int i = 0; i < formula->num_clauses && !has_goal; i++)
+        has_goal = formula->clauses[i].is_goal;
+
+    Portfolio portfolio;
+    memset(&portfolio, 0, sizeof(portfolio));
+    portfolio.formula = formula;
+    portfolio.assumptions = assumptions;
+    portfolio.num_assumptions = num_assumptions;
+    portfolio.options = options;
+    portfolio.budget = budget;
+    portfolio.result = SEARCH_UNKNOWN;
+    mutex_init(&portfolio.lock);
+
+    for (int s = 0; s < MAX_STRATEGIES; s++)
+    {
+        const PortfolioStrategy *strategy = &portfolio_strategies[s];
+        if (strategy->set_of_support && (!has_goal || num_assumptions > 0))
+            continue;
+        PortfolioLane *lane = &portfolio.lanes[portfolio.num_lanes++];
+        lane->portfolio = &portfolio;
+        lane->strategy = strategy;
+    }
+
+    // A strategy whose thread cannot be created just stays out of the race
+    for (int i = 1; i < portfolio.num_lanes; i++)
+    {
+        PortfolioLane *lane = &portfolio.lanes[i];
+        lane->started = thread_start(&lane->thread, portfolio_worker, lane);
+        if (lane->started)
+            result->strategies++;
+    }
+    portfolio_worker(&portfolio.lanes[0]);
+    result->strategies++;
+
+    for (int i = 0; i < portfolio.num_lanes; i++)
+    {
+        PortfolioLane *lane = &portfolio.lanes[i];
+        if (lane->started)
+            thread_join(lane->thread);
+    }
+    mutex_destroy(&portfolio.lock);
+
+    PortfolioLane *winner = portfolio.winner;
+    if (winner)
+    {
+        result->winner = winner->strategy->name;
+        result->use_cdcl = winner->strategy->use_cdcl;
+        result->cdcl = winner->cdcl;
+        result->resolution = winner->resolution;
+        result->units = winner->units; // Handed over to the result, like the model
+        memset(&winner->units, 0, sizeof(winner->units));
+        result->model = winner->model;
+        winner->model = NULL;
+    }
+    else
+    {
+        result->stopped = portfolio.lanes[0].stopped;
+    }
+    for (int i = 0; i < portfolio.num_lanes; i++)
+    {
+        free_unit_propagation_result(&portfolio.lanes[i].units);
+        free(portfolio.lanes[i].model);
+    }
+    return portfolio.result;
+}
@@ -0,0 +1,882 @@
+/*
+ * Preprocessing: a pipeline of simplifications run before the engines, each removing
+ * variables and clauses while keeping the formula satisfiable exactly when it was
+ *   1. unit propagation at level 0 with failed literal probing,
+ *   2. equivalent literal substitution through the strongly connected components of the
+ *      binary implication graph,
+ *   3. pure literal elimination,
+ *   4. bounded variable elimination in the manner of Davis and Putnam: a variable goes when
+ *      its clauses can be replaced by no more non-tautological resolvents on it.
+ * The clauses removed along with a variable are kept on a stack to give it a value in the model.
+ */
+
+#include "solver_internal.h"
+
+#define ELIMINATION_MAX_OCCURRENCES 16 // Variables in more clauses of either sign are kept
+#define ELIMINATION_MAX_ROUNDS 3       // Passes over the variables left
+#define PROBE_PROPAGATIONS_PER_CLAUSE 10 // Probing stops after this many propagations per clause
+#define PROBE_MIN_PROPAGATIONS 100000
+
+// Structure to represent a formula being simplified, with per-literal occurrence lists
+typedef struct
+{
+    Formula *input;
+    Clause *clauses; // Canonical heap copies; removed ones are freed and never reused
+    uint64_t *signatures;
+    bool *removed;
+    int num_clauses;
+    int capacity;
+    int num_live;
+    IdList *occurrences; // Clause ids containing each literal (removed ones until cleaned)
+    int num_literals;
+
+    const bool *frozen; // Variables that must stay, or NULL
+    bool *eliminated;
+    bool *touched;      // Variables whose clauses changed since they were last tried
+    int bound;          // Clauses an elimination may add
+    Proof *proof;       // Optional: resolvents are logged to it
+    EliminationStack *stack;
+    bool unsatisfiable; // The empty clause was derived
+    Clause resolvent;   // Scratch clause
+    PreprocessStats stats;
+} Eliminator;
+
+// Function to push a removed clause on the stack, the literal of the eliminated variable first
+static bool stack_push(EliminationStack *stack, Clause *clause, Literal pivot)
+{
+    int needed = stack->size + clause->num_literals + 1;
+    if (needed > stack->capacity)
+    {
+        int new_capacity = stack->capacity ? stack->capacity : INITIAL_CAPACITY;
+        while (new_capacity < needed)
+            new_capacity *= GROWTH_FACTOR;
+        uint32_t *words = realloc(stack->words, new_capacity * sizeof(uint32_t));
+        if (!words)
+            return false;
+        stack->words = words;
+        stack->capacity = new_capacity;
+    }
+
+    stack->words[stack->size++] = pivot;
+    for (int k = 0; k < clause->num_literals; k++)
+        if (clause->literals[k] != pivot)
+            stack->words[stack->size++] = clause->literals[k];
+    stack->words[stack->size++] = (uint32_t)clause->num_literals;
+    return true;
+}
+
+// Function to free an elimination stack
+void free_elimination_stack(EliminationStack *stack)
+{
+    free(stack->words);
+    free(stack->eliminated);
+    memset(stack, 0, sizeof(*stack));
+}
+
+// Function to give the eliminated variables a value in a model of the simplified formula
+// The removed clauses are visited from the last one removed; one that is not satisfied yet
+// is satisfied by flipping its eliminated variable, which no clause visited later depends on
+void extend_model(EliminationStack *stack, int8_t *model)
+{
+    int end = stack->size;
+    while (end > 0)
+    {
+        int length = (int)stack->words[end - 1];
+        int start = end - 1 - length;
+        bool satisfied = false;
+        for (int k = start; k < end - 1 && !satisfied; k++)
+        {
+            Literal lit = stack->words[k];
+            satisfied = model[literal_var(lit)] == (literal_is_negated(lit) ? VALUE_FALSE : VALUE_TRUE);
+        }
+        if (!satisfied)
+        {
+            Literal pivot = stack->words[start];
+            model[literal_var(pivot)] = literal_is_negated(pivot) ? VALUE_FALSE : VALUE_TRUE;
+        }
+        end = start;
+    }
+}
+
+// Function to mark the variables of a clause that was added or removed for another try
+static void touch_clause(Eliminator *elim, Clause *clause)
+{
+    for (int k = 0; k < clause->num_literals; k++)
+        elim->touched[literal_var(clause->literals[k])] = true;
+}
+
+// Function to add a canonical clause to the eliminator; returns its id, or -1 on memory error
+static int eliminator_add(Eliminator *elim, Clause *clause)
+{
+    if (elim->num_clauses >= elim->capacity)
+    {
+        int new_capacity = elim->capacity * GROWTH_FACTOR;
+        Clause *clauses = realloc(elim->clauses, new_capacity * sizeof(Clause));
+        if (!clauses)
+            return -1;
+        elim->clauses = clauses;
+        uint64_t *signatures = realloc(elim->signatures, new_capacity * sizeof(uint64_t));
+        if (!signatures)
+            return -1;
+        elim->signatures = signatures;
+        bool *removed = realloc(elim->removed, new_capacity * sizeof(bool));
+        if (!removed)
+            return -1;
+        elim->removed = removed;
+        elim->capacity = new_capacity;
+    }
+
+    int id = elim->num_clauses;
+    if (!copy_clause(&elim->clauses[id], clause))
+        return -1;
+    elim->clauses[id].is_goal = clause->is_goal;
+    elim->signatures[id] = clause_signature(clause);
+    elim->removed[id] = false;
+    elim->num_clauses++;
+    elim->num_live++;
+    touch_clause(elim, clause);
+
+    for (int k = 0; k < clause->num_literals; k++)
+        if (!id_list_push(&elim->occurrences[clause->literals[k]], id))
+            return -1;
+    if (clause->num_literals == 0)
+        elim->unsatisfiable = true;
+    return id;
+}
+
+// Function to remove a clause; its id stays in occurrence lists until they are cleaned
+static void eliminator_remove(Eliminator *elim, int id)
+{
+    touch_clause(elim, &elim->clauses[id]);
+    elim->removed[id] = true;
+    elim->num_live--;
+    free_clause(&elim->clauses[id]);
+}
+
+// Function to drop removed clauses from the occurrence list of a literal, returning its size
+static int live_occurrences(Eliminator *elim, Literal lit)
+{
+    IdList *list = &elim->occurrences[lit];
+    int size = 0;
+    for (int i = 0; i < list->size; i++)
+        if (!elim->removed[list->ids[i]])
+            list->ids[size++] = list->ids[i];
+    list->size = size;
+    return size;
+}
+
+// Function to check whether a live clause subsumes a canonical clause
+static bool eliminator_is_subsumed(Eliminator *elim, Clause *clause, uint64_t signature)
+{
+    for (int k = 0; k < clause->num_literals; k++)
+    {
+        IdList *list = &elim->occurrences[clause->literals[k]];
+        for (int i = 0; i < list->size; i++)
+        {
+            int id = list->ids[i];
+            if (elim->removed[id] || (elim->signatures[id] & ~signature) != 0)
+                continue;
+            if (clause_subsumes(&elim->clauses[id], clause))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Function to remove the live clauses a clause subsumes
+// A goal clause that goes makes its subsumer a goal clause, so the set of support keeps it
+static void eliminator_remove_subsumed(Eliminator *elim, int id)
+{
+    Clause *clause = &elim->clauses[id];
+    if (clause->num_literals == 0)
+        return;
+
+    // Every subsumed clause contains all the literals, so the shortest list is enough
+    Literal best = clause->literals[0];
+    for (int k = 1; k < clause->num_literals; k++)
+        if (live_occurrences(elim, clause->literals[k]) < live_occurrences(elim, best))
+            best = clause->literals[k];
+
+    IdList *list = &elim->occurrences[best];
+    uint64_t signature = elim->signatures[id];
+    for (int i = 0; i < list->size; i++)
+    {
+        int other = list->ids[i];
+        if (other == id || elim->removed[other] || (signature & ~elim->signatures[other]) != 0)
+            continue;
+        if (clause_subsumes(clause, &elim->clauses[other]))
+        {
+            if (elim->clauses[other].is_goal)
+                clause->is_goal = true;
+            eliminator_remove(elim, other);
+            elim->stats.subsumed_clauses++;
+        }
+    }
+}
+
+// Function to add a derived canonical clause unless a live clause subsumes it, removing the
+// clauses it subsumes; it is logged to the proof, where it follows by unit propagation
+// Returns its id, CLAUSE_SUBSUMED, or CLAUSE_ERROR on memory error
+static int eliminator_derive(Eliminator *elim, Clause *clause)
+{
+    uint64_t signature = clause_signature(clause);
+    if (eliminator_is_subsumed(elim, clause, signature))
+        return CLAUSE_SUBSUMED;
+
+    proof_add(elim->proof, clause->literals, clause->num_literals);
+    int id = eliminator_add(elim, clause);
+    if (id < 0)
+        return CLAUSE_ERROR;
+    eliminator_remove_subsumed(elim, id);
+    return id;
+}
+
+// Function to record that a variable was removed from the formula
+static void mark_eliminated(Eliminator *elim, int var)
+{
+    elim->eliminated[var] = true;
+    elim->stack->num_eliminated++;
+}
+
+// ---------------------------------------------------------------------------
+// Unit propagation and failed literal probing
+// ---------------------------------------------------------------------------
+
+// Function to check whether a literal occurs in a live binary clause
+static bool in_binary_clause(Eliminator *elim, Literal lit)
+{
+    IdList *list = &elim->occurrences[lit];
+    for (int i = 0; i < list->size; i++)
+        if (!elim->removed[list->ids[i]] && elim->clauses[list->ids[i]].num_literals == 2)
+            return true;
+    return false;
+}
+
+// Function to remove a literal fixed at level 0 from the formula
+// Clauses it satisfies go, the others lose its negation; a frozen variable keeps a unit clause
+// Returns false on memory error
+static bool apply_unit(Eliminator *elim, Literal unit)
+{
+    int var = literal_var(unit);
+    proof_add(elim->proof, &unit, 1);
+
+    IdList *satisfied = &elim->occurrences[unit];
+    for (int i = 0; i < satisfied->size; i++)
+        if (!elim->removed[satisfied->ids[i]])
+            eliminator_remove(elim, satisfied->ids[i]);
+
+    // New clauses never contain the negation, so its list does not grow meanwhile
+    IdList *shortened = &elim->occurrences[negate_literal(unit)];
+    for (int i = 0; i < shortened->size; i++)
+    {
+        int id = shortened->ids[i];
+        if (elim->removed[id])
+            continue;
+        Clause *clause = &elim->clauses[id];
+        elim->resolvent.num_literals = 0;
+        elim->resolvent.is_goal = clause->is_goal;
+        for (int k = 0; k < clause->num_literals; k++)
+            if (clause->literals[k] != negate_literal(unit) && !add_literal(&elim->resolvent, clause->literals[k]))
+                return false;
+        if (eliminator_derive(elim, &elim->resolvent) == CLAUSE_ERROR)
+            return false;
+        if (!elim->removed[id])
+            eliminator_remove(elim, id);
+    }
+
+    Clause clause = {&unit, 1, 1, false};
+    if (elim->frozen && elim->frozen[var])
+        return eliminator_derive(elim, &clause) != CLAUSE_ERROR;
+    if (!stack_push(elim->stack, &clause, unit))
+        return false;
+    mark_eliminated(elim, var);
+    elim->stats.units.variables++;
+    return true;
+}
+
+// Function to fix the literals unit propagation implies at level 0, after probing each
+// literal that makes a binary clause unit: one whose propagation conflicts fails, and its
+// negation is fixed too. Probing stops after a number of propagations in proportion to the
+// formula size. Returns false on memory error
+static bool probe_failed_literals(Eliminator *elim)
+{
+    int live_before = elim->num_live;
+    Propagator prop;
+    if (!init_propagator(&prop, elim->input->num_variables))
+        return false;
+
+    // Longer clauses are watched before any unit is assigned, so propagation visits them all
+    bool ok = true;
+    for (int id = 0; id < elim->num_clauses && ok; id++)
+    {
+        Clause *clause = &elim->clauses[id];
+        if (!elim->removed[id] && clause->num_literals >= 2)
+            ok = propagator_add_clause(&prop, clause->literals, clause->num_literals, false) != NO_REASON;
+    }
+    for (int id = 0; id < elim->num_clauses && ok && !elim->unsatisfiable; id++)
+    {
+        Clause *clause = &elim->clauses[id];
+        if (elim->removed[id] || clause->num_literals != 1)
+            continue;
+        int8_t value = prop.values[clause->literals[0]];
+        if (value == VALUE_FALSE)
+            elim->unsatisfiable = true;
+        else if (value == VALUE_UNASSIGNED)
+            propagator_assign(&prop, clause->literals[0], NO_REASON);
+    }
+    if (ok && !elim->unsatisfiable && propagator_propagate(&prop) != NO_REASON)
+        elim->unsatisfiable = true;
+
+    long limit = PROBE_MIN_PROPAGATIONS + PROBE_PROPAGATIONS_PER_CLAUSE * (long)elim->num_live;
+    for (int lit = 0; lit < elim->num_literals && ok && !elim->unsatisfiable && prop.propagations < limit; lit++)
+    {
+        if (prop.values[lit] != VALUE_UNASSIGNED || !in_binary_clause(elim, negate_literal((Literal)lit)))
+            continue;
+        propagator_new_level(&prop);
+        propagator_assign(&prop, (Literal)lit, NO_REASON);
+        bool failed = propagator_propagate(&prop) != NO_REASON;
+        propagator_backtrack(&prop, 0);
+        if (!failed)
+            continue;
+
+        Literal unit = negate_literal((Literal)lit);
+        proof_add(elim->proof, &unit, 1);
+        elim->stats.failed_literals++;
+        propagator_assign(&prop, unit, NO_REASON);
+        if (propagator_propagate(&prop) != NO_REASON)
+            elim->unsatisfiable = true;
+    }
+    ok = ok && !prop.out_of_memory;
+
+    if (elim->unsatisfiable)
+        proof_add(elim->proof, NULL, 0);
+    for (int i = 0; i < prop.trail_size && ok && !elim->unsatisfiable; i++)
+        ok = apply_unit(elim, prop.trail[i]);
+    free_propagator(&prop);
+    elim->stats.units.clauses = live_before - elim->num_live;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Equivalent literal substitution
+// ---------------------------------------------------------------------------
+
+// Structure to represent the binary implication graph: a binary clause (a b) gives the
+// edges !a -> b and !b -> a between literal codes, stored by source literal
+typedef struct
+{
+    int *start; // Edges of literal l are targets[start[l]] to targets[start[l + 1] - 1]
+    Literal *targets;
+} ImplicationGraph;
+
+// Function to build the implication graph of the live binary clauses
+static bool build_implication_graph(Eliminator *elim, ImplicationGraph *graph)
+{
+    graph->start = calloc(elim->num_literals + 2, sizeof(int));
+    int num_edges = 0;
+    for (int id = 0; id < elim->num_clauses && graph->start; id++)
+    {
+        Clause *clause = &elim->clauses[id];
+        if (elim->removed[id] || clause->num_literals != 2)
+            continue;
+        graph->start[negate_literal(clause->literals[0]) + 1]++;
+        graph->start[negate_literal(clause->literals[1]) + 1]++;
+        num_edges += 2;
+    }
+    graph->targets = malloc((num_edges + 1) * sizeof(Literal));
+    if (!graph->start || !graph->targets)
+        return false;
+
+    for (int l = 0; l < elim->num_literals; l++)
+        graph->start[l + 1] += graph->start[l];
+    for (int id = 0; id < elim->num_clauses; id++)
+    {
+        Clause *clause = &elim->clauses[id];
+        if (elim->removed[id] || clause->num_literals != 2)
+            continue;
+        graph->targets[graph->start[negate_literal(clause->literals[0])]++] = clause->literals[1];
+        graph->targets[graph->start[negate_literal(clause->literals[1])]++] = clause->literals[0];
+    }
+    for (int l = elim->num_literals; l > 0; l--)
+        graph->start[l] = graph->start[l - 1];
+    graph->start[0] = 0;
+    return true;
+}
+
+// Function to choose the representative of each literal: the literals of a strongly
+// connected component of the implication graph are equivalent and all take one of them, a
+// frozen one if any, so that frozen variables stay. The component of their negations takes
+// the negated representative. Tarjan's algorithm runs with explicit stacks.
+// Returns false on memory error; sets unsatisfiable if a literal is equivalent to its negation
+static bool find_representatives(Eliminator *elim, ImplicationGraph *graph, Literal *representative)
+{
+    int n = elim->num_literals;
+    int *index = malloc((n + 1) * sizeof(int));
+    int *low = malloc((n + 1) * sizeof(int));
+    int *next_edge = malloc((n + 1) * sizeof(int));
+    int *path = malloc((n + 1) * sizeof(int));      // Depth-first search path
+    int *component = malloc((n + 1) * sizeof(int)); // Literals of the components not closed yet
+    bool *on_stack = calloc(n + 1, sizeof(bool));
+    bool *done = calloc(n + 1, sizeof(bool)); // Representative chosen
+    bool ok = index && low && next_edge && path && component && on_stack && done;
+
+    for (int l = 0; l < n && ok; l++)
+    {
+        index[l] = -1;
+        next_edge[l] = graph->start[l];
+        representative[l] = (Literal)l;
+    }
+
+    int counter = 0;
+    int component_size = 0;
+    for (int root = 0; root < n && ok && !elim->unsatisfiable; root++)
+    {
+        if (index[root] >= 0 || graph->start[root] == graph->start[root + 1])
+            continue;
+        int depth = 0;
+        path[depth++] = root;
+        while (depth > 0 && !elim->unsatisfiable)
+        {
+            int v = path[depth - 1];
+            if (index[v] < 0)
+            {
+                index[v] = low[v] = counter++;
+                component[component_size++] = v;
+                on_stack[v] = true;
+            }
+            if (next_edge[v] < graph->start[v + 1])
+            {
+                int w = (int)graph->targets[next_edge[v]++];
+                if (index[w] < 0)
+                    path[depth++] = w;
+                else if (on_stack[w] && index[w] < low[v])
+                    low[v] = index[w];
+                continue;
+            }
+
+            depth--;
+            if (depth > 0 && low[v] < low[path[depth - 1]])
+                low[path[depth - 1]] = low[v];
+            if (low[v] != index[v])
+                continue;
+
+            // v closes a component: the literals from it to the top of the component stack
+            int first = component_size;
+            do
+                on_stack[component[--first]] = false;
+            while (component[first] != v);
+
+            Literal chosen = LITERAL_UNDEF;
+            if (done[negate_literal((Literal)v)])
+                chosen = negate_literal(representative[negate_literal((Literal)v)]);
+            for (int i = first; i < component_size && chosen == LITERAL_UNDEF; i++)
+                if (elim->frozen && elim->frozen[literal_var((Literal)component[i])])
+                    chosen = (Literal)component[i];
+            if (chosen == LITERAL_UNDEF)
+                chosen = (Literal)v;
+            for (int i = first; i < component_size; i++)
+            {
+                representative[component[i]] = chosen;
+                done[component[i]] = true;
+            }
+
+            // A literal and its negation in one component: both imply each other
+            for (int i = first; i < component_size && !elim->unsatisfiable; i++)
+            {
+                Literal lit = (Literal)component[i];
+                if (done[negate_literal(lit)] && representative[negate_literal(lit)] == chosen)
+                {
+                    Literal unit = negate_literal(lit);
+                    proof_add(elim->proof, &unit, 1);
+                    proof_add(elim->proof, NULL, 0);
+                    elim->unsatisfiable = true;
+                }
+            }
+            component_size = first;
+        }
+    }
+
+    free(index);
+    free(low);
+    free(next_edge);
+    free(path);
+    free(component);
+    free(on_stack);
+    free(done);
+    return ok;
+}
+
+// Function to replace a variable by the literal equivalent to it in every clause
+// The clauses of the equivalence go on the stack to give the variable its value back
+// Returns false on memory error
+static bool substitute_variable(Eliminator *elim, int var, Literal replacement)
+{
+    Literal positive = make_literal(var, false);
+    Literal implications[2][2] = {{positive, negate_literal(replacement)}, {negate_literal(positive), replacement}};
+    for (int k = 0; k < 2; k++)
+        proof_add(elim->proof, implications[k], 2);
+
+    // Rewritten clauses never contain the variable, so its lists do not grow meanwhile
+    for (int sign = 0; sign < 2; sign++)
+    {
+        Literal lit = make_literal(var, sign == 1);
+        IdList *list = &elim->occurrences[lit];
+        for (int i = 0; i < list->size; i++)
+        {
+            int id = list->ids[i];
+            if (elim->removed[id])
+                continue;
+            Clause *clause = &elim->clauses[id];
+            elim->resolvent.num_literals = 0;
+            elim->resolvent.is_goal = clause->is_goal;
+            for (int k = 0; k < clause->num_literals; k++)
+            {
+                Literal other = clause->literals[k];
+                if (literal_var(other) == var)
+                    other = sign == 1 ? negate_literal(replacement) : replacement;
+                if (!add_literal(&elim->resolvent, other))
+                    return false;
+            }
+            if (canonicalize_clause(&elim->resolvent) && eliminator_derive(elim, &elim->resolvent) == CLAUSE_ERROR)
+                return false;
+            if (!elim->removed[id])
+                eliminator_remove(elim, id);
+        }
+    }
+
+    for (int k = 0; k < 2; k++)
+    {
+        Clause clause = {implications[k], 2, 2, false};
+        if (!stack_push(elim->stack, &clause, implications[k][0]))
+            return false;
+    }
+    mark_eliminated(elim, var);
+    elim->stats.equivalences.variables++;
+    return true;
+}
+
+// Function to substitute equivalent literals: each variable equivalent to another literal
+// through binary clauses is replaced by the representative of its component
+// Returns false on memory error
+static bool substitute_equivalences(Eliminator *elim)
+{
+    int live_before = elim->num_live;
+    ImplicationGraph graph = {NULL, NULL};
+    Literal *representative = malloc((elim->num_literals + 1) * sizeof(Literal));
+    bool ok = representative && build_implication_graph(elim, &graph) &&
+              find_representatives(elim, &graph, representative);
+
+    for (int v = 0; v < elim->input->num_variables && ok && !elim->unsatisfiable; v++)
+    {
+        Literal replacement = representative[make_literal(v, false)];
+        if (elim->eliminated[v] || literal_var(replacement) == v || (elim->frozen && elim->frozen[v]))
+            continue;
+        ok = substitute_variable(elim, v, replacement);
+    }
+
+    free(graph.start);
+    free(graph.targets);
+    free(representative);
+    elim->stats.equivalences.clauses = live_before - elim->num_live;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Pure literal elimination
+// ---------------------------------------------------------------------------
+
+// Function to remove the clauses of pure literals, those whose negation occurs nowhere;
+// removing them can make more literals pure, whose variables are checked again
+// Returns false on memory error
+static bool eliminate_pure_literals(Eliminator *elim)
+{
+    int live_before = elim->num_live;
+    int num_vars = elim->input->num_variables;
+    int *queue = malloc((num_vars + 1) * sizeof(int)); // Circular, each variable at most once
+    bool *queued = calloc(num_vars + 1, sizeof(bool));
+    bool ok = queue && queued;
+
+    int head = 0;
+    int count = 0;
+    for (int v = 0; v < num_vars && ok; v++)
+    {
+        if (elim->eliminated[v] || (elim->frozen && elim->frozen[v]))
+            continue;
+        queue[count++] = v;
+        queued[v] = true;
+    }
+
+    while (count > 0 && ok)
+    {
+        int var = queue[head];
+        head = (head + 1) % num_vars;
+        count--;
+        queued[var] = false;
+
+        Literal positive = make_literal(var, false);
+        int num_positive = live_occurrences(elim, positive);
+        int num_negative = live_occurrences(elim, negate_literal(positive));
+        if ((num_positive > 0) == (num_negative > 0))
+            continue;
+
+        Literal pure = num_positive > 0 ? positive : negate_literal(positive);
+        mark_eliminated(elim, var);
+        elim->stats.pure.variables++;
+        IdList *list = &elim->occurrences[pure];
+        for (int i = 0; i < list->size && ok; i++)
+        {
+            Clause *clause = &elim->clauses[list->ids[i]];
+            ok = stack_push(elim->stack, clause, pure);
+            for (int k = 0; k < clause->num_literals && ok; k++)
+            {
+                int other = literal_var(clause->literals[k]);
+                if (queued[other] || elim->eliminated[other] || (elim->frozen && elim->frozen[other]))
+                    continue;
+                queue[(head + count) % num_vars] = other;
+                queued[other] = true;
+                count++;
+            }
+            eliminator_remove(elim, list->ids[i]);
+        }
+    }
+
+    free(queue);
+    free(queued);
+    elim->stats.pure.clauses = live_before - elim->num_live;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Bounded variable elimination
+// ---------------------------------------------------------------------------
+
+// Function to try to eliminate a variable, within the occurrence and clause bounds
+// Returns false on memory error
+static bool try_eliminate(Eliminator *elim, int var)
+{
+    Literal positive = make_literal(var, false);
+    Literal negative = make_literal(var, true);
+    int num_positive = live_occurrences(elim, positive);
+    int num_negative = live_occurrences(elim, negative);
+    if (num_positive + num_negative == 0)
+        return true;
+
+    // A pure variable goes with all its clauses; otherwise count the resolvents first
+    if (num_positive > 0 && num_negative > 0)
+    {
+        if (num_positive > ELIMINATION_MAX_OCCURRENCES || num_negative > ELIMINATION_MAX_OCCURRENCES)
+            return true;
+        int limit = num_positive + num_negative + elim->bound;
+        int count = 0;
+        for (int i = 0; i < num_positive && count <= limit; i++)
+        {
+            for (int j = 0; j < num_negative && count <= limit; j++)
+            {
+                Clause *c1 = &elim->clauses[elim->occurrences[positive].ids[i]];
+                Clause *c2 = &elim->clauses[elim->occurrences[negative].ids[j]];
+                if (resolve(c1, c2, positive, &elim->resolvent))
+                    count++;
+                else if (elim->resolvent.num_literals < 0)
+                    return false;
+            }
+        }
+        if (count > limit)
+            return true;
+    }
+
+    // Resolvents go in first, so that the proof derives them from the clauses they replace;
+    // the occurrence lists are copied since adding resolvents may remove clauses
+    int total = num_positive + num_negative;
+    int *ids = malloc(total * sizeof(int));
+    if (!ids)
+        return false;
+    for (int i = 0; i < num_positive; i++)
+        ids[i] = elim->occurrences[positive].ids[i];
+    for (int j = 0; j < num_negative; j++)
+        ids[num_positive + j] = elim->occurrences[negative].ids[j];
+
+    bool ok = true;
+    for (int i = 0; i < num_positive && ok && !elim->unsatisfiable; i++)
+    {
+        for (int j = num_positive; j < total && ok && !elim->unsatisfiable; j++)
+        {
+            Clause *c1 = &elim->clauses[ids[i]];
+            Clause *c2 = &elim->clauses[ids[j]];
+            if (elim->removed[ids[i]] || elim->removed[ids[j]])
+                continue; // Subsumed by an earlier resolvent, which then stands for it
+            if (resolve(c1, c2, positive, &elim->resolvent))
+            {
+                elim->resolvent.is_goal = c1->is_goal || c2->is_goal;
+                int id = eliminator_derive(elim, &elim->resolvent);
+                ok = id != CLAUSE_ERROR;
+                if (id >= 0)
+                    elim->stats.resolvents++;
+            }
+            else if (elim->resolvent.num_literals < 0)
+            {
+                ok = false;
+            }
+        }
+    }
+
+    // Clauses subsumed by a resolvent are implied by it and need no place on the stack
+    for (int i = 0; i < total && ok; i++)
+    {
+        if (elim->removed[ids[i]])
+            continue;
+        ok = stack_push(elim->stack, &elim->clauses[ids[i]], i < num_positive ? positive : negative);
+        eliminator_remove(elim, ids[i]);
+    }
+    free(ids);
+
+    if (ok)
+    {
+        mark_eliminated(elim, var);
+        elim->stats.elimination.variables++;
+    }
+    return ok;
+}
+
+// Function to compare variables by elimination cost for qsort (positive times negative occurrences)
+static int compare_costs(const void *a, const void *b)
+{
+    const long *x = a;
+    const long *y = b;
+    return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+// Function to run rounds of elimination, cheapest variables first, until a round removes
+// nothing; a variable is only tried again once its clauses have changed
+// Returns false on memory error
+static bool eliminate_rounds(Eliminator *elim)
+{
+    int num_vars = elim->input->num_variables;
+    long *order = malloc((num_vars + 1) * 2 * sizeof(long)); // Pairs of cost and variable
+    if (!order)
+        return false;
+
+    int live_before = elim->num_live;
+    bool ok = true;
+    for (int round = 0; round < ELIMINATION_MAX_ROUNDS && ok && !elim->unsatisfiable; round++)
+    {
+        int count = 0;
+        for (int v = 0; v < num_vars; v++)
+        {
+            if (elim->eliminated[v] || !elim->touched[v] || (elim->frozen && elim->frozen[v]))
+                continue;
+            long num_positive = live_occurrences(elim, make_literal(v, false));
+            long num_negative = live_occurrences(elim, make_literal(v, true));
+            if (num_positive + num_negative == 0)
+                continue;
+            order[2 * count] = num_positive * num_negative;
+            order[2 * count + 1] = v;
+            count++;
+        }
+        qsort(order, count, 2 * sizeof(long), compare_costs);
+
+        int before = elim->stats.elimination.variables;
+        for (int i = 0; i < count && ok && !elim->unsatisfiable; i++)
+        {
+            int var = (int)order[2 * i + 1];
+            elim->touched[var] = false;
+            ok = try_eliminate(elim, var);
+        }
+        if (elim->stats.elimination.variables == before)
+            break;
+    }
+    free(order);
+    elim->stats.elimination.clauses = live_before - elim->num_live;
+    return ok;
+}
+
+// Function to free an eliminator
+static void free_eliminator(Eliminator *elim)
+{
+    for (int i = 0; i < elim->num_clauses; i++)
+        if (!elim->removed[i])
+            free_clause(&elim->clauses[i]);
+    free(elim->clauses);
+    free(elim->signatures);
+    free(elim->removed);
+    if (elim->occurrences)
+        for (int i = 0; i < elim->num_literals; i++)
+            free(elim->occurrences[i].ids);
+    free(elim->occurrences);
+    free(elim->touched);
+    free_clause(&elim->resolvent);
+}
+
+// Function to simplify a formula into a new formula with the same variables
+// Frozen variables (those of assumptions, for instance) are kept. The removed clauses are
+// pushed on the stack for extend_model, and derived clauses are logged to the proof if given;
+// removed clauses are not logged as deleted, so that later runs may start from the input
+// again. Returns false on memory error
+bool preprocess_formula(Formula *input, Formula *output, const bool *frozen, int bound, Proof *proof,
+                        EliminationStack *stack, PreprocessStats *stats)
+{
+    double start = now_seconds();
+    double cpu_start = cpu_seconds();
+    Eliminator elim;
+    memset(&elim, 0, sizeof(elim));
+    memset(stack, 0, sizeof(*stack));
+    elim.input = input;
+    elim.frozen = frozen;
+    elim.bound = bound;
+    elim.proof = proof;
+    elim.stack = stack;
+    elim.capacity = input->num_clauses > 0 ? input->num_clauses : INITIAL_CAPACITY;
+    elim.num_literals = 2 * input->num_variables;
+    elim.clauses = malloc(elim.capacity * sizeof(Clause));
+    elim.signatures = malloc(elim.capacity * sizeof(uint64_t));
+    elim.removed = malloc(elim.capacity * sizeof(bool));
+    elim.occurrences = calloc(elim.num_literals + 1, sizeof(IdList));
+    elim.eliminated = calloc(input->num_variables + 1, sizeof(bool));
+    stack->eliminated = elim.eliminated; // Owned by the stack from now on
+    elim.touched = calloc(input->num_variables + 1, sizeof(bool));
+    bool ok = elim.clauses && elim.signatures && elim.removed && elim.occurrences && elim.eliminated && elim.touched &&
+              init_clause(&elim.resolvent);
+
+    // Canonical copies of the clauses, with subsumed ones removed
+    for (int i = 0; i < input->num_clauses && ok; i++)
+    {
+        ok = assign_clause(&elim.resolvent, &input->clauses[i]);
+        if (ok && canonicalize_clause(&elim.resolvent))
+            ok = eliminator_add(&elim, &elim.resolvent) >= 0;
+    }
+    for (int i = 0; i < elim.num_clauses && ok; i++)
+        if (!elim.removed[i])
+            eliminator_remove_subsumed(&elim, i);
+
+    // Every stage stops as soon as the empty clause is derived
+    ok = ok && (elim.unsatisfiable || probe_failed_literals(&elim));
+    ok = ok && (elim.unsatisfiable || substitute_equivalences(&elim));
+    ok = ok && (elim.unsatisfiable || eliminate_pure_literals(&elim));
+    ok = ok && (elim.unsatisfiable || eliminate_rounds(&elim));
+
+    // The simplified formula keeps the variable ids of the input
+    ok = ok && init_formula(output);
+    if (ok)
+    {
+        for (int v = 0; v < input->num_variables && ok; v++)
+            ok = find_or_add_variable(output, input->variables[v].name) == v;
+        Clause empty = {NULL, 0, 0, false};
+        if (ok && elim.unsatisfiable)
+            ok = add_clause(output, &empty);
+        for (int i = 0; i < elim.num_clauses && ok && !elim.unsatisfiable; i++)
+            if (!elim.removed[i])
+                ok = add_clause(output, &elim.clauses[i]);
+        if (!ok)
+            free_formula(output);
+    }
+
+    elim.stats.clauses_before = input->num_clauses;
+    elim.stats.clauses_after = ok ? output->num_clauses : input->num_clauses;
+    elim.stats.seconds = now_seconds() - start;
+    elim.stats.cpu_seconds = cpu_seconds() - cpu_start;
+    if (stats)
+        *stats = elim.stats;
+    free_eliminator(&elim);
+    if (!ok)
+        free_elimination_stack(stack);
+    return ok;
+}
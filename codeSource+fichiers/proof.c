@@ -0,0 +1,256 @@
+/*
+ * DRAT proofs of unsatisfiability, in the text or binary format read by checkers such as
+ * drat-trim. Every clause an engine derives is implied by unit propagation (RUP) over the
+ * formula and the clauses logged before it, ending with the empty clause.
+ * Logging only encodes the clause into a buffer; a writer thread does the file I/O.
+ */
+
+#include "solver_internal.h"
+
+#define PROOF_BUFFER_SIZE (1 << 20) // Bytes collected before they are handed to the writer thread
+#define PROOF_LITERAL_BYTES 12      // Longest text literal: "-2147483647 "
+
+// Function run by the writer thread: write out each buffer handed over until stopped
+static THREAD_FUNCTION proof_writer(void *arg)
+{
+    Proof *proof = arg;
+    mutex_lock(&proof->lock);
+    for (;;)
+    {
+        while (proof->pending_size == 0 && !proof->stop)
+            condition_wait(&proof->changed, &proof->lock);
+        if (proof->pending_size == 0)
+            break;
+
+        size_t size = proof->pending_size;
+        mutex_unlock(&proof->lock);
+        bool written = fwrite(proof->pending, 1, size, proof->file) == size;
+        mutex_lock(&proof->lock);
+
+        if (!written)
+            proof->write_failed = true;
+        proof->pending_size = 0;
+        condition_broadcast(&proof->changed);
+    }
+    mutex_unlock(&proof->lock);
+    return THREAD_RESULT;
+}
+
+// Function to hand the filled buffer over to the writer thread and continue in the other one
+// Waits only if the writer has not finished the previous buffer yet
+static void proof_flush(Proof *proof)
+{
+    if (proof->used == 0)
+        return;
+    if (!proof->threaded)
+    {
+        if (fwrite(proof->buffer, 1, proof->used, proof->file) != proof->used)
+            proof->failed = true;
+        proof->used = 0;
+        return;
+    }
+
+    mutex_lock(&proof->lock);
+    while (proof->pending_size > 0)
+        condition_wait(&proof->changed, &proof->lock);
+    char *full = proof->buffer;
+    size_t full_capacity = proof->capacity;
+    proof->buffer = proof->pending;
+    proof->capacity = proof->pending_capacity;
+    proof->pending = full;
+    proof->pending_capacity = full_capacity;
+    proof->pending_size = proof->used;
+    condition_broadcast(&proof->changed);
+    mutex_unlock(&proof->lock);
+    proof->used = 0;
+}
+
+// Function to make room for a number of bytes in the buffer
+static bool proof_reserve(Proof *proof, size_t bytes)
+{
+    if (proof->used + bytes <= proof->capacity)
+        return true;
+    proof_flush(proof);
+    if (bytes <= proof->capacity)
+        return true;
+
+    // A clause longer than a whole buffer
+    char *buffer = realloc(proof->buffer, bytes);
+    if (!buffer)
+    {
+        proof->failed = true;
+        return false;
+    }
+    proof->buffer = buffer;
+    proof->capacity = bytes;
+    return true;
+}
+
+// Function to get the DIMACS number of the variable of a literal
+static int proof_number(Proof *proof, Literal lit)
+{
+    int var = literal_var(lit);
+    return var < proof->num_numbers ? proof->numbers[var] : var + 1;
+}
+
+// Function to write an integer in decimal, returning the number of characters
+static int write_int(char *out, int value)
+{
+    char digits[12];
+    int n = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    int length = 0;
+    if (value < 0)
+        out[length++] = '-';
+    while (n > 0)
+        out[length++] = digits[--n];
+    return length;
+}
+
+// Function to log a clause addition or deletion
+static void proof_clause(Proof *proof, bool deletion, const Literal *literals, int num_literals)
+{
+    if (!proof || proof->failed)
+        return;
+    if (!proof_reserve(proof, (size_t)(num_literals + 2) * PROOF_LITERAL_BYTES))
+        return;
+
+    char *out = proof->buffer + proof->used;
+    if (proof->binary)
+    {
+        // 'a' or 'd', then each literal as the variable-length integer 2 * number + sign
+        *out++ = deletion ? 'd' : 'a';
+        for (int i = 0; i < num_literals; i++)
+        {
+            uint32_t code = 2u * (uint32_t)proof_number(proof, literals[i]) + (literal_is_negated(literals[i]) ? 1u : 0u);
+            while (code > 127)
+            {
+                *out++ = (char)(128 | (code & 127));
+                code >>= 7;
+            }
+            *out++ = (char)code;
+        }
+        *out++ = 0;
+    }
+    else
+    {
+        if (deletion)
+        {
+            *out++ = 'd';
+            *out++ = ' ';
+        }
+        for (int i = 0; i < num_literals; i++)
+        {
+            int number = proof_number(proof, literals[i]);
+            out += write_int(out, literal_is_negated(literals[i]) ? -number : number);
+            *out++ = ' ';
+        }
+        *out++ = '0';
+        *out++ = '\n';
+    }
+    proof->used = (size_t)(out - proof->buffer);
+}
+
+// Function to log a derived clause (the empty clause when num_literals is 0)
+void proof_add(Proof *proof, const Literal *literals, int num_literals)
+{
+    proof_clause(proof, false, literals, num_literals);
+    if (proof)
+        proof->lemmas++;
+}
+
+// Function to log that a clause is no longer used
+void proof_delete(Proof *proof, const Literal *literals, int num_literals)
+{
+    proof_clause(proof, true, literals, num_literals);
+    if (proof)
+        proof->deletions++;
+}
+
+// Function to number the variables of a formula as the proof checker will
+// Variables named by a positive integer (DIMACS input) keep it; the others are numbered by
+// order of first appearance. Call it again when the formula gains variables
+bool proof_map_variables(Proof *proof, Formula *formula)
+{
+    if (formula->num_variables <= proof->num_numbers)
+        return true;
+    int *numbers = realloc(proof->numbers, formula->num_variables * sizeof(int));
+    if (!numbers)
+        return false;
+    proof->numbers = numbers;
+
+    for (int v = proof->num_numbers; v < formula->num_variables; v++)
+    {
+        const char *name = formula->variables[v].name;
+        char *end;
+        long number = strtol(name, &end, 10);
+        bool numeric = isdigit((unsigned char)name[0]) && *end == '\0' && number > 0 && number <= INT32_MAX;
+        proof->numbers[v] = numeric ? (int)number : v + 1;
+    }
+    proof->num_numbers = formula->num_variables;
+    return true;
+}
+
+// Function to create a proof file and start its writer thread
+// Returns false (after printing the reason) if the file or its buffers cannot be created
+bool proof_open(Proof *proof, const char *filename, bool binary)
+{
+    memset(proof, 0, sizeof(*proof));
+    proof->file = fopen(filename, binary ? "wb" : "w");
+    if (!proof->file)
+    {
+        printf("Error: Unable to create proof file %s\n", filename);
+        return false;
+    }
+
+    proof->binary = binary;
+    proof->buffer = malloc(PROOF_BUFFER_SIZE);
+    proof->pending = malloc(PROOF_BUFFER_SIZE);
+    if (!proof->buffer || !proof->pending)
+    {
+        printf("Error: Memory allocation failed for proof buffers\n");
+        free(proof->buffer);
+        free(proof->pending);
+        fclose(proof->file);
+        return false;
+    }
+    proof->capacity = PROOF_BUFFER_SIZE;
+    proof->pending_capacity = PROOF_BUFFER_SIZE;
+
+    mutex_init(&proof->lock);
+    condition_init(&proof->changed);
+    proof->threaded = thread_start(&proof->thread, proof_writer, proof);
+    return true;
+}
+
+// Function to write out what is left of a proof and close its file
+// Returns false if any part of the proof could not be written
+bool proof_close(Proof *proof)
+{
+    proof_flush(proof);
+    if (proof->threaded)
+    {
+        mutex_lock(&proof->lock);
+        proof->stop = true;
+        condition_broadcast(&proof->changed);
+        mutex_unlock(&proof->lock);
+        thread_join(proof->thread);
+    }
+    condition_destroy(&proof->changed);
+    mutex_destroy(&proof->lock);
+
+    bool ok = !proof->failed && !proof->write_failed;
+    if (fclose(proof->file) != 0)
+        ok = false;
+    free(proof->buffer);
+    free(proof->pending);
+    free(proof->numbers);
+    memset(proof, 0, sizeof(*proof));
+    return ok;
+}
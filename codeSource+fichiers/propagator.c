@@ -0,0 +1,433 @@
+/*
+ * Trail-based unit propagation with two watched literals
+ */
+
+#include "solver_internal.h"
+
+// Function to append a watch to a watch list
+static bool watch_list_push(WatchList *list, ClauseRef clause, Literal blocker)
+{
+    if (list->size >= list->capacity)
+    {
+        int new_capacity = list->capacity ? list->capacity * GROWTH_FACTOR : 4;
+        Watch *new_watches = realloc(list->watches, new_capacity * sizeof(Watch));
+        if (!new_watches)
+            return false;
+        list->watches = new_watches;
+        list->capacity = new_capacity;
+    }
+    list->watches[list->size].clause = clause;
+    list->watches[list->size].blocker = blocker;
+    list->size++;
+    return true;
+}
+
+// Function to free a propagator and the clauses it owns
+void free_propagator(Propagator *prop)
+{
+    if (prop->watches)
+    {
+        for (int i = 0; i < 2 * prop->num_vars; i++)
+            free(prop->watches[i].watches);
+    }
+    free_clause_pool(&prop->pool);
+    free(prop->watches);
+    free(prop->values);
+    free(prop->levels);
+    free(prop->reasons);
+    free(prop->trail);
+    free(prop->trail_limits);
+    memset(prop, 0, sizeof(*prop));
+}
+
+// Function to make room for more variables in a propagator; new variables are unassigned
+// Returns false on memory error, leaving the propagator usable with its old size
+bool propagator_reserve_variables(Propagator *prop, int num_vars)
+{
+    if (num_vars <= prop->num_vars && prop->watches)
+        return true;
+
+    // Allocate at least one entry so that an empty formula still gets valid arrays
+    size_t old_n = prop->watches ? (size_t)prop->num_vars + 1 : 0;
+    size_t n = (size_t)num_vars + 1;
+    WatchList *watches = realloc(prop->watches, 2 * n * sizeof(WatchList));
+    if (watches)
+        prop->watches = watches;
+    int8_t *values = realloc(prop->values, 2 * n * sizeof(int8_t));
+    if (values)
+        prop->values = values;
+    int *levels = realloc(prop->levels, n * sizeof(int));
+    if (levels)
+        prop->levels = levels;
+    ClauseRef *reasons = realloc(prop->reasons, n * sizeof(ClauseRef));
+    if (reasons)
+        prop->reasons = reasons;
+    Literal *trail = realloc(prop->trail, n * sizeof(Literal));
+    if (trail)
+        prop->trail = trail;
+    int *trail_limits = realloc(prop->trail_limits, n * sizeof(int));
+    if (trail_limits)
+        prop->trail_limits = trail_limits;
+    if (!watches || !values || !levels || !reasons || !trail || !trail_limits)
+        return false;
+
+    memset(prop->watches + 2 * old_n, 0, 2 * (n - old_n) * sizeof(WatchList));
+    memset(prop->values + 2 * old_n, VALUE_UNASSIGNED, 2 * (n - old_n) * sizeof(int8_t));
+    memset(prop->levels + old_n, 0, (n - old_n) * sizeof(int));
+    for (size_t v = old_n; v < n; v++)
+    {
+        prop->reasons[v] = NO_REASON;
+    }
+    prop->num_vars = num_vars;
+    return true;
+}
+
+// Function to initialize an empty propagator for a number of variables
+bool init_propagator(Propagator *prop, int num_vars)
+{
+    memset(prop, 0, sizeof(*prop));
+    init_clause_pool(&prop->pool);
+    if (!propagator_reserve_variables(prop, num_vars))
+    {
+        free_propagator(prop);
+        return false;
+    }
+    return true;
+}
+
+// Function to assign a literal true at the current decision level and push it on the trail
+void propagator_assign(Propagator *prop, Literal lit, ClauseRef reason)
+{
+    int var = literal_var(lit);
+    prop->values[lit] = VALUE_TRUE;
+    prop->values[negate_literal(lit)] = VALUE_FALSE;
+    prop->levels[var] = prop->decision_level;
+    prop->reasons[var] = reason;
+    prop->trail[prop->trail_size++] = lit;
+}
+
+// Function to open a new decision level
+void propagator_new_level(Propagator *prop)
+{
+    prop->trail_limits[prop->decision_level++] = prop->trail_size;
+}
+
+// Function to store a clause of two or more literals and watch its first two literals
+// Returns the clause reference, or NO_REASON if memory runs out
+ClauseRef propagator_add_clause(Propagator *prop, const Literal *literals, int num_literals, bool learned)
+{
+    ClauseRef ref = pool_add_clause(&prop->pool, literals, num_literals, learned ? POOL_LEARNED : 0);
+    if (ref == CLAUSE_REF_UNDEF)
+        return NO_REASON;
+
+    if (!watch_list_push(&prop->watches[literals[0]], ref, literals[1]))
+    {
+        pool_delete_clause(&prop->pool, ref);
+        return NO_REASON;
+    }
+    if (!watch_list_push(&prop->watches[literals[1]], ref, literals[0]))
+    {
+        prop->watches[literals[0]].size--;
+        pool_delete_clause(&prop->pool, ref);
+        return NO_REASON;
+    }
+    prop->num_clauses++;
+    return ref;
+}
+
+// Function to check if a clause is the reason of its implied literal (and so must be kept)
+bool propagator_clause_is_reason(Propagator *prop, ClauseRef ref)
+{
+    Literal first = pool_clause(&prop->pool, ref)->literals[0];
+    return prop->values[first] == VALUE_TRUE && prop->reasons[literal_var(first)] == ref;
+}
+
+// Function to delete a clause; its watches and space stay until propagator_collect_garbage
+void propagator_remove_clause(Propagator *prop, ClauseRef ref)
+{
+    pool_delete_clause(&prop->pool, ref);
+    prop->num_clauses--;
+}
+
+// Function to drop the watches of deleted clauses and compact the clause pool,
+// moving every watch and reason to the new clause positions
+void propagator_collect_garbage(Propagator *prop)
+{
+    pool_plan_compaction(&prop->pool);
+    for (int lit = 0; lit < 2 * prop->num_vars; lit++)
+    {
+        WatchList *list = &prop->watches[lit];
+        int j = 0;
+        for (int i = 0; i < list->size; i++)
+        {
+            ClauseRef moved = pool_forward(&prop->pool, list->watches[i].clause);
+            if (moved != CLAUSE_REF_UNDEF)
+            {
+                list->watches[j] = list->watches[i];
+                list->watches[j++].clause = moved;
+            }
+        }
+        list->size = j;
+    }
+
+    // Reason clauses are never deleted, so every reason has a new position
+    for (int i = 0; i < prop->trail_size; i++)
+    {
+        int var = literal_var(prop->trail[i]);
+        if (prop->reasons[var] != NO_REASON)
+            prop->reasons[var] = pool_forward(&prop->pool, prop->reasons[var]);
+    }
+    pool_compact(&prop->pool);
+}
+
+// Function to propagate every assignment on the trail that has not been propagated yet
+// Returns a clause with all literals false, or NO_REASON if no conflict arises
+ClauseRef propagator_propagate(Propagator *prop)
+{
+    ClauseRef conflict = NO_REASON;
+    while (prop->propagate_head < prop->trail_size && conflict == NO_REASON)
+    {
+        Literal false_lit = negate_literal(prop->trail[prop->propagate_head++]);
+        WatchList *list = &prop->watches[false_lit];
+        Watch *watches = list->watches;
+        int i = 0, j = 0;
+        prop->propagations++;
+
+        while (i < list->size)
+        {
+            Watch watch = watches[i++];
+            if (prop->values[watch.blocker] == VALUE_TRUE)
+            {
+                watches[j++] = watch;
+                continue;
+            }
+
+            // Make sure the false literal is literals[1]
+            PoolClause *clause = pool_clause(&prop->pool, watch.clause);
+            Literal *lits = clause->literals;
+            if (lits[0] == false_lit)
+            {
+                lits[0] = lits[1];
+                lits[1] = false_lit;
+            }
+
+            Literal first = lits[0];
+            watch.blocker = first;
+            if (prop->values[first] == VALUE_TRUE)
+            {
+                watches[j++] = watch;
+                continue;
+            }
+
+            // Look for a new literal to watch
+            int size = (int)clause->num_literals;
+            bool moved = false;
+            for (int k = 2; k < size; k++)
+            {
+                if (prop->values[lits[k]] != VALUE_FALSE)
+                {
+                    lits[1] = lits[k];
+                    lits[k] = false_lit;
+                    // Watch lists of other literals only, so this list never moves under us
+                    if (!watch_list_push(&prop->watches[lits[1]], watch.clause, first))
+                        prop->out_of_memory = true;
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved)
+                continue;
+
+            // The clause is unit or conflicting under the current assignment
+            watches[j++] = watch;
+            if (prop->values[first] == VALUE_FALSE)
+            {
+                conflict = watch.clause;
+                while (i < list->size)
+                    watches[j++] = watches[i++];
+            }
+            else
+            {
+                propagator_assign(prop, first, watch.clause);
+            }
+        }
+        list->size = j;
+    }
+    return conflict;
+}
+
+// Function to undo all assignments above a decision level
+void propagator_backtrack(Propagator *prop, int level)
+{
+    if (prop->decision_level <= level)
+        return;
+
+    for (int i = prop->trail_size - 1; i >= prop->trail_limits[level]; i--)
+    {
+        Literal lit = prop->trail[i];
+        prop->values[lit] = VALUE_UNASSIGNED;
+        prop->values[negate_literal(lit)] = VALUE_UNASSIGNED;
+        prop->reasons[literal_var(lit)] = NO_REASON;
+    }
+    prop->trail_size = prop->trail_limits[level];
+    prop->propagate_head = prop->trail_size;
+    prop->decision_level = level;
+}
+
+// Function to load clauses of a formula, from a given index on, at decision level 0
+// Tautologies and clauses already satisfied are skipped and literals already false are
+// dropped; unit clauses are assigned and longer clauses are watched
+// Returns false on memory error; *conflict_clause is set to the index of a formula clause
+// that is empty or falsified by the units assigned so far, or -1
+bool propagator_load_formula(Propagator *prop, Formula *formula, int first, int *conflict_clause)
+{
+    *conflict_clause = -1;
+    Clause scratch;
+    if (!init_clause(&scratch))
+        return false;
+
+    // Size the pool for the new clauses up front
+    size_t words = 0;
+    for (int i = first; i < formula->num_clauses; i++)
+        words += POOL_HEADER_WORDS + formula->clauses[i].num_literals;
+    bool ok = pool_reserve(&prop->pool, words);
+    for (int i = first; i < formula->num_clauses && ok; i++)
+    {
+        if (!assign_clause(&scratch, &formula->clauses[i]))
+        {
+            ok = false;
+            break;
+        }
+        if (!canonicalize_clause(&scratch))
+            continue;
+
+        // Level 0 assignments are permanent, so simplify the clause with them
+        bool satisfied = false;
+        int size = 0;
+        for (int k = 0; k < scratch.num_literals && !satisfied; k++)
+        {
+            int8_t value = prop->values[scratch.literals[k]];
+            if (value == VALUE_TRUE)
+                satisfied = true;
+            else if (value == VALUE_UNASSIGNED)
+                scratch.literals[size++] = scratch.literals[k];
+        }
+        if (satisfied)
+            continue;
+        scratch.num_literals = size;
+
+        if (scratch.num_literals <= 1)
+        {
+            if (scratch.num_literals == 0)
+            {
+                if (*conflict_clause < 0)
+                    *conflict_clause = i;
+            }
+            else
+            {
+                propagator_assign(prop, scratch.literals[0], NO_REASON);
+            }
+            continue;
+        }
+
+        ok = propagator_add_clause(prop, scratch.literals, scratch.num_literals, false) != NO_REASON;
+    }
+
+    free_clause(&scratch);
+    return ok;
+}
+
+// Function to free the arrays of a unit propagation result
+void free_unit_propagation_result(UnitPropagationResult *result)
+{
+    free(result->assignments);
+    if (result->conflict)
+        free_clause(&result->conflict_clause);
+    memset(result, 0, sizeof(*result));
+}
+
+// Function to perform unit propagation
+// Propagates all unit clauses to a fixpoint in time linear in the formula size, then
+// simplifies the formula in place: satisfied clauses and false literals are removed, so
+// no assigned variable occurs in it anymore. Returns false only on memory error.
+bool unit_propagation(Formula *formula, UnitPropagationResult *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    Propagator prop;
+    if (!init_propagator(&prop, formula->num_variables))
+        return false;
+
+    int conflict_index;
+    if (!propagator_load_formula(&prop, formula, 0, &conflict_index))
+    {
+        free_propagator(&prop);
+        return false;
+    }
+
+    bool copied = true;
+    if (conflict_index >= 0)
+    {
+        result->conflict = true;
+        copied = copy_clause(&result->conflict_clause, &formula->clauses[conflict_index]);
+    }
+    else
+    {
+        ClauseRef conflict = propagator_propagate(&prop);
+        if (prop.out_of_memory)
+        {
+            free_propagator(&prop);
+            return false;
+        }
+        if (conflict != NO_REASON)
+        {
+            result->conflict = true;
+            Clause view = pool_clause_view(&prop.pool, conflict);
+            copied = copy_clause(&result->conflict_clause, &view);
+        }
+    }
+    result->propagations = prop.propagations;
+
+    result->assignments = malloc((prop.trail_size ? prop.trail_size : 1) * sizeof(Literal));
+    if (!copied || !result->assignments)
+    {
+        result->conflict = result->conflict && copied;
+        free_unit_propagation_result(result);
+        free_propagator(&prop);
+        return false;
+    }
+    memcpy(result->assignments, prop.trail, prop.trail_size * sizeof(Literal));
+    result->num_assignments = prop.trail_size;
+
+    if (!result->conflict)
+    {
+        int kept = 0;
+        for (int i = 0; i < formula->num_clauses; i++)
+        {
+            Clause *clause = &formula->clauses[i];
+            bool satisfied = false;
+            int size = 0;
+            for (int k = 0; k < clause->num_literals && !satisfied; k++)
+            {
+                int8_t value = prop.values[clause->literals[k]];
+                if (value == VALUE_TRUE)
+                    satisfied = true;
+                else if (value == VALUE_UNASSIGNED)
+                    clause->literals[size++] = clause->literals[k];
+            }
+
+            if (satisfied)
+            {
+                result->removed_clauses++;
+                continue;
+            }
+            result->removed_literals += clause->num_literals - size;
+            clause->num_literals = size;
+            formula->clauses[kept++] = *clause;
+        }
+        formula->num_clauses = kept;
+    }
+
+    free_propagator(&prop);
+    return true;
+}
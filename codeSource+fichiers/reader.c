@@ -0,0 +1,422 @@
+/*
+ * Formula file readers: the name-based format and DIMACS CNF
+ */
+
+#include "solver_internal.h"
+
+// Function to make room for a number of additional clauses in a formula
+static bool reserve_clauses(Formula *formula, int count)
+{
+    if (count <= formula->capacity - formula->num_clauses)
+        return true;
+
+    int new_capacity = formula->num_clauses + count;
+    Clause *new_clauses = realloc(formula->clauses, new_capacity * sizeof(Clause));
+    if (!new_clauses)
+        return false;
+    formula->clauses = new_clauses;
+    formula->capacity = new_capacity;
+    return true;
+}
+
+// Function to add variables named "1".."count" (DIMACS numbering) to an empty formula
+static bool add_numbered_variables(Formula *formula, int count)
+{
+    char name[16];
+    for (int i = formula->num_variables + 1; i <= count; i++)
+    {
+        snprintf(name, sizeof(name), "%d", i);
+        if (find_or_add_variable(formula, name) < 0)
+            return false;
+    }
+    return true;
+}
+
+// Structure to accumulate the literals of one clause while parsing
+// Repeated literals are dropped and tautologies flagged in O(1) per literal by stamping
+// each literal code with the number of the clause it last appeared in
+typedef struct
+{
+    Clause clause;
+    int *stamps;
+    int num_stamps;
+    int clause_number;
+    bool is_tautology;
+} ClauseBuilder;
+
+// Function to initialize a clause builder
+static bool init_clause_builder(ClauseBuilder *builder)
+{
+    builder->stamps = NULL;
+    builder->num_stamps = 0;
+    builder->clause_number = 0;
+    builder->is_tautology = false;
+    return init_clause(&builder->clause);
+}
+
+// Function to free a clause builder
+static void free_clause_builder(ClauseBuilder *builder)
+{
+    free_clause(&builder->clause);
+    free(builder->stamps);
+    builder->stamps = NULL;
+    builder->num_stamps = 0;
+}
+
+// Function to start collecting a new clause
+static void clause_builder_start(ClauseBuilder *builder)
+{
+    builder->clause.num_literals = 0;
+    builder->clause.is_goal = false;
+    builder->clause_number++;
+    builder->is_tautology = false;
+}
+
+// Function to add a literal to the clause being built
+static bool clause_builder_add(ClauseBuilder *builder, Literal lit)
+{
+    if ((int)(lit | 1u) >= builder->num_stamps)
+    {
+        int new_size = builder->num_stamps ? builder->num_stamps : 256;
+        while (new_size <= (int)(lit | 1u))
+            new_size *= GROWTH_FACTOR;
+        int *new_stamps = realloc(builder->stamps, new_size * sizeof(int));
+        if (!new_stamps)
+            return false;
+        memset(new_stamps + builder->num_stamps, 0, (new_size - builder->num_stamps) * sizeof(int));
+        builder->stamps = new_stamps;
+        builder->num_stamps = new_size;
+    }
+
+    if (builder->stamps[negate_literal(lit)] == builder->clause_number)
+        builder->is_tautology = true;
+    if (builder->stamps[lit] == builder->clause_number)
+        return true;
+    builder->stamps[lit] = builder->clause_number;
+    return add_literal(&builder->clause, lit);
+}
+
+// Function to move the built clause into the formula unless it is a tautology
+static bool clause_builder_finish(ClauseBuilder *builder, Formula *formula)
+{
+    if (builder->is_tautology)
+        return true;
+    if (formula->num_clauses >= formula->capacity && !reserve_clauses(formula, formula->capacity))
+        return false;
+    if (!arena_copy_clause(&formula->arena, &formula->clauses[formula->num_clauses], &builder->clause))
+        return false;
+    formula->num_clauses++;
+    return true;
+}
+
+// Function to check if a DIMACS line starting at p is a comment ("c" then blank or end)
+static bool is_dimacs_comment(const char *p, const char *end)
+{
+    return *p == 'c' && (p + 1 == end || p[1] == ' ' || p[1] == '\t' || p[1] == '\r' || p[1] == '\n');
+}
+
+// Function to skip blanks (not newlines) in a DIMACS header
+static void skip_blanks(const char **cursor, const char *end)
+{
+    while (*cursor < end && (**cursor == ' ' || **cursor == '\t' || **cursor == '\r'))
+        (*cursor)++;
+}
+
+// Function to guess the format of a file from its first meaningful line
+static FileFormat detect_format(const char *data, size_t size)
+{
+    const char *p = data, *end = data + size;
+    while (p < end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        if (p < end && *p != '\n' && *p != '#' && !is_dimacs_comment(p, end))
+        {
+            // A clause such as "p cnfx" in the name format must not pass for a header
+            if (*p++ != 'p' || p == end || (*p != ' ' && *p != '\t'))
+                return FORMAT_NAMES;
+            skip_blanks(&p, end);
+            bool is_header = end - p >= 3 && strncmp(p, "cnf", 3) == 0 &&
+                             (end - p == 3 || p[3] == ' ' || p[3] == '\t' || p[3] == '\r' || p[3] == '\n');
+            return is_header ? FORMAT_DIMACS : FORMAT_NAMES;
+        }
+        while (p < end && *p != '\n')
+            p++;
+        p++;
+    }
+    return FORMAT_NAMES;
+}
+
+// Function to parse an unsigned decimal number; returns false if there are no digits or it overflows
+static bool scan_number(const char **cursor, const char *end, int *value)
+{
+    const char *p = *cursor;
+    long long result = 0;
+    if (p >= end || *p < '0' || *p > '9')
+        return false;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        result = result * 10 + (*p++ - '0');
+        if (result > INT32_MAX)
+            return false;
+    }
+    *cursor = p;
+    *value = (int)result;
+    return true;
+}
+
+// Function to parse a DIMACS CNF file held in memory
+static bool parse_dimacs(const char *data, size_t size, Formula *formula)
+{
+    ClauseBuilder builder;
+    if (!init_clause_builder(&builder))
+    {
+        printf("Error: Out of memory while reading formula\n");
+        return false;
+    }
+
+    const char *p = data, *end = data + size;
+    int line_num = 1;
+    bool header_seen = false;
+    bool in_clause = false;
+    bool ok = true;
+
+    while (p < end && ok)
+    {
+        char c = *p;
+        if (c == '\n')
+        {
+            line_num++;
+            p++;
+        }
+        else if (c == ' ' || c == '\t' || c == '\r')
+        {
+            p++;
+        }
+        else if (c == 'c' || c == '%')
+        {
+            // Comment line; some benchmark sets end the formula with a '%' line
+            if (c == '%')
+                break;
+            while (p < end && *p != '\n')
+                p++;
+        }
+        else if (c == 'p')
+        {
+            int num_vars, num_clauses;
+            p++;
+            skip_blanks(&p, end);
+            bool valid = !header_seen && end - p >= 3 && strncmp(p, "cnf", 3) == 0;
+            if (valid)
+            {
+                p += 3;
+                skip_blanks(&p, end);
+                valid = scan_number(&p, end, &num_vars);
+                skip_blanks(&p, end);
+                valid = valid && scan_number(&p, end, &num_clauses) && num_vars <= (INT32_MAX >> 1);
+            }
+            if (!valid)
+            {
+                printf("Error: Invalid DIMACS header on line %d\n", line_num);
+                ok = false;
+                break;
+            }
+            header_seen = true;
+
+            // The header sizes every table up front, so parsing never reallocates
+            Variable *new_vars = realloc(formula->variables, (num_vars ? num_vars : 1) * sizeof(Variable));
+            ok = new_vars != NULL;
+            if (ok)
+            {
+                formula->variables = new_vars;
+                formula->var_capacity = num_vars ? num_vars : 1;
+                ok = add_numbered_variables(formula, num_vars) && reserve_clauses(formula, num_clauses);
+            }
+            if (!ok)
+                printf("Error: Out of memory while reading formula\n");
+        }
+        else if (c == '-' || (c >= '0' && c <= '9'))
+        {
+            if (!header_seen)
+            {
+                printf("Error: Clause before the \"p cnf\" header on line %d\n", line_num);
+                ok = false;
+                break;
+            }
+
+            bool is_negated = (c == '-');
+            int value;
+            if (is_negated)
+                p++;
+            if (!scan_number(&p, end, &value) || value > (INT32_MAX >> 1) ||
+                (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'))
+            {
+                printf("Error: Invalid literal on line %d\n", line_num);
+                ok = false;
+                break;
+            }
+
+            if (!in_clause)
+            {
+                clause_builder_start(&builder);
+                in_clause = true;
+            }
+            if (value == 0)
+            {
+                ok = clause_builder_finish(&builder, formula);
+                in_clause = false;
+            }
+            else
+            {
+                // Tolerate variables beyond the header count
+                ok = (value <= formula->num_variables || add_numbered_variables(formula, value)) &&
+                     clause_builder_add(&builder, make_literal(value - 1, is_negated));
+            }
+            if (!ok)
+                printf("Error: Out of memory while reading formula\n");
+        }
+        else
+        {
+            printf("Error: Unexpected character '%c' on line %d\n", c, line_num);
+            ok = false;
+        }
+    }
+
+    // Accept a last clause that is missing its terminating 0
+    if (ok && in_clause && builder.clause.num_literals > 0)
+        ok = clause_builder_finish(&builder, formula);
+    if (ok && !header_seen)
+    {
+        printf("Error: Missing \"p cnf\" header\n");
+        ok = false;
+    }
+
+    free_clause_builder(&builder);
+    return ok;
+}
+
+// Function to parse a formula in the name-based format held in memory
+// Each line is a clause of whitespace-separated literals such as "A !B C"; lines starting
+// with '#' are comments and a leading '?' marks a clause of the negated goal
+static bool parse_names(const char *data, size_t size, Formula *formula)
+{
+    ClauseBuilder builder;
+    if (!init_clause_builder(&builder))
+    {
+        printf("Error: Out of memory while reading formula\n");
+        return false;
+    }
+
+    const char *p = data, *end = data + size;
+    int line_num = 0;
+    bool ok = true;
+
+    while (p < end && ok)
+    {
+        const char *line_end = memchr(p, '\n', end - p);
+        if (!line_end)
+            line_end = end;
+        line_num++;
+
+        while (p < line_end && isspace((unsigned char)*p))
+            p++;
+
+        // Skip empty lines and comments
+        if (p == line_end || *p == '#')
+        {
+            p = line_end + 1;
+            continue;
+        }
+
+        clause_builder_start(&builder);
+        if (*p == '?')
+        {
+            builder.clause.is_goal = true;
+            p++;
+        }
+
+        while (ok)
+        {
+            while (p < line_end && isspace((unsigned char)*p))
+                p++;
+            if (p == line_end)
+                break;
+
+            const char *token = p;
+            while (p < line_end && !isspace((unsigned char)*p))
+                p++;
+
+            bool is_negated = (*token == '!');
+            if (is_negated)
+                token++;
+
+            // Long names are accepted and cut to MAX_VAR_NAME - 1 characters when interned
+            char name[MAX_VAR_NAME];
+            size_t length = (size_t)(p - token);
+            size_t kept = length < MAX_VAR_NAME - 1 ? length : MAX_VAR_NAME - 1;
+            memcpy(name, token, kept);
+            name[kept] = '\0';
+
+            bool valid = length > 0 && is_valid_variable_name(name);
+            for (size_t k = kept; k < length && valid; k++)
+                valid = isalnum((unsigned char)token[k]) || token[k] == '_';
+            if (!valid)
+            {
+                printf("Error: Invalid literal \"%.*s\" on line %d\n", (int)(p - token) + is_negated,
+                       token - is_negated, line_num);
+                ok = false;
+                break;
+            }
+
+            int var_id = find_or_add_variable(formula, name);
+            ok = var_id >= 0 && clause_builder_add(&builder, make_literal(var_id, is_negated));
+            if (!ok)
+                printf("Error: Out of memory while reading formula\n");
+        }
+
+        if (ok && builder.clause.num_literals > 0)
+        {
+            ok = clause_builder_finish(&builder, formula);
+            if (!ok)
+                printf("Error: Out of memory while reading formula\n");
+        }
+        p = line_end + 1;
+    }
+
+    free_clause_builder(&builder);
+    return ok;
+}
+
+// Function to read a formula from a file in a given format
+bool read_formula(const char *filename, FileFormat format, Formula *formula)
+{
+    MappedFile mapped;
+    if (!map_file(filename, &mapped))
+    {
+        printf("Error: Unable to open file %s\n", filename);
+        return false;
+    }
+
+    if (!init_formula(formula))
+    {
+        printf("Error: Failed to initialize formula\n");
+        unmap_file(&mapped);
+        return false;
+    }
+
+    if (format == FORMAT_AUTO)
+        format = detect_format(mapped.data, mapped.size);
+
+    bool ok = (format == FORMAT_DIMACS) ? parse_dimacs(mapped.data, mapped.size, formula)
+                                        : parse_names(mapped.data, mapped.size, formula);
+    unmap_file(&mapped);
+    if (!ok)
+        free_formula(formula);
+    return ok;
+}
+
+// Function to read a formula from a file
+bool read_formula_from_file(const char *filename, Formula *formula)
+{
+    return read_formula(filename, FORMAT_AUTO, formula);
+}
@@ -0,0 +1,1493 @@
+/*
+ * Resolution by refutation with the given-clause algorithm
+ */
+
+#include "solver_internal.h"
+
+// Function to weigh every clause the same, so the oldest is always selected
+static long long weight_none(Clause *clause)
+{
+    (void)clause;
+    return 0;
+}
+
+// Function to weigh a clause by its length
+static long long weight_length(Clause *clause)
+{
+    return clause->num_literals;
+}
+
+// Function to weigh a canonical clause by its largest variable, then its length
+static long long weight_ordered(Clause *clause)
+{
+    if (clause->num_literals == 0)
+        return 0;
+    return ((long long)literal_var(clause->literals[clause->num_literals - 1]) << 32) + clause->num_literals;
+}
+
+// Function to check if a heap entry is selected before another
+static inline bool entry_before(const QueueEntry *a, const QueueEntry *b)
+{
+    return a->weight < b->weight || (a->weight == b->weight && a->age < b->age);
+}
+
+// Function to make room for a number of entries in a heap; returns false if out of memory
+static bool heap_reserve(ClauseHeap *heap, int needed)
+{
+    if (needed <= heap->capacity)
+        return true;
+    int new_capacity = heap->capacity ? heap->capacity : INITIAL_CAPACITY;
+    while (new_capacity < needed)
+        new_capacity *= GROWTH_FACTOR;
+    QueueEntry *new_entries = realloc(heap->entries, new_capacity * sizeof(QueueEntry));
+    if (!new_entries)
+        return false;
+    heap->entries = new_entries;
+    heap->capacity = new_capacity;
+    return true;
+}
+
+// Function to add an entry to a heap; returns false if out of memory
+static bool heap_push(ClauseHeap *heap, QueueEntry entry)
+{
+    if (!heap_reserve(heap, heap->size + 1))
+        return false;
+
+    int i = heap->size++;
+    while (i > 0 && entry_before(&entry, &heap->entries[(i - 1) / 2]))
+    {
+        heap->entries[i] = heap->entries[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap->entries[i] = entry;
+    return true;
+}
+
+// Function to remove the first entry of a non-empty heap and return its clause id
+static int heap_pop(ClauseHeap *heap)
+{
+    int id = heap->entries[0].id;
+    QueueEntry last = heap->entries[--heap->size];
+    int i = 0;
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= heap->size)
+            break;
+        if (child + 1 < heap->size && entry_before(&heap->entries[child + 1], &heap->entries[child]))
+            child++;
+        if (!entry_before(&heap->entries[child], &last))
+            break;
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    if (heap->size > 0)
+        heap->entries[i] = last;
+    return id;
+}
+
+// Function to make room for a number of additional clauses in a queue, so queueing that many
+// cannot fail; returns false if out of memory
+static bool queue_reserve(ClauseQueue *queue, int count)
+{
+    // Both heaps always hold the same clauses
+    return heap_reserve(&queue->by_weight, queue->by_weight.size + count) &&
+           (queue->age_ratio == 0 || heap_reserve(&queue->by_age, queue->by_age.size + count));
+}
+
+// Function to queue a clause of the store for selection; returns false if out of memory
+static bool queue_push(ClauseQueue *queue, ClauseStore *store, int id)
+{
+    if (!queue_reserve(queue, 1))
+        return false;
+
+    Clause clause = clause_store_get(store, id);
+    QueueEntry entry = {queue->weight(&clause), queue->next_age++, id};
+    heap_push(&queue->by_weight, entry);
+    if (queue->age_ratio > 0)
+    {
+        entry.weight = 0;
+        heap_push(&queue->by_age, entry);
+    }
+    return true;
+}
+
+// Function to take the next clause to give out of the queue, or -1 if none is left
+static int queue_pop(ClauseQueue *queue, ClauseStore *store)
+{
+    ClauseHeap *heap = &queue->by_weight;
+    if (queue->age_ratio > 0 && queue->selections % queue->age_ratio == 0)
+        heap = &queue->by_age;
+
+    // The other heap still holds the clauses this one gives, to be skipped there later
+    while (heap->size > 0)
+    {
+        int id = heap_pop(heap);
+        if (!(store->flags[id] & (CLAUSE_DELETED | CLAUSE_PROCESSED)))
+        {
+            queue->selections++;
+            return id;
+        }
+    }
+    return -1;
+}
+
+// Function to free the heaps of a queue
+static void free_queue(ClauseQueue *queue)
+{
+    free(queue->by_weight.entries);
+    free(queue->by_age.entries);
+    memset(queue, 0, sizeof(*queue));
+}
+
+// Function to initialize an empty resolution working set that gives clauses in the order of
+// a selection strategy
+bool init_resolution_state(ResolutionState *state, bool use_support, ClauseSelection selection)
+{
+    memset(state, 0, sizeof(*state));
+    if (!init_clause_store(&state->store))
+        return false;
+
+    // Reusable buffers: the store copies whatever it keeps into its pool
+    if (!init_clause(&state->copy))
+    {
+        free_clause_store(&state->store);
+        return false;
+    }
+    if (!init_clause(&state->resolvant))
+    {
+        free_clause(&state->copy);
+        free_clause_store(&state->store);
+        return false;
+    }
+    state->use_support = use_support;
+    resolution_set_selection(state, selection); // Nothing queued yet: cannot fail
+    return true;
+}
+
+// Function to free a resolution working set
+void free_resolution_state(ResolutionState *state)
+{
+    free_queue(&state->queue);
+    free(state->pending.ids);
+    free_clause(&state->copy);
+    free_clause(&state->resolvant);
+    free_clause_store(&state->store);
+    memset(state, 0, sizeof(*state));
+}
+
+// Function to order the clauses waiting in a working set by another weight, lighter ones
+// first; with an age ratio, every age_ratio-th selection takes the oldest clause instead.
+// Clauses already queued keep their age. Returns false if memory runs out, in which case the
+// queue is left as it was
+bool resolution_set_weight(ResolutionState *state, ClauseWeight weight, int age_ratio)
+{
+    ClauseQueue old = state->queue;
+    ClauseQueue *queue = &state->queue;
+    memset(queue, 0, sizeof(*queue));
+    queue->weight = weight;
+    queue->age_ratio = age_ratio;
+    queue->next_age = old.next_age;
+    queue->selections = old.selections;
+
+    // The weight heap of a queue holds every queued clause
+    for (int i = 0; i < old.by_weight.size; i++)
+    {
+        QueueEntry entry = old.by_weight.entries[i];
+        if (state->store.flags[entry.id] & (CLAUSE_DELETED | CLAUSE_PROCESSED))
+            continue;
+        Clause clause = clause_store_get(&state->store, entry.id);
+        entry.weight = weight(&clause);
+        if (!heap_push(&queue->by_weight, entry))
+        {
+            free_queue(queue);
+            state->queue = old;
+            return false;
+        }
+        entry.weight = 0;
+        if (age_ratio > 0 && !heap_push(&queue->by_age, entry))
+        {
+            free_queue(queue);
+            state->queue = old;
+            return false;
+        }
+    }
+    free(old.by_weight.entries);
+    free(old.by_age.entries);
+    return true;
+}
+
+// Function to switch a working set to one of the built-in selection strategies
+// Returns false if memory runs out; the previous order is kept then
+bool resolution_set_selection(ResolutionState *state, ClauseSelection selection)
+{
+    bool ok;
+    switch (selection)
+    {
+    case SELECT_AGE_WEIGHT:
+        ok = resolution_set_weight(state, weight_length, AGE_WEIGHT_RATIO);
+        break;
+    case SELECT_FIFO:
+        ok = resolution_set_weight(state, weight_none, 0);
+        break;
+    case SELECT_ORDERED:
+        ok = resolution_set_weight(state, weight_ordered, 0);
+        break;
+    default:
+        ok = resolution_set_weight(state, weight_length, 0);
+        break;
+    }
+    if (ok)
+        state->selection = selection;
+    return ok;
+}
+
+// Function to give again the processed support clauses a new plain clause resolves with
+// A plain clause is never given itself, so without this it would only meet the support
+// clauses given after it; those given by earlier calls would miss it for good
+// Returns false on memory error
+static bool requeue_support_partners(ResolutionState *state, int id)
+{
+    ClauseStore *store = &state->store;
+    int size = clause_store_get(store, id).num_literals;
+    for (int k = 0; k < size; k++)
+    {
+        Literal complement = negate_literal(clause_store_get(store, id).literals[k]);
+        if ((int)complement >= store->num_occurrence_lists)
+            continue;
+        for (int m = 0; m < store->occurrences[complement].size; m++)
+        {
+            int partner = store->occurrences[complement].ids[m];
+            if ((store->flags[partner] & (CLAUSE_DELETED | CLAUSE_PROCESSED | CLAUSE_SUPPORT)) !=
+                (CLAUSE_PROCESSED | CLAUSE_SUPPORT))
+                continue;
+            store->flags[partner] &= (uint8_t)~CLAUSE_PROCESSED;
+            if (!queue_push(&state->queue, store, partner))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Function to add a clause to the working set in canonical form
+// It joins the unprocessed queue unless the set already has or subsumes it; with set of
+// support, clauses that do not descend from a goal clause are never selected
+// Returns false on memory error
+bool resolution_add_clause(ResolutionState *state, Clause *clause)
+{
+    ClauseStore *store = &state->store;
+    if (!assign_clause(&state->copy, clause))
+        return false;
+    if (!canonicalize_clause(&state->copy))
+        return true;
+    if (is_empty_clause(&state->copy))
+    {
+        if (!state->found_empty)
+            proof_add(state->proof, NULL, 0);
+        state->found_empty = true;
+        return true;
+    }
+
+    int id = clause_store_add_irredundant(store, &state->copy);
+    if (id == CLAUSE_ERROR || (id >= 0 && !queue_push(&state->queue, store, id)))
+        return false;
+    if (id == CLAUSE_DUPLICATE && state->use_support && state->copy.is_goal)
+    {
+        // The goal was already read as a plain clause: move that one into the support
+        int existing = clause_store_find(store, &state->copy, hash_clause(&state->copy));
+        if (!(store->flags[existing] & CLAUSE_SUPPORT))
+        {
+            store->flags[existing] = (uint8_t)((store->flags[existing] & ~CLAUSE_PROCESSED) | CLAUSE_SUPPORT);
+            if (!queue_push(&state->queue, store, existing))
+                return false;
+        }
+    }
+    if (id >= 0 && state->use_support)
+        store->flags[id] |= state->copy.is_goal ? CLAUSE_SUPPORT : CLAUSE_PROCESSED;
+    if (id >= 0 && state->use_support && !state->copy.is_goal)
+        return requeue_support_partners(state, id);
+    return true;
+}
+
+// Function to record the peak size of the working set
+static inline void note_peak(ResolutionState *state)
+{
+    COUNTER_MAX(state->peak_clauses, state->store.num_live);
+    COUNTER_MAX(state->peak_bytes, (long long)state->store.pool.size * (long long)sizeof(uint32_t));
+    (void)state; // Unused once the counters are compiled out
+}
+
+// Function to take the next clause to give, or -1 if none is left: first those cut short
+// by an earlier saturation, then the lightest clause of the queue
+static int select_given(ResolutionState *state)
+{
+    ClauseStore *store = &state->store;
+    while (state->pending.size > 0)
+    {
+        int id = state->pending.ids[--state->pending.size];
+        if (!(store->flags[id] & (CLAUSE_DELETED | CLAUSE_PROCESSED)))
+            return id;
+    }
+    return queue_pop(&state->queue, store);
+}
+
+// Function to check the budget once a resolvent was kept
+// A part of a component saturation first adds what it changed since its last check to the
+// totals it shares with the working set and the other parts, then checks those; each of the
+// other threads may keep one more resolvent before it sees the limit
+static StopReason check_kept_budget(ResolutionState *state, long max_resolvents)
+{
+    ClauseStore *store = &state->store;
+    SharedBudget *shared = state->shared;
+    if (!shared)
+    {
+        if (state->kept == max_resolvents)
+            return STOP_RESOLVENTS;
+        return budget_check_clauses(&state->budget, store->num_live, &store->pool);
+    }
+
+    int64_t bytes = (int64_t)store->pool.size * (int64_t)sizeof(uint32_t);
+    int64_t kept = atomic_add(&shared->kept, 1);
+    int64_t total_clauses = atomic_add(&shared->clauses, store->num_live - state->shared_clauses);
+    int64_t total_bytes = atomic_add(&shared->bytes, bytes - state->shared_bytes);
+    state->shared_clauses = store->num_live;
+    state->shared_bytes = bytes;
+    if (max_resolvents >= 0 && kept >= max_resolvents)
+        return STOP_RESOLVENTS;
+    return budget_check_size(&state->budget, total_clauses, (size_t)total_bytes);
+}
+
+// Function to run the given-clause loop on one thread
+// Uses the given-clause algorithm: clauses wait in a queue ordered by the selection strategy;
+// each selected (given) clause is resolved against the processed clauses only and then joins
+// them, so every pair of clauses is resolved exactly once, however many clauses are added
+// between calls and in whatever order they are selected (with set of support, a support
+// clause given again for a plain clause added later resolves its other pairs twice)
+static void saturate_sequential(ResolutionState *state, double deadline, long max_resolvents)
+{
+    ClauseStore *store = &state->store;
+    Clause *resolvant = &state->resolvant;
+
+    while (!state->found_empty && !state->stopped)
+    {
+        // Make sure the given clause can be put back if it is cut short
+        if (!id_list_reserve(&state->pending, state->pending.size + 1))
+        {
+            state->stopped = STOP_MEMORY;
+            break;
+        }
+        int given = select_given(state);
+        if (given < 0)
+            break;
+
+        // The clock and the cancel flag are read once per given clause
+        state->stopped = budget_check_clock(deadline, state->cancel);
+        if (state->stopped)
+        {
+            id_list_push(&state->pending, given);
+            break;
+        }
+        state->given++;
+
+        // Partners for a literal are the processed clauses containing its complement
+        int given_size = clause_store_get(store, given).num_literals;
+        for (int k = 0; k < given_size && !state->found_empty && !state->stopped; k++)
+        {
+            // The pool may move while resolvents are added, so views are taken afresh
+            Literal lit = clause_store_get(store, given).literals[k];
+            Literal complement = negate_literal(lit);
+            if ((int)complement >= store->num_occurrence_lists)
+                continue;
+
+            // The list may grow or move while resolvents are added, so always index through the store
+            for (int m = 0; m < store->occurrences[complement].size; m++)
+            {
+                // A resolvent may subsume and delete the given clause itself
+                if (store->flags[given] & CLAUSE_DELETED)
+                    break;
+
+                int partner = store->occurrences[complement].ids[m];
+                if ((store->flags[partner] & (CLAUSE_DELETED | CLAUSE_PROCESSED)) != CLAUSE_PROCESSED)
+                    continue;
+
+                COUNTER_ADD(state->pairs, 1);
+                if (!clause_store_resolve(store, given, partner, lit, resolvant))
+                {
+                    if (resolvant->num_literals < 0)
+                    {
+                        // Out of memory: stop saturating with what we have
+                        state->stopped = STOP_MEMORY;
+                        break;
+                    }
+                    COUNTER_ADD(state->tautologies, 1);
+                    continue;
+                }
+                COUNTER_ADD(state->resolvents, 1);
+
+                if (is_empty_clause(resolvant))
+                {
+                    proof_add(state->proof, NULL, 0);
+                    state->found_empty = true;
+                    break;
+                }
+
+                // Keep the resolvent only if no clause in the store already has or subsumes it;
+                // only kept ones count towards the budget, so the pairs a cut short given
+                // clause resolves again next time cost nothing and every call gets further
+                int id = clause_store_add_irredundant(store, resolvant);
+                if (id < 0)
+                    continue;
+                state->kept++;
+                proof_add(state->proof, resolvant->literals, resolvant->num_literals);
+                if (state->use_support)
+                    store->flags[id] |= CLAUSE_SUPPORT;
+                if (!queue_push(&state->queue, store, id))
+                {
+                    // Out of memory: stop saturating with what we have
+                    state->stopped = STOP_MEMORY;
+                    break;
+                }
+                note_peak(state);
+                state->stopped = check_kept_budget(state, max_resolvents);
+                if (state->stopped)
+                    break;
+            }
+        }
+
+        // A given clause cut short by a budget or a memory error is selected again by the
+        // next call
+        if (state->stopped && !state->found_empty)
+        {
+            id_list_push(&state->pending, given);
+            break;
+        }
+        if (!(store->flags[given] & CLAUSE_DELETED))
+            store->flags[given] |= CLAUSE_PROCESSED;
+
+        // Once subsumption has deleted enough clauses, squeeze them out of the scans;
+        // if memory is short the store is left as it was
+        if (pool_needs_compaction(&store->pool))
+            clause_store_compact(store);
+    }
+}
+
+// Parallel saturation works in rounds. A round takes the next RESOLUTION_ROUND_SIZE given
+// clauses, resolves each against the processed clauses and the givens before it in the round
+// (the pairs the sequential loop would resolve), then merges all new clauses into the store.
+// The pairs are cut into tasks of at most RESOLUTION_BLOCK_SIZE partners, which the threads
+// take in order from a shared counter. During a round the store is only read, so each task can
+// already drop resolvents the store has or subsumes; the survivors are kept in the task's own
+// buffer and merged in task order, which makes the result the same for any number of threads.
+// Budgets are checked before each task, counting the resolvents the round has kept so far:
+// once one is exhausted no more task is handed out, only the tasks taken are merged, and the
+// givens whose pairs were not all resolved are selected again by the next round or call.
+#define RESOLUTION_ROUND_SIZE 64
+#define RESOLUTION_BLOCK_SIZE 256
+
+// Structure to represent a block of pairs: a given clause and a range of the partners
+// containing the complement of one of its literals, plus what resolving them produced
+typedef struct
+{
+    int given;
+    int rank; // Position of the given clause in its round
+    Literal lit;
+    int first, last; // Range of the occurrence list of the complement of lit
+
+    Literal *buffer; // Kept resolvents, each preceded by its number of literals
+    int buffer_size;
+    int buffer_capacity;
+    long pairs;
+    long resolvents;
+    long tautologies;
+    long duplicates;
+    long forward_subsumed;
+    long kept;
+    bool found_empty;
+    bool out_of_memory;
+} ResolutionTask;
+
+// Structure to represent the worker threads of a parallel saturation and the current round
+typedef struct
+{
+    ResolutionState *state;
+    ResolutionTask *tasks;
+    int num_tasks;
+    int tasks_capacity;
+    int *round_rank; // Position in the round of each clause id, or -1
+    int round_rank_capacity;
+    double deadline;
+    long max_resolvents;   // Of state->kept, or -1
+    int64_t round_kept;    // Resolvents kept by the tasks of the round that ran
+    int64_t round_literals; // And their literals
+
+    Mutex lock; // Guards the fields below
+    Condition round_started;
+    Condition round_finished;
+    int next_task;
+    int end_task; // Tasks handed out in the round stop there; lowered when a budget runs out
+    int round;    // Incremented when the tasks of a new round are ready
+    int num_workers;
+    int finished_workers; // Workers done with the current round
+    bool stop;
+    double worker_seconds; // Time spent in tasks, summed over the threads
+} ResolutionPool;
+
+// Structure to represent the private state of one thread of a pool
+typedef struct
+{
+    ResolutionPool *pool;
+    Thread thread;
+    Clause resolvant;
+} ResolutionWorker;
+
+// Function to append a resolvent to the buffer of a task
+static bool task_keep_resolvent(ResolutionTask *task, Clause *clause)
+{
+    int needed = task->buffer_size + 1 + clause->num_literals;
+    if (needed > task->buffer_capacity)
+    {
+        int new_capacity = task->buffer_capacity ? task->buffer_capacity : INITIAL_CAPACITY;
+        while (new_capacity < needed)
+            new_capacity *= GROWTH_FACTOR;
+        Literal *new_buffer = realloc(task->buffer, new_capacity * sizeof(Literal));
+        if (!new_buffer)
+            return false;
+        task->buffer = new_buffer;
+        task->buffer_capacity = new_capacity;
+    }
+    task->buffer[task->buffer_size++] = (Literal)clause->num_literals;
+    memcpy(task->buffer + task->buffer_size, clause->literals, clause->num_literals * sizeof(Literal));
+    task->buffer_size += clause->num_literals;
+    return true;
+}
+
+// Function to resolve the pairs of one task against the unchanging store
+static void run_task(ResolutionPool *pool, ResolutionTask *task, Clause *resolvant)
+{
+    ClauseStore *store = &pool->state->store;
+    IdList *partners = &store->occurrences[negate_literal(task->lit)];
+
+    for (int m = task->first; m < task->last && !task->found_empty; m++)
+    {
+        int partner = partners->ids[m];
+        if (store->flags[partner] & CLAUSE_DELETED)
+            continue;
+        int rank = partner < pool->round_rank_capacity ? pool->round_rank[partner] : -1;
+        if (!(store->flags[partner] & CLAUSE_PROCESSED) && (rank < 0 || rank >= task->rank))
+            continue;
+
+        COUNTER_ADD(task->pairs, 1);
+        if (!clause_store_resolve(store, task->given, partner, task->lit, resolvant))
+        {
+            if (resolvant->num_literals < 0)
+            {
+                task->out_of_memory = true;
+                return;
+            }
+            COUNTER_ADD(task->tautologies, 1);
+            continue;
+        }
+        COUNTER_ADD(task->resolvents, 1);
+
+        if (is_empty_clause(resolvant))
+        {
+            task->found_empty = true;
+            return;
+        }
+        if (clause_store_find(store, resolvant, hash_clause(resolvant)) != -1)
+        {
+            COUNTER_ADD(task->duplicates, 1);
+            continue;
+        }
+        if (clause_store_is_subsumed(store, resolvant, clause_signature(resolvant)))
+        {
+            COUNTER_ADD(task->forward_subsumed, 1);
+            continue;
+        }
+        if (!task_keep_resolvent(task, resolvant))
+        {
+            task->out_of_memory = true;
+            return;
+        }
+        task->kept++;
+    }
+}
+
+// Function to tell whether a budget ran out, counting the resolvents kept by the tasks of the
+// round as if they were already in the store; they may still turn out duplicates there
+static bool round_budget_exhausted(ResolutionPool *pool)
+{
+    ResolutionState *state = pool->state;
+    int64_t round_kept = atomic_add(&pool->round_kept, 0);
+    int64_t round_literals = atomic_add(&pool->round_literals, 0);
+    if (budget_check_clock(pool->deadline, state->cancel))
+        return true;
+    if (pool->max_resolvents >= 0 && state->kept + round_kept >= pool->max_resolvents)
+        return true;
+    return budget_check_size(&state->budget, state->store.num_live + round_kept,
+                             (size_t)(state->store.pool.size + round_literals) * sizeof(uint32_t)) != STOP_NONE;
+}
+
+// Function to run tasks of the current round until none is left
+static void run_tasks(ResolutionPool *pool, Clause *resolvant)
+{
+    double start = now_seconds();
+    for (;;)
+    {
+        bool exhausted = round_budget_exhausted(pool);
+        mutex_lock(&pool->lock);
+        if (exhausted && pool->end_task > pool->next_task)
+            pool->end_task = pool->next_task;
+        int index = pool->next_task < pool->end_task ? pool->next_task++ : -1;
+        mutex_unlock(&pool->lock);
+        if (index < 0)
+            break;
+        ResolutionTask *task = &pool->tasks[index];
+        run_task(pool, task, resolvant);
+        atomic_add(&pool->round_kept, task->kept);
+        atomic_add(&pool->round_literals, task->buffer_size - task->kept);
+    }
+    double elapsed = now_seconds() - start;
+
+    mutex_lock(&pool->lock);
+    pool->worker_seconds += elapsed;
+    mutex_unlock(&pool->lock);
+}
+
+// Function run by each worker thread: take part in every round until the pool stops
+static THREAD_FUNCTION resolution_worker(void *arg)
+{
+    ResolutionWorker *worker = arg;
+    ResolutionPool *pool = worker->pool;
+    int seen_round = 0;
+    for (;;)
+    {
+        mutex_lock(&pool->lock);
+        while (pool->round == seen_round && !pool->stop)
+            condition_wait(&pool->round_started, &pool->lock);
+        if (pool->stop)
+        {
+            mutex_unlock(&pool->lock);
+            break;
+        }
+        seen_round = pool->round;
+        mutex_unlock(&pool->lock);
+
+        run_tasks(pool, &worker->resolvant);
+
+        mutex_lock(&pool->lock);
+        pool->finished_workers++;
+        if (pool->finished_workers == pool->num_workers)
+            condition_broadcast(&pool->round_finished);
+        mutex_unlock(&pool->lock);
+    }
+    return THREAD_RESULT;
+}
+
+// Function to append an empty task to the round of a pool; returns NULL if out of memory
+static ResolutionTask *pool_add_task(ResolutionPool *pool)
+{
+    if (pool->num_tasks >= pool->tasks_capacity)
+    {
+        int new_capacity = pool->tasks_capacity ? pool->tasks_capacity * GROWTH_FACTOR : INITIAL_CAPACITY;
+        ResolutionTask *new_tasks = realloc(pool->tasks, new_capacity * sizeof(ResolutionTask));
+        if (!new_tasks)
+            return NULL;
+        memset(new_tasks + pool->tasks_capacity, 0, (new_capacity - pool->tasks_capacity) * sizeof(ResolutionTask));
+        pool->tasks = new_tasks;
+        pool->tasks_capacity = new_capacity;
+    }
+
+    // Buffers are reused from round to round
+    ResolutionTask *task = &pool->tasks[pool->num_tasks++];
+    Literal *buffer = task->buffer;
+    int buffer_capacity = task->buffer_capacity;
+    memset(task, 0, sizeof(*task));
+    task->buffer = buffer;
+    task->buffer_capacity = buffer_capacity;
+    return task;
+}
+
+// Function to put the given clauses of a round back, to be selected first by the next call
+// Room for them is reserved by plan_round
+static void put_back_givens(ResolutionState *state, const int *round_ids, int count)
+{
+    for (int r = count - 1; r >= 0; r--)
+        state->pending.ids[state->pending.size++] = round_ids[r];
+}
+
+// Function to pick the given clauses of the next round and cut their pairs into tasks
+// Returns the number of given clauses, or -1 if out of memory
+static int plan_round(ResolutionPool *pool, int *round_ids)
+{
+    ResolutionState *state = pool->state;
+    ClauseStore *store = &state->store;
+
+    if (pool->round_rank_capacity < store->num_clauses)
+    {
+        int new_capacity = store->capacity;
+        int *new_rank = realloc(pool->round_rank, new_capacity * sizeof(int));
+        if (!new_rank)
+            return -1;
+        for (int i = pool->round_rank_capacity; i < new_capacity; i++)
+            new_rank[i] = -1;
+        pool->round_rank = new_rank;
+        pool->round_rank_capacity = new_capacity;
+    }
+
+    // Make sure the givens can be put back if the round cannot be completed
+    if (!id_list_reserve(&state->pending, state->pending.size + RESOLUTION_ROUND_SIZE))
+        return -1;
+    int count = 0;
+    while (count < RESOLUTION_ROUND_SIZE)
+    {
+        int id = select_given(state);
+        if (id < 0)
+            break;
+        if (pool->round_rank[id] >= 0)
+            continue; // Queued twice
+        pool->round_rank[id] = count;
+        round_ids[count++] = id;
+    }
+
+    pool->num_tasks = 0;
+    for (int r = 0; r < count; r++)
+    {
+        Clause given = clause_store_get(store, round_ids[r]);
+        for (int k = 0; k < given.num_literals; k++)
+        {
+            Literal complement = negate_literal(given.literals[k]);
+            if ((int)complement >= store->num_occurrence_lists)
+                continue;
+            int size = store->occurrences[complement].size;
+            for (int first = 0; first < size; first += RESOLUTION_BLOCK_SIZE)
+            {
+                ResolutionTask *task = pool_add_task(pool);
+                if (!task)
+                {
+                    for (int i = 0; i < count; i++)
+                        pool->round_rank[round_ids[i]] = -1;
+                    put_back_givens(state, round_ids, count);
+                    return -1;
+                }
+                task->given = round_ids[r];
+                task->rank = r;
+                task->lit = given.literals[k];
+                task->first = first;
+                task->last = first + RESOLUTION_BLOCK_SIZE < size ? first + RESOLUTION_BLOCK_SIZE : size;
+            }
+        }
+    }
+    return count;
+}
+
+// Function to merge the resolvents of the tasks of a round that ran into the store, in task
+// order; once the resolvent budget is reached, the tasks after the current one are left out
+// Returns false if memory ran out
+static bool merge_round(ResolutionPool *pool)
+{
+    ResolutionState *state = pool->state;
+    ClauseStore *store = &state->store;
+    for (int t = 0; t < pool->end_task; t++)
+    {
+        ResolutionTask *task = &pool->tasks[t];
+        COUNTER_ADD(state->pairs, task->pairs);
+        COUNTER_ADD(state->resolvents, task->resolvents);
+        COUNTER_ADD(state->tautologies, task->tautologies);
+        COUNTER_ADD(store->num_duplicates, task->duplicates);
+        COUNTER_ADD(store->num_forward_subsumed, task->forward_subsumed);
+        if (task->out_of_memory)
+            return false;
+
+        for (int i = 0; i < task->buffer_size; i += 1 + (int)task->buffer[i])
+        {
+            Clause resolvent = {task->buffer + i + 1, (int)task->buffer[i], 0, false};
+            int id = clause_store_add_irredundant(store, &resolvent);
+            if (id == CLAUSE_ERROR)
+                return false;
+            if (id < 0)
+                continue;
+            state->kept++;
+            proof_add(state->proof, resolvent.literals, resolvent.num_literals);
+            if (state->use_support)
+                store->flags[id] |= CLAUSE_SUPPORT;
+            if (!queue_push(&state->queue, store, id))
+                return false;
+        }
+
+        // The sequential loop stops at the first empty resolvent as well
+        if (task->found_empty)
+        {
+            proof_add(state->proof, NULL, 0);
+            state->found_empty = true;
+            return true;
+        }
+        if (pool->max_resolvents >= 0 && state->kept >= pool->max_resolvents)
+            pool->end_task = t + 1;
+    }
+    return true;
+}
+
+// Function to count the givens of a round whose pairs were all resolved: those before the
+// given of the first task that did not run, since tasks follow the order of their givens
+static int completed_givens(ResolutionPool *pool, int count)
+{
+    return pool->end_task < pool->num_tasks ? pool->tasks[pool->end_task].rank : count;
+}
+
+// Function to run the given-clause loop in parallel rounds on a number of threads
+// Returns false if the threads could not be set up (the caller falls back to one thread)
+static bool saturate_parallel(ResolutionState *state, int num_threads, double deadline, long max_resolvents,
+                              ResolutionStats *stats)
+{
+    ResolutionPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.state = state;
+
+    ResolutionWorker *workers = calloc(num_threads, sizeof(ResolutionWorker));
+    Clause resolvant;
+    int *round_ids = malloc(RESOLUTION_ROUND_SIZE * sizeof(int));
+    if (!workers || !round_ids || !init_clause(&resolvant))
+    {
+        free(workers);
+        free(round_ids);
+        return false;
+    }
+    pool.deadline = deadline;
+    pool.max_resolvents = max_resolvents;
+    mutex_init(&pool.lock);
+    condition_init(&pool.round_started);
+    condition_init(&pool.round_finished);
+
+    // The calling thread works too: start num_threads - 1 workers
+    for (int i = 0; i < num_threads - 1; i++)
+    {
+        workers[i].pool = &pool;
+        if (!init_clause(&workers[i].resolvant))
+            break;
+        if (!thread_start(&workers[i].thread, resolution_worker, &workers[i]))
+        {
+            free_clause(&workers[i].resolvant);
+            break;
+        }
+        pool.num_workers++;
+    }
+
+    double parallel_seconds = 0.0;
+    long rounds = 0;
+    while (!state->found_empty)
+    {
+        // Budgets are checked between rounds, and by the threads before each task
+        state->stopped = budget_check_clock(deadline, state->cancel);
+        if (!state->stopped && max_resolvents >= 0 && state->kept >= max_resolvents)
+            state->stopped = STOP_RESOLVENTS;
+        if (!state->stopped)
+            state->stopped = budget_check_clauses(&state->budget, state->store.num_live, &state->store.pool);
+        if (state->stopped)
+            break;
+
+        int count = plan_round(&pool, round_ids);
+        if (count <= 0)
+        {
+            if (count < 0)
+                state->stopped = STOP_MEMORY;
+            break;
+        }
+        rounds++;
+
+        double start = now_seconds();
+        mutex_lock(&pool.lock);
+        pool.next_task = 0;
+        pool.end_task = pool.num_tasks;
+        pool.round_kept = 0;
+        pool.round_literals = 0;
+        pool.finished_workers = 0;
+        pool.round++;
+        condition_broadcast(&pool.round_started);
+        mutex_unlock(&pool.lock);
+
+        run_tasks(&pool, &resolvant);
+
+        mutex_lock(&pool.lock);
+        while (pool.finished_workers < pool.num_workers)
+            condition_wait(&pool.round_finished, &pool.lock);
+        mutex_unlock(&pool.lock);
+        parallel_seconds += now_seconds() - start;
+
+        bool merged = merge_round(&pool);
+        int completed = completed_givens(&pool, count);
+        for (int r = 0; r < count; r++)
+        {
+            int id = round_ids[r];
+            pool.round_rank[id] = -1;
+            if (merged && r < completed && !state->found_empty && !(state->store.flags[id] & CLAUSE_DELETED))
+                state->store.flags[id] |= CLAUSE_PROCESSED;
+        }
+        if (!merged)
+        {
+            // Out of memory: the givens of this round are selected again by the next call
+            put_back_givens(state, round_ids, count);
+            state->stopped = STOP_MEMORY;
+            break;
+        }
+
+        // Givens of a round cut short by a budget are selected again; the pairs they already
+        // resolved give duplicates then
+        put_back_givens(state, round_ids + completed, count - completed);
+        state->given += completed;
+        note_peak(state);
+
+        if (pool_needs_compaction(&state->store.pool))
+            clause_store_compact(&state->store);
+    }
+
+    mutex_lock(&pool.lock);
+    pool.stop = true;
+    condition_broadcast(&pool.round_started);
+    mutex_unlock(&pool.lock);
+    for (int i = 0; i < pool.num_workers; i++)
+    {
+        thread_join(workers[i].thread);
+        free_clause(&workers[i].resolvant);
+    }
+
+    if (stats)
+    {
+        stats->threads = pool.num_workers + 1;
+        stats->rounds = rounds;
+        stats->parallel_seconds = parallel_seconds;
+        stats->worker_seconds = pool.worker_seconds;
+    }
+
+    for (int t = 0; t < pool.tasks_capacity; t++)
+        free(pool.tasks[t].buffer);
+    free(pool.tasks);
+    free(pool.round_rank);
+    condition_destroy(&pool.round_started);
+    condition_destroy(&pool.round_finished);
+    mutex_destroy(&pool.lock);
+    free_clause(&resolvant);
+    free(round_ids);
+    free(workers);
+    return true;
+}
+
+// Clauses of variable-disjoint components never resolve against each other, so with several
+// threads a working set whose unprocessed clauses lie in several components is saturated one
+// component per thread: each component with unprocessed clauses is copied into a working set
+// of its own and saturated by the sequential loop, then its clauses replace the originals.
+// The threads take the largest components first. The first component to derive the empty
+// clause answers for the whole set and cancels the others. Components without unprocessed
+// clauses are already saturated and are left in place. On one thread nothing is gained: the
+// given-clause loop never pairs clauses of different components, and it interleaves them,
+// so an unsatisfiable component is not held up behind a hard satisfiable one.
+
+// Structure to represent a component saturated in a working set of its own
+typedef struct
+{
+    ResolutionState state;
+    int component; // Number from clause_store_components
+    int size;      // Live clauses it was copied with
+    double seconds;
+} ComponentPart;
+
+// Structure to represent the components of a saturation and the threads taking them
+typedef struct
+{
+    ComponentPart *parts; // Largest first
+    int num_parts;
+    int next;           // Next part to take
+    Mutex lock;         // Guards next
+    CancelFlag *cancel; // Raised by the first part that derives the empty clause
+    double deadline;
+    long max_resolvents; // Of all parts together, counted in budget.kept
+    SharedBudget budget;
+} ComponentPool;
+
+// Function to order parts by size, largest first, then by component
+static int compare_parts(const void *a, const void *b)
+{
+    const ComponentPart *x = a;
+    const ComponentPart *y = b;
+    if (x->size != y->size)
+        return x->size > y->size ? -1 : 1;
+    return x->component < y->component ? -1 : x->component > y->component;
+}
+
+// Function to saturate one part, unless another one already answered or the parts before it
+// used up the resolvent budget
+static void saturate_part(ComponentPool *pool, ComponentPart *part)
+{
+    double start = now_seconds();
+    if (pool->max_resolvents >= 0 && atomic_add(&pool->budget.kept, 0) >= pool->max_resolvents)
+        part->state.stopped = STOP_RESOLVENTS;
+    else
+        saturate_sequential(&part->state, pool->deadline, pool->max_resolvents);
+    if (part->state.found_empty)
+        cancel_flag_raise(pool->cancel);
+    part->seconds = now_seconds() - start;
+}
+
+// Function run by each thread of a component pool: saturate parts until none is left
+static THREAD_FUNCTION component_worker(void *arg)
+{
+    ComponentPool *pool = arg;
+    for (;;)
+    {
+        mutex_lock(&pool->lock);
+        int index = pool->next++;
+        mutex_unlock(&pool->lock);
+        if (index >= pool->num_parts)
+            break;
+        saturate_part(pool, &pool->parts[index]);
+    }
+    return THREAD_RESULT;
+}
+
+// Function to copy the clauses of each component with a part into that part
+// Returns false if out of memory
+static bool fill_parts(ResolutionState *state, const int *component, const int *part_of, ComponentPart *parts)
+{
+    ClauseStore *store = &state->store;
+    for (int id = 0; id < store->num_clauses; id++)
+    {
+        if (component[id] < 0 || part_of[component[id]] < 0)
+            continue;
+        ResolutionState *part = &parts[part_of[component[id]]].state;
+        Clause clause = clause_store_get(store, id);
+        int copy = clause_store_add(&part->store, &clause);
+        if (copy < 0)
+            return false;
+        part->store.flags[copy] |= store->flags[id] & (CLAUSE_PROCESSED | CLAUSE_SUPPORT);
+        if (!(store->flags[id] & CLAUSE_PROCESSED) && !queue_push(&part->queue, &part->store, copy))
+            return false;
+    }
+    return true;
+}
+
+// Function to put the clauses of a saturated part in place of the originals of its component
+// New clauses are added (and queued, in case memory runs out half way) before anything is
+// removed, so a failure leaves every original clause and every added one live and waiting:
+// the pairs are then resolved again, but nothing is lost. Returns false if out of memory
+static bool merge_part(ResolutionState *state, ComponentPart *part, int *component, int num_originals)
+{
+    ClauseStore *store = &state->store;
+    ClauseStore *from = &part->state.store;
+    int *target = malloc((from->num_clauses > 0 ? from->num_clauses : 1) * sizeof(int));
+    if (!target || !queue_reserve(&state->queue, from->num_live))
+    {
+        free(target);
+        return false;
+    }
+
+    for (int id = 0; id < from->num_clauses; id++)
+    {
+        if (from->flags[id] & CLAUSE_DELETED)
+            continue;
+        // A live clause of the part is never one the store deleted earlier: that one was
+        // subsumed by a clause of the same component, which the part still has or subsumes
+        Clause clause = clause_store_get(from, id);
+        target[id] = clause_store_find(store, &clause, from->hashes[id]);
+        if (target[id] >= 0)
+            continue;
+        target[id] = clause_store_add(store, &clause);
+        if (target[id] < 0)
+        {
+            free(target);
+            return false;
+        }
+        store->flags[target[id]] |= from->flags[id] & CLAUSE_SUPPORT;
+        queue_push(&state->queue, store, target[id]); // Reserved above
+    }
+
+    // Nothing can fail from here: take over the flags of the part, keep the originals it
+    // still has and delete the others, which it subsumes
+    for (int id = 0; id < from->num_clauses; id++)
+    {
+        if (from->flags[id] & CLAUSE_DELETED)
+            continue;
+        int kept = target[id];
+        store->flags[kept] = (uint8_t)((store->flags[kept] & ~(CLAUSE_PROCESSED | CLAUSE_SUPPORT)) |
+                                       (from->flags[id] & (CLAUSE_PROCESSED | CLAUSE_SUPPORT)));
+        if (kept < num_originals)
+            component[kept] = -1;
+    }
+    for (int id = 0; id < num_originals; id++)
+    {
+        if (component[id] == part->component)
+            clause_store_delete(store, id);
+    }
+    free(target);
+    return true;
+}
+
+// Function to saturate the components of a working set on separate threads when more than
+// one of them has unprocessed clauses; counters of the parts are added to the working set
+// Returns false, with the working set as it was, on one thread, when a proof is logged (only
+// one thread may write it), when fewer components have unprocessed clauses or when memory
+// runs out before they could be set up
+static bool saturate_components(ResolutionState *state, int num_threads, double deadline, ResolutionStats *stats)
+{
+    ClauseStore *store = &state->store;
+    int num_originals = store->num_clauses;
+    if (num_threads <= 1 || state->proof || state->found_empty || store->num_live < 2)
+        return false;
+
+    int *component = malloc(num_originals * sizeof(int));
+    int num_components = component ? clause_store_components(store, component) : -1;
+    int *part_of = num_components > 1 ? malloc(num_components * sizeof(int)) : NULL;
+    int *sizes = num_components > 1 ? calloc(num_components, sizeof(int)) : NULL;
+    if (!part_of || !sizes)
+    {
+        free(component);
+        free(part_of);
+        free(sizes);
+        return false;
+    }
+
+    // Components with unprocessed clauses get a part
+    for (int c = 0; c < num_components; c++)
+    {
+        part_of[c] = -1;
+    }
+    int num_parts = 0;
+    for (int id = 0; id < num_originals; id++)
+    {
+        int c = component[id];
+        if (c < 0)
+            continue;
+        sizes[c]++;
+        if (!(store->flags[id] & CLAUSE_PROCESSED) && part_of[c] < 0)
+            part_of[c] = num_parts++;
+    }
+    ComponentPart *parts = num_parts > 1 ? calloc(num_parts, sizeof(ComponentPart)) : NULL;
+    if (!parts)
+    {
+        free(component);
+        free(part_of);
+        free(sizes);
+        return false;
+    }
+    for (int c = 0; c < num_components; c++)
+    {
+        if (part_of[c] >= 0)
+        {
+            parts[part_of[c]].component = c;
+            parts[part_of[c]].size = sizes[c];
+        }
+    }
+    qsort(parts, num_parts, sizeof(ComponentPart), compare_parts);
+    for (int p = 0; p < num_parts; p++)
+    {
+        part_of[parts[p].component] = p;
+    }
+
+    // Each part resolves like the working set would, in the same order and with the same
+    // cancel flag; the budget applies to all of them together, working set included
+    CancelFlag own_cancel = {0};
+    ComponentPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.parts = parts;
+    pool.num_parts = num_parts;
+    pool.cancel = state->cancel ? state->cancel : &own_cancel;
+    pool.deadline = deadline;
+    pool.max_resolvents = state->budget.resolvents > 0 ? state->budget.resolvents : -1;
+    bool ok = true;
+    int ready = 0;
+    while (ok && ready < num_parts)
+    {
+        ResolutionState *part = &parts[ready].state;
+        if (!init_resolution_state(part, state->use_support, state->selection))
+            break;
+        ready++;
+        ok = resolution_set_weight(part, state->queue.weight, state->queue.age_ratio);
+        part->budget = state->budget;
+        part->cancel = pool.cancel;
+        part->shared = &pool.budget;
+    }
+    if (ok && ready == num_parts)
+        ok = fill_parts(state, component, part_of, parts);
+
+    // The copies hold every clause a second time: without room for that in the budget, the
+    // working set is saturated as a whole instead
+    pool.budget.clauses = store->num_live;
+    pool.budget.bytes = (int64_t)store->pool.size * (int64_t)sizeof(uint32_t);
+    for (int p = 0; ok && p < ready; p++)
+    {
+        ResolutionState *part = &parts[p].state;
+        part->shared_clauses = part->store.num_live;
+        part->shared_bytes = (int64_t)part->store.pool.size * (int64_t)sizeof(uint32_t);
+        pool.budget.clauses += part->shared_clauses;
+        pool.budget.bytes += part->shared_bytes;
+    }
+    if (ok && budget_check_size(&state->budget, pool.budget.clauses, (size_t)pool.budget.bytes))
+        ok = false;
+    if (!ok || ready < num_parts)
+    {
+        for (int p = 0; p < ready; p++)
+        {
+            free_resolution_state(&parts[p].state);
+        }
+        free(parts);
+        free(component);
+        free(part_of);
+        free(sizes);
+        return false;
+    }
+
+    // The calling thread works too; without other threads it takes every part itself
+    int threads = num_threads < num_parts ? num_threads : num_parts;
+    Thread *workers = calloc(threads - 1, sizeof(Thread));
+    int num_workers = 0;
+    double start = now_seconds();
+    mutex_init(&pool.lock);
+    for (int i = 0; workers && i < threads - 1; i++)
+    {
+        if (!thread_start(&workers[num_workers], component_worker, &pool))
+            break;
+        num_workers++;
+    }
+    component_worker(&pool);
+    for (int i = 0; i < num_workers; i++)
+    {
+        thread_join(workers[i]);
+    }
+    mutex_destroy(&pool.lock);
+    free(workers);
+    double seconds = now_seconds() - start;
+
+    // Gather the counters of every part, then merge them back in order, whatever order they
+    // finished in
+    double part_seconds = 0.0;
+    int peak_clauses = 0;
+    long long peak_bytes = 0;
+    for (int p = 0; p < num_parts; p++)
+    {
+        ResolutionState *part = &parts[p].state;
+        state->given += part->given;
+        state->pairs += part->pairs;
+        COUNTER_ADD(state->resolvents, part->resolvents);
+        COUNTER_ADD(state->tautologies, part->tautologies);
+        state->kept += part->kept;
+        COUNTER_ADD(store->num_duplicates, part->store.num_duplicates);
+        COUNTER_ADD(store->num_forward_subsumed, part->store.num_forward_subsumed);
+        COUNTER_ADD(store->num_backward_subsumed, part->store.num_backward_subsumed);
+        peak_clauses += part->peak_clauses;
+        peak_bytes += part->peak_bytes;
+        part_seconds += parts[p].seconds;
+        if (part->found_empty)
+            state->found_empty = true;
+        else if (part->stopped && !state->stopped)
+            state->stopped = part->stopped;
+    }
+    // The working set is left as it was until the parts are merged, and the copies hold every
+    // clause a second time at their peak
+    COUNTER_MAX(state->peak_clauses, store->num_live + peak_clauses);
+    COUNTER_MAX(state->peak_bytes, (long long)store->pool.size * (long long)sizeof(uint32_t) + peak_bytes);
+    if (state->found_empty)
+    {
+        // Unsatisfiable whatever the other parts did, and the working set stays so
+        state->stopped = STOP_NONE;
+    }
+    else
+    {
+        if (cancel_flag_is_raised(state->cancel))
+            state->stopped = STOP_CANCELLED;
+        for (int p = 0; p < num_parts; p++)
+        {
+            if (!merge_part(state, &parts[p], component, num_originals))
+            {
+                state->stopped = STOP_MEMORY;
+                break;
+            }
+        }
+        if (pool_needs_compaction(&store->pool))
+            clause_store_compact(store);
+    }
+
+    if (stats)
+    {
+        stats->components = num_parts;
+        stats->threads = num_workers + 1;
+        stats->parallel_seconds = num_workers > 0 ? seconds : 0.0;
+        stats->worker_seconds = num_workers > 0 ? part_seconds : 0.0;
+    }
+    for (int p = 0; p < num_parts; p++)
+    {
+        free_resolution_state(&parts[p].state);
+    }
+    free(parts);
+    free(component);
+    free(part_of);
+    free(sizes);
+    return true;
+}
+
+// Function to saturate the working set, stopping at the empty clause
+// With more than one thread, unprocessed clauses lying in several variable-disjoint
+// components are saturated one component per thread, the budget applying to all of them
+// together; otherwise the pairs are resolved in parallel rounds. The result
+// depends on whether threads are used, but not on how many. Counters
+// since the working set was created go to stats. Returns SEARCH_UNSATISFIABLE once the empty clause is derived, and
+// SEARCH_UNKNOWN, with the reason in stopped, when the budget runs out, the cancel flag is
+// raised or memory runs out; a later call resumes where this one stopped. Set of support
+// only refutes through the goal clauses, so saturating it without the empty clause is
+// SEARCH_UNKNOWN too (STOP_SUPPORT), never SEARCH_SATISFIABLE
+SearchResult resolution_saturate(ResolutionState *state, int num_threads, ResolutionStats *stats)
+{
+    long max_resolvents = state->budget.resolvents > 0 ? state->kept + state->budget.resolvents : -1;
+    double deadline = budget_deadline(&state->budget);
+    state->stopped = STOP_NONE;
+
+    if (stats)
+    {
+        stats->components = 0;
+        stats->threads = 1;
+        stats->rounds = 0;
+        stats->parallel_seconds = 0.0;
+        stats->worker_seconds = 0.0;
+    }
+    note_peak(state);
+    if (!saturate_components(state, num_threads, deadline, stats))
+    {
+        if (num_threads <= 1 || !saturate_parallel(state, num_threads, deadline, max_resolvents, stats))
+            saturate_sequential(state, deadline, max_resolvents);
+    }
+
+    if (stats)
+    {
+        ClauseStore *store = &state->store;
+        stats->given = state->given;
+        stats->pairs = state->pairs;
+        stats->resolvents = state->resolvents;
+        stats->tautologies = state->tautologies;
+        stats->duplicates = store->num_duplicates;
+        stats->forward_subsumed = store->num_forward_subsumed;
+        stats->backward_subsumed = store->num_backward_subsumed;
+        stats->final_clauses = store->num_live;
+        stats->peak_clauses = state->peak_clauses;
+        stats->peak_bytes = state->peak_bytes;
+        stats->bitset_variables = store->kernels ? 64 * store->kernels->words : 0;
+        stats->bitset_instructions = store->kernels ? store->kernels->instructions : NULL;
+    }
+    if (state->found_empty)
+        return SEARCH_UNSATISFIABLE;
+    if (!state->stopped && state->use_support)
+        state->stopped = STOP_SUPPORT;
+    return state->stopped ? SEARCH_UNKNOWN : SEARCH_SATISFIABLE;
+}
+
+// Function to check if a saturated working set implies a clause
+// Resolution is complete for consequence finding: every clause implied by a fully saturated
+// set (no set of support) is subsumed by one of its clauses
+bool resolution_implies(ResolutionState *state, Clause *clause)
+{
+    if (state->found_empty)
+        return true;
+    if (!assign_clause(&state->copy, clause))
+        return false;
+    if (!canonicalize_clause(&state->copy))
+        return true; // Tautologies are always implied
+    return clause_store_is_subsumed(&state->store, &state->copy, clause_signature(&state->copy));
+}
+
+// Function to build a model of a saturated working set, one variable at a time
+// model holds a VALUE_* per variable; variables already set (unit propagation, assumptions)
+// keep their value and come first, the others follow by id. Each variable takes the value
+// required by the clauses it is the last variable of, whose other literals are all false by
+// then; without such a clause it is set to false. Since the set is closed under resolution,
+// two clauses requiring opposite values would have a resolvent, or a clause subsuming it,
+// already falsified. Returns false if a clause cannot be satisfied (set of support saturation
+// is not closed under resolution, or a preset value contradicts the set) or memory runs out
+bool resolution_build_model(ResolutionState *state, int8_t *model, int num_vars)
+{
+    ClauseStore *store = &state->store;
+    if (state->found_empty)
+        return false;
+
+    int *order = malloc((num_vars + 1) * sizeof(int));    // Variables in assignment order
+    int *position = malloc((num_vars + 1) * sizeof(int)); // Rank of each variable in order
+    int *bucket_start = calloc(num_vars + 2, sizeof(int));
+    int *bucket = malloc((store->num_live + 1) * sizeof(int));
+    int *last = malloc((store->num_clauses + 1) * sizeof(int)); // Last variable of each clause
+    bool ok = order && position && bucket_start && bucket && last;
+
+    if (ok)
+    {
+        int rank = 0;
+        for (int v = 0; v < num_vars; v++)
+            if (model[v] != VALUE_UNASSIGNED)
+                order[rank++] = v;
+        for (int v = 0; v < num_vars; v++)
+            if (model[v] == VALUE_UNASSIGNED)
+                order[rank++] = v;
+        for (int r = 0; r < num_vars; r++)
+            position[order[r]] = r;
+
+        // Group the live clauses by their last variable in that order
+        for (int id = 0; id < store->num_clauses; id++)
+        {
+            last[id] = -1;
+            if (store->flags[id] & CLAUSE_DELETED)
+                continue;
+            Clause clause = clause_store_get(store, id);
+            for (int k = 0; k < clause.num_literals; k++)
+            {
+                int var = literal_var(clause.literals[k]);
+                if (last[id] < 0 || position[var] > position[last[id]])
+                    last[id] = var;
+            }
+            if (last[id] >= 0)
+                bucket_start[position[last[id]] + 1]++;
+        }
+        for (int r = 0; r < num_vars; r++)
+            bucket_start[r + 1] += bucket_start[r];
+        for (int id = 0; id < store->num_clauses; id++)
+            if (last[id] >= 0)
+                bucket[bucket_start[position[last[id]]]++] = id;
+        for (int r = num_vars; r > 0; r--)
+            bucket_start[r] = bucket_start[r - 1];
+        bucket_start[0] = 0;
+    }
+
+    for (int r = 0; r < num_vars && ok; r++)
+    {
+        int var = order[r];
+        bool need_true = false;
+        bool need_false = false;
+        for (int b = bucket_start[r]; b < bucket_start[r + 1]; b++)
+        {
+            Clause clause = clause_store_get(store, bucket[b]);
+            Literal own = LITERAL_UNDEF;
+            bool satisfied = false;
+            for (int k = 0; k < clause.num_literals && !satisfied; k++)
+            {
+                Literal lit = clause.literals[k];
+                if (literal_var(lit) == var)
+                    own = lit;
+                else
+                    satisfied = model[literal_var(lit)] == (literal_is_negated(lit) ? VALUE_FALSE : VALUE_TRUE);
+            }
+            if (satisfied)
+                continue;
+            if (literal_is_negated(own))
+                need_false = true;
+            else
+                need_true = true;
+        }
+
+        if (need_true && need_false)
+            ok = false;
+        else if (model[var] == VALUE_UNASSIGNED)
+            model[var] = need_true ? VALUE_TRUE : VALUE_FALSE;
+        else if ((need_true && model[var] != VALUE_TRUE) || (need_false && model[var] != VALUE_FALSE))
+            ok = false;
+    }
+
+    free(order);
+    free(position);
+    free(bucket_start);
+    free(bucket);
+    free(last);
+    return ok;
+}
@@ -0,0 +1,1004 @@
+/*
+ * Public solver API (see solver.h)
+ */
+
+#include "solver.h"
+#include "solver_internal.h"
+
+// Structure to represent a solver instance
+struct Solver
+{
+    Formula formula; // Every clause added so far, never modified by solving
+    SolverEngine engine;
+    ResolutionOptions options;
+    SolverResult result;
+    SolverStats stats;
+    double parse_seconds; // Time spent reading formula files, since the solver was created
+    double parse_cpu_seconds;
+    Budget budget;      // Limits of each solve
+    StopReason stopped; // Why the last solve ended without an answer
+    Clause scratch;     // Clause or assumptions being built from the caller's literals
+    int8_t *model;      // VALUE_* of each variable after a satisfiable solve, when one was built
+    int model_size;
+
+    Proof proof; // DRAT proof of the solves, when proof_enabled is set
+    bool proof_enabled;
+
+    // Answers shared through a cache file, when cache_enabled is set; the canonical form of
+    // the formula is kept while no clause is added
+    ResultCache cache;
+    bool cache_enabled;
+    CanonicalForm canonical;
+    bool canonical_ready;
+    int canonical_source; // Formula clauses it was computed from
+
+    // Preprocessing: when enabled, the engines solve a simplified copy of the formula,
+    // rebuilt once clauses are added or an assumption names an eliminated variable
+    bool preprocess;
+    Formula simplified;
+    bool simplified_ready;
+    int simplified_source; // Formula clauses it was built from
+    EliminationStack elimination;
+    PreprocessStats preprocess_stats;
+
+    // Engine states are created by the first solve and kept, with everything they derived,
+    // for the next ones; clauses added in between are fed to them incrementally
+    CdclSolver cdcl;
+    bool cdcl_ready;
+    int cdcl_loaded; // Formula clauses already given to the CDCL solver
+    CdclStats cdcl_totals; // CDCL counters at the end of the previous solve
+
+    ResolutionState resolution;
+    bool resolution_ready;
+    int resolution_loaded;
+    int8_t *root_values; // Values fixed by the unit propagation run before the first saturation
+    int num_root_literals;
+    ResolutionStats resolution_totals;
+};
+
+// Function to create a solver
+Solver *solver_create(void)
+{
+    Solver *solver = calloc(1, sizeof(Solver));
+    if (!solver)
+        return NULL;
+    if (!init_formula(&solver->formula))
+    {
+        free(solver);
+        return NULL;
+    }
+    if (!init_clause(&solver->scratch))
+    {
+        free_formula(&solver->formula);
+        free(solver);
+        return NULL;
+    }
+    solver->engine = SOLVER_ENGINE_RESOLUTION;
+    solver->options.set_of_support = false;
+    solver->options.threads = 1;
+    solver->options.selection = SELECT_SHORTEST;
+    solver->result = SOLVER_UNKNOWN;
+    solver->stats.units_conflict_size = -1;
+    return solver;
+}
+
+// Function to free a solver
+void solver_destroy(Solver *solver)
+{
+    if (!solver)
+        return;
+    if (solver->cdcl_ready)
+        free_cdcl_solver(&solver->cdcl);
+    if (solver->resolution_ready)
+        free_resolution_state(&solver->resolution);
+    free(solver->root_values);
+    free(solver->model);
+    if (solver->simplified_ready)
+    {
+        free_formula(&solver->simplified);
+        free_elimination_stack(&solver->elimination);
+    }
+    if (solver->proof_enabled)
+        proof_close(&solver->proof);
+    if (solver->cache_enabled)
+        cache_close(&solver->cache);
+    free_canonical_form(&solver->canonical);
+    free_clause(&solver->scratch);
+    free_formula(&solver->formula);
+    free(solver);
+}
+
+// Function to select the engine of the next solves
+void solver_set_engine(Solver *solver, SolverEngine engine)
+{
+    solver->engine = engine;
+}
+
+// Function to enable or disable set-of-support resolution
+void solver_set_set_of_support(Solver *solver, bool enabled)
+{
+    solver->options.set_of_support = enabled;
+}
+
+// Function to select the order in which resolution gives clauses
+void solver_set_selection(Solver *solver, SolverSelection selection)
+{
+    switch (selection)
+    {
+    case SOLVER_SELECT_AGE_WEIGHT:
+        solver->options.selection = SELECT_AGE_WEIGHT;
+        break;
+    case SOLVER_SELECT_FIFO:
+        solver->options.selection = SELECT_FIFO;
+        break;
+    case SOLVER_SELECT_ORDERED:
+        solver->options.selection = SELECT_ORDERED;
+        break;
+    default:
+        solver->options.selection = SELECT_SHORTEST;
+        break;
+    }
+}
+
+// Function to set the number of threads resolution may use
+void solver_set_threads(Solver *solver, int num_threads)
+{
+    solver->options.threads = num_threads > 1 ? num_threads : 1;
+}
+
+// Function to set the resource budget of the next solves
+void solver_set_budget(Solver *solver, const SolverBudget *budget)
+{
+    memset(&solver->budget, 0, sizeof(solver->budget));
+    if (!budget)
+        return;
+    solver->budget.seconds = budget->seconds > 0 ? budget->seconds : 0.0;
+    solver->budget.conflicts = budget->conflicts > 0 ? budget->conflicts : 0;
+    solver->budget.resolvents = budget->resolvents > 0 ? budget->resolvents : 0;
+    solver->budget.clauses = budget->clauses > 0 ? budget->clauses : 0;
+    solver->budget.bytes = budget->bytes > 0 ? (size_t)budget->bytes : 0;
+}
+
+// Function to fill the scratch clause with DIMACS-style literals
+// Variables are named by their number, as the DIMACS reader does; returns false if a
+// literal is 0 or memory runs out
+static bool scratch_from_numbers(Solver *solver, const int *literals, int num_literals)
+{
+    solver->scratch.num_literals = 0;
+    solver->scratch.is_goal = false;
+    for (int i = 0; i < num_literals; i++)
+    {
+        int value = literals[i];
+        if (value == 0 || value == INT32_MIN)
+            return false;
+
+        char name[16];
+        snprintf(name, sizeof(name), "%d", value < 0 ? -value : value);
+        int var_id = find_or_add_variable(&solver->formula, name);
+        if (var_id < 0 || !add_literal(&solver->scratch, make_literal(var_id, value < 0)))
+            return false;
+    }
+    return true;
+}
+
+// Function to fill the scratch clause with named literals such as "A" or "!B"
+// Returns false on an invalid name or out of memory
+static bool scratch_from_names(Solver *solver, const char *const *literals, int num_literals)
+{
+    solver->scratch.num_literals = 0;
+    solver->scratch.is_goal = false;
+    for (int i = 0; i < num_literals; i++)
+    {
+        const char *name = literals[i];
+        bool is_negated = name && name[0] == '!';
+        if (is_negated)
+            name++;
+        if (!is_valid_variable_name(name))
+            return false;
+
+        int var_id = find_or_add_variable(&solver->formula, name);
+        if (var_id < 0 || !add_literal(&solver->scratch, make_literal(var_id, is_negated)))
+            return false;
+    }
+    return true;
+}
+
+// Function to add the scratch clause to the formula
+// The clause is put in canonical form like the file readers do; tautologies are dropped
+static bool add_scratch_clause(Solver *solver)
+{
+    solver->result = SOLVER_UNKNOWN;
+    if (!canonicalize_clause(&solver->scratch))
+        return true;
+    return add_clause(&solver->formula, &solver->scratch);
+}
+
+// Function to add a clause of DIMACS-style literals
+bool solver_add_clause(Solver *solver, const int *literals, int num_literals)
+{
+    return scratch_from_numbers(solver, literals, num_literals) && add_scratch_clause(solver);
+}
+
+// Function to add a clause of named literals
+bool solver_add_named_clause(Solver *solver, const char *const *literals, int num_literals, bool is_goal)
+{
+    if (!scratch_from_names(solver, literals, num_literals))
+        return false;
+    solver->scratch.is_goal = is_goal;
+    return add_scratch_clause(solver);
+}
+
+// Function to add the clauses of a formula file
+bool solver_read_file(Solver *solver, const char *filename, SolverFormat format)
+{
+    FileFormat file_format = FORMAT_AUTO;
+    if (format == SOLVER_FORMAT_NAMES)
+        file_format = FORMAT_NAMES;
+    else if (format == SOLVER_FORMAT_DIMACS)
+        file_format = FORMAT_DIMACS;
+
+    solver->result = SOLVER_UNKNOWN;
+    double start = now_seconds();
+    double cpu_start = cpu_seconds();
+    bool ok;
+
+    // An empty solver reads straight into its formula
+    if (solver->formula.num_clauses == 0 && solver->formula.num_variables == 0)
+    {
+        free_formula(&solver->formula);
+        ok = read_formula(filename, file_format, &solver->formula);
+        // read_formula frees the formula on failure; leave the solver usable
+        if (!ok && !init_formula(&solver->formula))
+        {
+            printf("Error: Memory allocation failed for formula\n");
+            solver->formula.clauses = NULL;
+        }
+    }
+    else
+    {
+        Formula file_formula;
+        ok = read_formula(filename, file_format, &file_formula);
+        if (ok)
+        {
+            ok = append_formula(&solver->formula, &file_formula);
+            if (!ok)
+                printf("Error: Memory allocation failed while adding %s\n", filename);
+            free_formula(&file_formula);
+        }
+    }
+
+    solver->parse_seconds += now_seconds() - start;
+    solver->parse_cpu_seconds += cpu_seconds() - cpu_start;
+    return ok;
+}
+
+// Function to get the number of variables
+int solver_num_variables(const Solver *solver)
+{
+    return solver->formula.num_variables;
+}
+
+// Function to get the number of clauses
+int solver_num_clauses(const Solver *solver)
+{
+    return solver->formula.num_clauses;
+}
+
+// Function to drop the resolution working set, for instance when set of support must be turned off
+static void reset_resolution(Solver *solver)
+{
+    if (solver->resolution_ready)
+        free_resolution_state(&solver->resolution);
+    free(solver->root_values);
+    solver->root_values = NULL;
+    solver->num_root_literals = 0;
+    solver->resolution_ready = false;
+    solver->resolution_loaded = 0;
+    memset(&solver->resolution_totals, 0, sizeof(solver->resolution_totals));
+}
+
+// Function to drop both engine states, for instance when the formula they solve is replaced
+static void reset_engines(Solver *solver)
+{
+    reset_resolution(solver);
+    if (solver->cdcl_ready)
+    {
+        free_cdcl_solver(&solver->cdcl);
+        solver->cdcl_ready = false;
+    }
+}
+
+// Function to drop the simplified formula; the engine states built on it must go as well
+static void reset_simplified(Solver *solver)
+{
+    if (!solver->simplified_ready)
+        return;
+    free_formula(&solver->simplified);
+    free_elimination_stack(&solver->elimination);
+    solver->simplified_ready = false;
+}
+
+// Function to enable or disable preprocessing
+void solver_set_preprocessing(Solver *solver, bool enabled)
+{
+    if (solver->preprocess != enabled)
+    {
+        reset_simplified(solver);
+        reset_engines(solver);
+    }
+    solver->preprocess = enabled;
+}
+
+// Function to get the formula the engines solve: the simplified one when preprocessing
+static Formula *engine_formula(Solver *solver)
+{
+    return solver->simplified_ready ? &solver->simplified : &solver->formula;
+}
+
+// Function to make sure the simplified formula matches the clauses and the assumptions in
+// solver->scratch, eliminating variables again if needed; returns false on memory error
+static bool prepare_simplified(Solver *solver)
+{
+    Formula *formula = &solver->formula;
+    bool valid = solver->simplified_ready && solver->simplified_source == formula->num_clauses &&
+                 solver->simplified.num_variables == formula->num_variables;
+    for (int i = 0; i < solver->scratch.num_literals && valid; i++)
+        valid = !solver->elimination.eliminated[literal_var(solver->scratch.literals[i])];
+    if (valid)
+    {
+        solver->preprocess_stats.seconds = 0.0;
+        solver->preprocess_stats.cpu_seconds = 0.0;
+        return true;
+    }
+
+    reset_simplified(solver);
+    reset_engines(solver);
+    bool *frozen = calloc(formula->num_variables + 1, sizeof(bool));
+    if (!frozen)
+        return false;
+    for (int i = 0; i < solver->scratch.num_literals; i++)
+        frozen[literal_var(solver->scratch.literals[i])] = true;
+
+    solver->simplified_ready = preprocess_formula(formula, &solver->simplified, frozen, 0,
+                                                  solver->proof_enabled ? &solver->proof : NULL,
+                                                  &solver->elimination, &solver->preprocess_stats);
+    solver->simplified_source = formula->num_clauses;
+    free(frozen);
+    return solver->simplified_ready;
+}
+
+// Function to start writing a DRAT proof, or to finish the current one
+// Engine states are dropped so that the proof covers every clause they derive from now on
+bool solver_set_proof(Solver *solver, const char *filename, bool binary)
+{
+    bool ok = true;
+    if (solver->proof_enabled)
+    {
+        ok = proof_close(&solver->proof);
+        if (!ok)
+            printf("Error: Unable to write the whole proof\n");
+        solver->proof_enabled = false;
+    }
+    if (!filename)
+        return ok;
+
+    reset_simplified(solver);
+    reset_engines(solver);
+    solver->proof_enabled = proof_open(&solver->proof, filename, binary);
+    return solver->proof_enabled;
+}
+
+// Function to share the answers of the next solves through a cache file
+bool solver_set_cache(Solver *solver, const char *filename)
+{
+    if (solver->cache_enabled)
+    {
+        cache_close(&solver->cache);
+        solver->cache_enabled = false;
+    }
+    if (!filename)
+        return true;
+    solver->cache_enabled = cache_open(&solver->cache, filename);
+    return solver->cache_enabled;
+}
+
+// Function to build the resolution working set from the whole formula
+// Unit propagation first fixes what it can on a copy (it simplifies its formula in place);
+// its assignments are kept so that clauses added later can be simplified the same way
+// Returns false on memory error
+static bool start_resolution(Solver *solver, bool use_support)
+{
+    Formula work;
+    if (!copy_formula(&work, engine_formula(solver)))
+        return false;
+
+    UnitPropagationResult units;
+    if (!unit_propagation(&work, &units))
+    {
+        free_formula(&work);
+        return false;
+    }
+    solver->stats.units_assigned = units.num_assignments;
+    solver->stats.units_clauses_removed = units.removed_clauses;
+    solver->stats.units_literals_removed = units.removed_literals;
+    solver->stats.units_propagations = units.propagations;
+    if (units.conflict)
+        solver->stats.units_conflict_size = units.conflict_clause.num_literals;
+
+    bool ok = init_resolution_state(&solver->resolution, use_support, solver->options.selection);
+    solver->resolution_ready = ok;
+    if (ok && solver->proof_enabled)
+    {
+        // The clauses unit propagation shortened follow from the formula and these units
+        solver->resolution.proof = &solver->proof;
+        for (int i = 0; i < units.num_assignments; i++)
+            proof_add(&solver->proof, &units.assignments[i], 1);
+        if (units.conflict)
+            proof_add(&solver->proof, NULL, 0);
+    }
+    solver->num_root_literals = 2 * work.num_variables;
+    solver->root_values = calloc(solver->num_root_literals + 1, sizeof(int8_t));
+    ok = ok && solver->root_values;
+    for (int i = 0; i < units.num_assignments && ok; i++)
+    {
+        solver->root_values[units.assignments[i]] = VALUE_TRUE;
+        solver->root_values[negate_literal(units.assignments[i])] = VALUE_FALSE;
+    }
+    if (ok && units.conflict)
+        solver->resolution.found_empty = true;
+    for (int i = 0; i < work.num_clauses && ok && !units.conflict; i++)
+        ok = resolution_add_clause(&solver->resolution, &work.clauses[i]);
+    solver->resolution_loaded = engine_formula(solver)->num_clauses;
+
+    free_unit_propagation_result(&units);
+    free_formula(&work);
+    if (!ok)
+        reset_resolution(solver);
+    return ok;
+}
+
+// Function to simplify the scratch clause with the unit propagation assignments
+// Returns false if one of them satisfies the clause
+static bool simplify_with_root_values(Solver *solver)
+{
+    Clause *clause = &solver->scratch;
+    int size = 0;
+    for (int k = 0; k < clause->num_literals; k++)
+    {
+        Literal lit = clause->literals[k];
+        int8_t value = (int)lit < solver->num_root_literals ? solver->root_values[lit] : VALUE_UNASSIGNED;
+        if (value == VALUE_TRUE)
+            return false;
+        if (value == VALUE_UNASSIGNED)
+            clause->literals[size++] = lit;
+    }
+    clause->num_literals = size;
+    return true;
+}
+
+// Function to build the model of a satisfiable resolution answer from the saturated set
+// Unit propagation values and the assumptions (given negated) are fixed first; set of support
+// saturation may leave no model, and the solve is then answered without one
+static void build_resolution_model(Solver *solver, Clause *negation)
+{
+    int num_vars = solver->formula.num_variables;
+    solver->model = calloc(num_vars + 1, sizeof(int8_t));
+    if (!solver->model)
+        return;
+    for (int v = 0; v < num_vars; v++)
+    {
+        Literal lit = make_literal(v, false);
+        if ((int)lit < solver->num_root_literals)
+            solver->model[v] = solver->root_values[lit];
+    }
+    for (int i = 0; i < negation->num_literals; i++)
+    {
+        Literal lit = negation->literals[i];
+        solver->model[literal_var(lit)] = literal_is_negated(lit) ? VALUE_TRUE : VALUE_FALSE;
+    }
+    if (!resolution_build_model(&solver->resolution, solver->model, num_vars))
+    {
+        free(solver->model);
+        solver->model = NULL;
+    }
+}
+
+// Function to decide the formula under assumptions with resolution
+// The working set only ever gains clauses, so every clause it derived stays valid for later
+// calls. Assumptions are never added to it: once the set is saturated, the formula with the
+// assumptions is unsatisfiable exactly when it implies the clause of their negations.
+// The assumptions are in solver->scratch
+static SearchResult solve_by_resolution(Solver *solver)
+{
+    Formula *formula = engine_formula(solver);
+    int num_assumptions = solver->scratch.num_literals;
+
+    // Set of support saturation is not complete for consequence finding, so queries with
+    // assumptions need a fully saturated set
+    bool use_support = false;
+    if (solver->options.set_of_support && num_assumptions == 0)
+    {
+        // Without goal clauses the support would be empty and prove nothing
+        for (int i = 0; i < formula->num_clauses && !use_support; i++)
+            use_support = formula->clauses[i].is_goal;
+    }
+    if (solver->resolution_ready && solver->resolution.use_support && !use_support)
+        reset_resolution(solver);
+
+    // Negate the assumptions first: the scratch clause is reused to load new clauses
+    Clause negation;
+    if (!init_clause(&negation))
+    {
+        solver->stopped = STOP_MEMORY;
+        return SEARCH_UNKNOWN;
+    }
+    bool ok = true;
+    for (int i = 0; i < num_assumptions && ok; i++)
+        ok = add_literal(&negation, negate_literal(solver->scratch.literals[i]));
+
+    if (ok && !solver->resolution_ready)
+    {
+        ok = start_resolution(solver, use_support);
+    }
+    else if (ok)
+    {
+        // Clauses derived so far are kept in either order; out of memory, the old one stays
+        if (solver->resolution.selection != solver->options.selection)
+            resolution_set_selection(&solver->resolution, solver->options.selection);
+        for (int i = solver->resolution_loaded; i < formula->num_clauses && ok; i++)
+        {
+            ok = assign_clause(&solver->scratch, &formula->clauses[i]);
+            if (ok && simplify_with_root_values(solver))
+                ok = resolution_add_clause(&solver->resolution, &solver->scratch);
+        }
+        solver->resolution_loaded = formula->num_clauses;
+    }
+    if (!ok)
+    {
+        free_clause(&negation);
+        solver->stopped = STOP_MEMORY;
+        return SEARCH_UNKNOWN;
+    }
+
+    ResolutionStats totals;
+    solver->resolution.budget = solver->budget;
+    solver->resolution.proof = solver->proof_enabled ? &solver->proof : NULL;
+    SearchResult result = resolution_saturate(&solver->resolution, solver->options.threads, &totals);
+    solver->stopped = solver->resolution.stopped;
+    solver->stats.given_clauses = totals.given - solver->resolution_totals.given;
+    solver->stats.pairs_tried = totals.pairs - solver->resolution_totals.pairs;
+    solver->stats.resolvents = totals.resolvents - solver->resolution_totals.resolvents;
+    solver->stats.tautologies = totals.tautologies - solver->resolution_totals.tautologies;
+    solver->stats.duplicates = totals.duplicates - solver->resolution_totals.duplicates;
+    solver->stats.forward_subsumed = totals.forward_subsumed - solver->resolution_totals.forward_subsumed;
+    solver->stats.backward_subsumed = totals.backward_subsumed - solver->resolution_totals.backward_subsumed;
+    solver->stats.final_clauses = totals.final_clauses;
+    solver->stats.peak_clauses = totals.peak_clauses;
+    solver->stats.peak_bytes = totals.peak_bytes;
+    solver->stats.bitset_variables = totals.bitset_variables;
+    solver->stats.bitset_instructions = totals.bitset_instructions;
+    solver->stats.components = totals.components;
+    solver->stats.threads = totals.threads;
+    solver->stats.rounds = totals.rounds;
+    solver->stats.parallel_seconds = totals.parallel_seconds;
+    solver->stats.worker_seconds = totals.worker_seconds;
+    solver->resolution_totals = totals;
+
+    // An assumption that unit propagation falsified fails; one it satisfied holds anyway
+    if (result == SEARCH_SATISFIABLE && num_assumptions > 0)
+    {
+        if (!assign_clause(&solver->scratch, &negation))
+        {
+            solver->stopped = STOP_MEMORY;
+            result = SEARCH_UNKNOWN;
+        }
+        else if (!simplify_with_root_values(solver) || resolution_implies(&solver->resolution, &solver->scratch))
+        {
+            result = SEARCH_UNSATISFIABLE;
+        }
+    }
+    if (result == SEARCH_SATISFIABLE)
+        build_resolution_model(solver, &negation);
+    free_clause(&negation);
+    return result;
+}
+
+// Function to decide the formula under assumptions with CDCL
+// The assumptions are in solver->scratch
+static SearchResult solve_by_cdcl(Solver *solver)
+{
+    Formula *formula = engine_formula(solver);
+    if (!solver->cdcl_ready)
+    {
+        if (!init_cdcl_solver(&solver->cdcl, formula->num_variables))
+        {
+            solver->stopped = STOP_MEMORY;
+            return SEARCH_UNKNOWN;
+        }
+        solver->cdcl_ready = true;
+        solver->cdcl_loaded = 0;
+        memset(&solver->cdcl_totals, 0, sizeof(solver->cdcl_totals));
+    }
+
+    SearchResult result = SEARCH_UNKNOWN;
+    solver->stopped = STOP_MEMORY;
+    solver->cdcl.proof = solver->proof_enabled ? &solver->proof : NULL;
+    if (cdcl_load_formula(&solver->cdcl, formula, solver->cdcl_loaded))
+    {
+        solver->cdcl_loaded = formula->num_clauses;
+        solver->cdcl.budget = solver->budget;
+        result = cdcl_search(&solver->cdcl, solver->scratch.literals, solver->scratch.num_literals);
+        solver->stopped = solver->cdcl.stopped;
+        if (result == SEARCH_SATISFIABLE)
+        {
+            solver->model = malloc((solver->formula.num_variables + 1) * sizeof(int8_t));
+            if (solver->model)
+                cdcl_copy_model(&solver->cdcl, solver->model, solver->formula.num_variables);
+        }
+    }
+
+    CdclStats *totals = &solver->cdcl.stats;
+    solver->stats.decisions = totals->decisions - solver->cdcl_totals.decisions;
+    solver->stats.propagations = totals->propagations - solver->cdcl_totals.propagations;
+    solver->stats.conflicts = totals->conflicts - solver->cdcl_totals.conflicts;
+    solver->stats.restarts = totals->restarts - solver->cdcl_totals.restarts;
+    solver->stats.learned_clauses = totals->learned_clauses - solver->cdcl_totals.learned_clauses;
+    solver->stats.deleted_clauses = totals->deleted_clauses - solver->cdcl_totals.deleted_clauses;
+    solver->stats.peak_clauses = totals->peak_clauses;
+    solver->stats.peak_bytes = totals->peak_bytes;
+    solver->cdcl_totals = *totals;
+
+    // After a memory error the clause database cannot be trusted: start afresh next time
+    if (solver->stopped == STOP_MEMORY)
+    {
+        free_cdcl_solver(&solver->cdcl);
+        solver->cdcl_ready = false;
+    }
+    return result;
+}
+
+// Function to decide the formula under assumptions by racing the portfolio strategies
+// The assumptions are in solver->scratch
+static SearchResult solve_by_portfolio(Solver *solver)
+{
+    PortfolioResult portfolio;
+    SearchResult result = portfolio_solve(engine_formula(solver), solver->scratch.literals, solver->scratch.num_literals,
+                                          &solver->options, &solver->budget, &portfolio);
+    solver->stopped = portfolio.stopped;
+    solver->stats.strategy = portfolio.winner;
+    solver->stats.strategies = portfolio.strategies;
+    solver->model = portfolio.model; // Taken over from the result
+    portfolio.model = NULL;
+    if (portfolio.winner && portfolio.use_cdcl)
+    {
+        solver->stats.decisions = portfolio.cdcl.decisions;
+        solver->stats.propagations = portfolio.cdcl.propagations;
+        solver->stats.conflicts = portfolio.cdcl.conflicts;
+        solver->stats.restarts = portfolio.cdcl.restarts;
+        solver->stats.learned_clauses = portfolio.cdcl.learned_clauses;
+        solver->stats.deleted_clauses = portfolio.cdcl.deleted_clauses;
+        solver->stats.peak_clauses = portfolio.cdcl.peak_clauses;
+        solver->stats.peak_bytes = portfolio.cdcl.peak_bytes;
+    }
+    else if (portfolio.winner)
+    {
+        solver->stats.units_assigned = portfolio.units.num_assignments;
+        solver->stats.units_clauses_removed = portfolio.units.removed_clauses;
+        solver->stats.units_literals_removed = portfolio.units.removed_literals;
+        solver->stats.units_propagations = portfolio.units.propagations;
+        if (portfolio.units.conflict)
+            solver->stats.units_conflict_size = portfolio.units.conflict_clause.num_literals;
+        solver->stats.given_clauses = portfolio.resolution.given;
+        solver->stats.pairs_tried = portfolio.resolution.pairs;
+        solver->stats.resolvents = portfolio.resolution.resolvents;
+        solver->stats.tautologies = portfolio.resolution.tautologies;
+        solver->stats.duplicates = portfolio.resolution.duplicates;
+        solver->stats.forward_subsumed = portfolio.resolution.forward_subsumed;
+        solver->stats.backward_subsumed = portfolio.resolution.backward_subsumed;
+        solver->stats.final_clauses = portfolio.resolution.final_clauses;
+        solver->stats.peak_clauses = portfolio.resolution.peak_clauses;
+        solver->stats.peak_bytes = portfolio.resolution.peak_bytes;
+        solver->stats.bitset_variables = portfolio.resolution.bitset_variables;
+        solver->stats.bitset_instructions = portfolio.resolution.bitset_instructions;
+        solver->stats.components = portfolio.resolution.components;
+        solver->stats.threads = portfolio.resolution.threads;
+        solver->stats.rounds = portfolio.resolution.rounds;
+        solver->stats.parallel_seconds = portfolio.resolution.parallel_seconds;
+        solver->stats.worker_seconds = portfolio.resolution.worker_seconds;
+    }
+    free_portfolio_result(&portfolio);
+    return result;
+}
+
+// Function to name the reason a solve stopped without an answer
+static const char *stop_reason_name(StopReason reason)
+{
+    switch (reason)
+    {
+    case STOP_MEMORY:
+        return "memory";
+    case STOP_CANCELLED:
+        return "cancelled";
+    case STOP_TIME:
+        return "time";
+    case STOP_CONFLICTS:
+        return "conflicts";
+    case STOP_RESOLVENTS:
+        return "resolvents";
+    case STOP_CLAUSES:
+        return "clauses";
+    case STOP_BYTES:
+        return "bytes";
+    case STOP_SUPPORT:
+        return "support";
+    default:
+        return NULL;
+    }
+}
+
+// Function to compute the canonical form of the formula, unless no clause was added since
+// Returns false if out of memory
+static bool prepare_canonical_form(Solver *solver)
+{
+    if (solver->canonical_ready && solver->canonical_source == solver->formula.num_clauses)
+        return true;
+    free_canonical_form(&solver->canonical);
+    solver->canonical_ready = canonical_form(&solver->formula, &solver->canonical);
+    solver->canonical_source = solver->formula.num_clauses;
+    return solver->canonical_ready;
+}
+
+// Function to take the answer of the formula from the cache, with the counters of the solve
+// that stored it; a model that does not satisfy the formula (two formulas with the same
+// hashes) is not taken. Returns false if there is no usable answer
+static bool solve_from_cache(Solver *solver)
+{
+    int num_variables = solver->formula.num_variables;
+    int8_t *model = malloc((num_variables > 0 ? num_variables : 1) * sizeof(int8_t));
+    if (!model)
+        return false;
+    for (int v = 0; v < num_variables; v++)
+    {
+        model[v] = VALUE_FALSE; // Variables in no clause
+    }
+
+    CachedStats cached;
+    SearchResult result = cache_lookup(&solver->cache, &solver->canonical, model, &cached);
+    if (result == SEARCH_UNKNOWN ||
+        (result == SEARCH_SATISFIABLE && !formula_satisfied_by(&solver->formula, model)))
+    {
+        free(model);
+        return false;
+    }
+    if (result == SEARCH_SATISFIABLE)
+    {
+        solver->model = model;
+        solver->model_size = num_variables;
+    }
+    else
+    {
+        free(model);
+    }
+    solver->stats.cached = true;
+    solver->stats.given_clauses = cached.given_clauses;
+    solver->stats.pairs_tried = cached.pairs_tried;
+    solver->stats.resolvents = cached.resolvents;
+    solver->stats.decisions = cached.decisions;
+    solver->stats.propagations = cached.propagations;
+    solver->stats.conflicts = cached.conflicts;
+    solver->stats.cached_solve_seconds = cached.solve_seconds;
+    solver->stats.cached_solve_cpu_seconds = cached.solve_cpu_seconds;
+    solver->result = result == SEARCH_SATISFIABLE ? SOLVER_SATISFIABLE : SOLVER_UNSATISFIABLE;
+    return true;
+}
+
+// Function to store the answer of the last solve in the cache
+static void store_in_cache(Solver *solver, SearchResult result)
+{
+    CachedStats cached = {0};
+    cached.solve_seconds = solver->stats.solve_seconds;
+    cached.solve_cpu_seconds = solver->stats.solve_cpu_seconds;
+    cached.given_clauses = solver->stats.given_clauses;
+    cached.pairs_tried = solver->stats.pairs_tried;
+    cached.resolvents = solver->stats.resolvents;
+    cached.decisions = solver->stats.decisions;
+    cached.propagations = solver->stats.propagations;
+    cached.conflicts = solver->stats.conflicts;
+    cache_store(&solver->cache, &solver->canonical, result, solver->model, &cached);
+}
+
+// Function to decide the clauses added so far under the assumptions in solver->scratch
+static SolverResult solve_scratch_assumptions(Solver *solver)
+{
+    memset(&solver->stats, 0, sizeof(solver->stats));
+    solver->stats.units_conflict_size = -1;
+    solver->result = SOLVER_UNKNOWN;
+    free(solver->model);
+    solver->model = NULL;
+    if (!solver->formula.clauses)
+        return SOLVER_UNKNOWN;
+
+    double start = now_seconds();
+    double cpu_start = cpu_seconds();
+    SearchResult result;
+    solver->stopped = STOP_NONE;
+    if (solver->proof_enabled && !proof_map_variables(&solver->proof, &solver->formula))
+    {
+        printf("Error: Memory allocation failed for the proof\n");
+        return SOLVER_UNKNOWN;
+    }
+
+    // Only answers about the clauses alone are cached, and a proof needs a real solve
+    bool use_cache = solver->cache_enabled && solver->scratch.num_literals == 0 && !solver->proof_enabled &&
+                     prepare_canonical_form(solver);
+    if (use_cache && solve_from_cache(solver))
+    {
+        solver->stats.solve_seconds = now_seconds() - start;
+        solver->stats.solve_cpu_seconds = cpu_seconds() - cpu_start;
+        return solver->result;
+    }
+
+    if (!canonicalize_clause(&solver->scratch))
+    {
+        // Assumptions x and !x cannot hold together
+        result = SEARCH_UNSATISFIABLE;
+    }
+    else if (solver->preprocess && !prepare_simplified(solver))
+    {
+        printf("Error: Memory allocation failed during variable elimination\n");
+        result = SEARCH_UNKNOWN;
+        solver->stopped = STOP_MEMORY;
+    }
+    else if (solver->engine == SOLVER_ENGINE_CDCL)
+    {
+        result = solve_by_cdcl(solver);
+        if (solver->stopped == STOP_MEMORY)
+            printf("Error: Memory allocation failed during CDCL search\n");
+    }
+    else if (solver->engine == SOLVER_ENGINE_PORTFOLIO)
+    {
+        result = solve_by_portfolio(solver);
+        if (solver->stopped == STOP_MEMORY)
+            printf("Error: Memory allocation failed in every portfolio strategy\n");
+    }
+    else
+    {
+        result = solve_by_resolution(solver);
+        if (solver->stopped == STOP_MEMORY)
+            printf("Error: Memory allocation failed during resolution\n");
+    }
+    if (result == SEARCH_SATISFIABLE && solver->model && solver->simplified_ready)
+        extend_model(&solver->elimination, solver->model);
+    if (solver->simplified_ready)
+    {
+        PreprocessStats *preprocess = &solver->preprocess_stats;
+        solver->stats.unit_variables = preprocess->units.variables;
+        solver->stats.unit_clauses = preprocess->units.clauses;
+        solver->stats.failed_literals = preprocess->failed_literals;
+        solver->stats.equivalent_variables = preprocess->equivalences.variables;
+        solver->stats.equivalent_clauses = preprocess->equivalences.clauses;
+        solver->stats.pure_variables = preprocess->pure.variables;
+        solver->stats.pure_clauses = preprocess->pure.clauses;
+        solver->stats.eliminated_variables = preprocess->elimination.variables;
+        solver->stats.eliminated_clauses = preprocess->elimination.clauses;
+        solver->stats.preprocessed_clauses = solver->simplified.num_clauses;
+        solver->stats.preprocess_seconds = preprocess->seconds;
+        solver->stats.preprocess_cpu_seconds = preprocess->cpu_seconds;
+    }
+
+    // Models are checked against every clause added, which is linear in the formula size
+    if (result == SEARCH_SATISFIABLE && solver->model && !formula_satisfied_by(&solver->formula, solver->model))
+    {
+        printf("Error: The model found does not satisfy the formula\n");
+        free(solver->model);
+        solver->model = NULL;
+        result = SEARCH_UNKNOWN;
+    }
+    solver->model_size = solver->model ? solver->formula.num_variables : 0;
+    solver->stats.solve_seconds = now_seconds() - start;
+    solver->stats.solve_cpu_seconds = cpu_seconds() - cpu_start;
+    solver->stats.stopped_by = result == SEARCH_UNKNOWN ? stop_reason_name(solver->stopped) : NULL;
+    if (use_cache)
+        store_in_cache(solver, result);
+
+    if (result == SEARCH_SATISFIABLE)
+        solver->result = SOLVER_SATISFIABLE;
+    else if (result == SEARCH_UNSATISFIABLE)
+        solver->result = SOLVER_UNSATISFIABLE;
+    return solver->result;
+}
+
+// Function to decide the clauses added so far
+SolverResult solver_solve(Solver *solver)
+{
+    solver->scratch.num_literals = 0;
+    return solve_scratch_assumptions(solver);
+}
+
+// Function to decide the clauses added so far under DIMACS-style assumption literals
+SolverResult solver_solve_assuming(Solver *solver, const int *assumptions, int num_assumptions)
+{
+    if (!scratch_from_numbers(solver, assumptions, num_assumptions))
+    {
+        solver->result = SOLVER_UNKNOWN;
+        return SOLVER_UNKNOWN;
+    }
+    return solve_scratch_assumptions(solver);
+}
+
+// Function to decide the clauses added so far under named assumption literals
+SolverResult solver_solve_assuming_named(Solver *solver, const char *const *assumptions, int num_assumptions)
+{
+    if (!scratch_from_names(solver, assumptions, num_assumptions))
+    {
+        solver->result = SOLVER_UNKNOWN;
+        return SOLVER_UNKNOWN;
+    }
+    return solve_scratch_assumptions(solver);
+}
+
+// Function to get the result of the last solve
+SolverResult solver_result(const Solver *solver)
+{
+    return solver->result;
+}
+
+// Function to check whether the last solve came with a model
+bool solver_has_model(const Solver *solver)
+{
+    return solver->result == SOLVER_SATISFIABLE && solver->model;
+}
+
+// Function to get the value of a variable by id in the model of the last solve
+static int model_value(const Solver *solver, int var_id)
+{
+    if (!solver_has_model(solver) || var_id < 0 || var_id >= solver->model_size)
+        return 0;
+    return solver->model[var_id];
+}
+
+// Function to get the value of a DIMACS-style variable in the model of the last solve
+int solver_value(const Solver *solver, int variable)
+{
+    if (variable <= 0)
+        return 0;
+    char name[16];
+    snprintf(name, sizeof(name), "%d", variable);
+    return model_value(solver, find_variable(&solver->formula, name));
+}
+
+// Function to get the value of a named variable in the model of the last solve
+int solver_value_named(const Solver *solver, const char *name)
+{
+    return model_value(solver, find_variable(&solver->formula, name));
+}
+
+// Function to get the name of a variable
+const char *solver_variable_name(const Solver *solver, int index)
+{
+    if (index < 0 || index >= solver->formula.num_variables)
+        return NULL;
+    return solver->formula.variables[index].name;
+}
+
+// Function to copy the counters of the last solve
+void solver_get_stats(const Solver *solver, SolverStats *stats)
+{
+    *stats = solver->stats;
+    stats->parse_seconds = solver->parse_seconds;
+    stats->parse_cpu_seconds = solver->parse_cpu_seconds;
+}
+
+// Function to name a result
+const char *solver_result_name(SolverResult result)
+{
+    switch (result)
+    {
+    case SOLVER_SATISFIABLE:
+        return "satisfiable";
+    case SOLVER_UNSATISFIABLE:
+        return "unsatisfiable";
+    default:
+        return "unknown";
+    }
+}
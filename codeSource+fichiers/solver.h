@@ -0,0 +1,269 @@
+/*
+ * Propositional logic solver library - public API
+ *
+ * Typical use:
+ *
+ *     Solver *solver = solver_create();
+ *     int clause[] = {1, -2};                       // DIMACS-style literals
+ *     solver_add_clause(solver, clause, 2);
+ *     const char *named[] = {"A", "!B"};            // or literals by name
+ *     solver_add_named_clause(solver, named, 2, false);
+ *     if (solver_solve(solver) == SOLVER_UNSATISFIABLE)
+ *         ...
+ *     solver_destroy(solver);
+ *
+ * A solver is not thread-safe, but independent solvers can be used from different
+ * threads at the same time.
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Opaque solver instance
+typedef struct Solver Solver;
+
+// Decision procedures a solver can use
+typedef enum
+{
+    SOLVER_ENGINE_RESOLUTION, // Unit propagation, then resolution by refutation (default)
+    SOLVER_ENGINE_CDCL,       // Conflict-driven clause learning
+    SOLVER_ENGINE_PORTFOLIO   // Race several CDCL and resolution configurations on their own
+                              // threads and take the first answer; each solve starts afresh
+} SolverEngine;
+
+// Orders in which resolution picks the next clause to resolve against the others; any order
+// reaches the same answers, but short clauses tend to lead to the empty clause sooner
+typedef enum
+{
+    SOLVER_SELECT_SHORTEST,   // Shortest clause first (default)
+    SOLVER_SELECT_AGE_WEIGHT, // Shortest clause first, but the oldest one every fifth pick
+    SOLVER_SELECT_FIFO,       // In the order clauses were added or derived
+    SOLVER_SELECT_ORDERED     // Clause with the earliest last variable first (ordered resolution)
+} SolverSelection;
+
+// Formula file formats understood by solver_read_file
+typedef enum
+{
+    SOLVER_FORMAT_AUTO,  // DIMACS if the file starts with a "p cnf" header, names otherwise
+    SOLVER_FORMAT_NAMES, // One clause per line such as "A !B C"; '#' comments, '?' goal clauses
+    SOLVER_FORMAT_DIMACS // "p cnf <vars> <clauses>" header, clauses of signed integers ending with 0
+} SolverFormat;
+
+// Outcome of a solve; the values follow the usual SAT solver exit codes
+typedef enum
+{
+    SOLVER_UNKNOWN = 0, // Not solved yet, or the solve stopped early (budget or memory)
+    SOLVER_SATISFIABLE = 10,
+    SOLVER_UNSATISFIABLE = 20
+} SolverResult;
+
+// Counters of the last solve; only those of the engine used are filled in, and unit
+// propagation only runs on the first resolution solve. A portfolio fills in those of the
+// strategy that answered. When the library is built with SOLVER_NO_COUNTERS, the hot-path
+// counters pairs_tried, resolvents, tautologies, duplicates, forward_subsumed,
+// backward_subsumed, decisions, peak_clauses and peak_bytes are not kept and stay 0
+typedef struct
+{
+    // Wall-clock and CPU seconds of each phase; CPU time counts every thread of the process,
+    // so it exceeds the wall-clock time when several threads work
+    double parse_seconds; // Reading formula files, since the solver was created
+    double parse_cpu_seconds;
+    double solve_seconds; // The whole solve, preprocessing included
+    double solve_cpu_seconds;
+
+    bool cached; // The answer came from the cache file; the counters below are then only
+                 // those the cache keeps (resolution given clauses, pairs and resolvents,
+                 // CDCL decisions, propagations and conflicts) of the solve that stored it
+    double cached_solve_seconds; // Wall-clock and CPU seconds of that solve
+    double cached_solve_cpu_seconds;
+
+    const char *stopped_by; // Why a SOLVER_UNKNOWN solve stopped: "time", "conflicts",
+                            // "resolvents", "clauses", "bytes", "memory", or "support" when
+                            // set of support ran out of clauses; NULL otherwise
+    const char *strategy; // Portfolio strategy that answered, such as "cdcl", or NULL
+    int strategies;       // Portfolio strategies raced
+
+    // Preprocessing, when it is on: variables and clauses each technique removed (clauses
+    // removed less those added in their place)
+    int unit_variables; // Unit propagation with failed literal probing
+    int unit_clauses;
+    int failed_literals;
+    int equivalent_variables; // Equivalent literal substitution
+    int equivalent_clauses;
+    int pure_variables; // Pure literal elimination
+    int pure_clauses;
+    int eliminated_variables; // Bounded variable elimination
+    int eliminated_clauses;
+    int preprocessed_clauses;  // Clauses left for the engine
+    double preprocess_seconds; // 0 when the simplified formula of the previous solve was reused
+    double preprocess_cpu_seconds;
+
+    // Unit propagation run before resolution
+    int units_assigned;
+    int units_clauses_removed;
+    int units_literals_removed;
+    long units_propagations;
+    int units_conflict_size; // Size of the clause falsified by unit propagation, or -1
+
+    // Resolution
+    long given_clauses;
+    long pairs_tried; // Pairs of clauses resolved, tautologies included
+    long resolvents;
+    long tautologies;
+    long duplicates;
+    long forward_subsumed;
+    long backward_subsumed;
+    int final_clauses;
+    int bitset_variables;            // Width of the bitset clause kernels resolution ran on (64 to
+                                     // 512 variables), 0 for formulas with more variables
+    const char *bitset_instructions; // "scalar", "avx2" or "avx512", or NULL
+    int components;          // Variable-disjoint components saturated on threads of their own, 0
+                             // when the clauses were not split
+    int threads;             // Threads that resolved pairs
+    long rounds;             // Parallel rounds, when more than one thread was used
+    double parallel_seconds; // Wall-clock time of the parallel rounds
+    double worker_seconds;   // Time all threads spent resolving in them; the ratio is the speedup
+
+    // CDCL
+    long decisions;
+    long propagations;
+    long conflicts;
+    long restarts;
+    long learned_clauses;
+    long deleted_clauses;
+
+    // Peak size of the clause set of the engine that answered (resolution working set or CDCL
+    // clause database) since it was created, and the bytes of its literals
+    int peak_clauses;
+    long long peak_bytes;
+} SolverStats;
+
+// Resource limits of each solve; zero fields are unlimited. A solve that exhausts one stops
+// cleanly with SOLVER_UNKNOWN, and resolution resumes from where it stopped on the next solve
+typedef struct
+{
+    double seconds;  // Wall-clock time of the search
+    long conflicts;  // CDCL conflicts
+    long resolvents; // New clauses resolution keeps; duplicate and subsumed resolvents are
+                     // not counted, so every solve makes progress
+    int clauses;     // Clauses held at once (resolution working set, CDCL clause database)
+    long long bytes; // Bytes taken by the literals of those clauses
+} SolverBudget;
+
+// Create an empty solver (no clauses, resolution engine); returns NULL if out of memory
+Solver *solver_create(void);
+
+// Free a solver and everything it owns
+void solver_destroy(Solver *solver);
+
+// Select the decision procedure used by the next solves
+void solver_set_engine(Solver *solver, SolverEngine engine);
+
+// Restrict resolution to the set of support of the goal clauses (no effect on CDCL; a
+// portfolio races set of support resolution whenever there are goal clauses). Set of support
+// can only prove the goal by refutation: it answers SOLVER_UNSATISFIABLE or SOLVER_UNKNOWN,
+// the latter with stopped_by "support" once no clause descending from a goal is left.
+// Without goal clauses, resolution saturates all clauses as if it were off, so it can then
+// answer SOLVER_SATISFIABLE
+void solver_set_set_of_support(Solver *solver, bool enabled);
+
+// Select the order in which resolution picks clauses (no effect on CDCL); clauses derived by
+// earlier solves are kept and reordered
+void solver_set_selection(Solver *solver, SolverSelection selection);
+
+// Let resolution resolve pairs of clauses on several threads (1, the default, runs it
+// sequentially); clauses that split into components sharing no variable are then saturated
+// one component per thread, the first unsatisfiable one stopping the others. Results do not
+// depend on the number of threads once it is above 1
+void solver_set_threads(Solver *solver, int num_threads);
+
+// Simplify the formula before the next solves by unit propagation with failed literal
+// probing, equivalent literal substitution, pure literal elimination and bounded variable
+// elimination (a variable goes when its clauses can be replaced by no more resolvents on it).
+// Removed variables still get a value in the model. The simplified formula is reused while no clause is added
+// and assumptions only name variables it kept; otherwise it is rebuilt and the engines
+// start afresh
+void solver_set_preprocessing(Solver *solver, bool enabled);
+
+// Limit the resources of the next solves; NULL removes every limit
+void solver_set_budget(Solver *solver, const SolverBudget *budget);
+
+// Write a DRAT proof of the next unsatisfiable answers to a file, as text or binary DRAT,
+// for checkers such as drat-trim; NULL finishes the current proof. Variables keep their
+// DIMACS numbers, named variables are numbered by order of first appearance. Clauses
+// derived under assumptions are logged too, but an answer that depends on the assumptions
+// does not end the proof with the empty clause; the portfolio engine logs nothing.
+// Returns false if the file cannot be created or the finished proof could not be written
+bool solver_set_proof(Solver *solver, const char *filename, bool binary);
+
+// Share answers through a cache file, created if needed, that any number of solvers and
+// processes can use at once; NULL stops using it. Solves without assumptions or a proof look
+// the formula up before searching and store the definitive answers they reach, with their
+// model and counters. Formulas are recognized whatever the names of their variables and the
+// order of their clauses and literals, except very symmetric ones (such as pigeonhole
+// formulas), which are only recognized under renamings that keep their names in the same
+// order; the file has a fixed size, and once full, answers used least recently give way. Returns false (after printing the reason) if the file cannot
+// be opened or is not a cache file
+bool solver_set_cache(Solver *solver, const char *filename);
+
+// Add a clause of DIMACS-style literals: variable v is written v, its negation -v
+// Returns false if a literal is 0 or memory runs out; tautologies are accepted and dropped
+bool solver_add_clause(Solver *solver, const int *literals, int num_literals);
+
+// Add a clause of named literals such as "A" or "!B"; goal clauses are the negated goal
+// used by set-of-support resolution. Returns false on an invalid name or out of memory
+bool solver_add_named_clause(Solver *solver, const char *const *literals, int num_literals, bool is_goal);
+
+// Add every clause of a formula file; variables are matched by name with those already added
+// Returns false (after printing the reason) if the file cannot be read
+bool solver_read_file(Solver *solver, const char *filename, SolverFormat format);
+
+// Number of distinct variables and of clauses added so far
+int solver_num_variables(const Solver *solver);
+int solver_num_clauses(const Solver *solver);
+
+// Decide the satisfiability of all clauses added so far; clauses can still be added afterwards
+// Solves are incremental: clauses derived or learned by one call are reused by the next ones
+SolverResult solver_solve(Solver *solver);
+
+// Decide the clauses added so far together with assumption literals that only hold for this
+// call, such as {3, -7} or {"P", "!Q"}; SOLVER_UNSATISFIABLE means the clauses contradict
+// the assumptions. Returns SOLVER_UNKNOWN on an invalid literal
+// With resolution, a solve with assumptions saturates without set of support
+SolverResult solver_solve_assuming(Solver *solver, const int *assumptions, int num_assumptions);
+SolverResult solver_solve_assuming_named(Solver *solver, const char *const *assumptions, int num_assumptions);
+
+// Result of the last solve (SOLVER_UNKNOWN if clauses were added since)
+SolverResult solver_result(const Solver *solver);
+
+// Whether the last solve answered SOLVER_SATISFIABLE with a model; adding clauses discards
+// it. Every model is checked against all clauses before it is returned
+bool solver_has_model(const Solver *solver);
+
+// Value of a variable in that model: 1 for true, -1 for false, 0 without a model or for a
+// variable the solver does not know; variables are given by DIMACS number or by name
+int solver_value(const Solver *solver, int variable);
+int solver_value_named(const Solver *solver, const char *name);
+
+// Name of the variable of an index from 0 to solver_num_variables() - 1 in order of first
+// appearance (its number as text for DIMACS variables), or NULL
+const char *solver_variable_name(const Solver *solver, int index);
+
+// Copy the counters of the last solve
+void solver_get_stats(const Solver *solver, SolverStats *stats);
+
+// Lower-case name of a result: "satisfiable", "unsatisfiable" or "unknown"
+const char *solver_result_name(SolverResult result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,14 +1,25 @@
 /*
- * Enhanced Logic Resolution Solver Implementation
+ * Enhanced Logic Resolution Solver - command line front end
  * Based on Robinson's Resolution with modern improvements
+ * The solving itself lives in the solver library (solver.h)
  */
 
+#include "solver.h"
+#include <ctype.h>
+#include <dirent.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <stdbool.h>
-#include <ctype.h>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define INITIAL_CAPACITY 100
+#define GROWTH_FACTOR 2
 
 // Color definitions for Windows
 #define COLOR_RESET 14   // White (default)
@@ -19,11 +30,19 @@
 #define COLOR_MAGENTA 10 // Light Magenta
 #define COLOR_CYAN 13    // Light Cyan
 
-// Function to set console color
+// Exit status when the solve stopped without an answer (budget exhausted or out of memory);
+// satisfiable and unsatisfiable exit with 0, errors with 1
+#define EXIT_UNKNOWN 2
+
+// Function to set console color (other consoles keep their colors)
 void set_color(int color)
 {
+#ifdef _WIN32
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, color);
+#else
+    (void)color;
+#endif
 }
 
 void print_credits()
@@ -46,615 +65,804 @@ void print_credits()
     set_color(COLOR_RESET);
 }
 
-#define MAX_VAR_NAME 64
-#define INITIAL_CAPACITY 100
-#define GROWTH_FACTOR 2
-#define MAX_LINE_LENGTH 1024
-
-// Structure to represent a variable name
-typedef struct
+// Function to look up a resolution selection strategy by its command-line name
+// Returns the SolverSelection, or -1 for an unknown name
+int selection_from_name(const char *name)
 {
-    char name[MAX_VAR_NAME];
-} Variable;
-
-// Structure to represent a literal (variable or its negation)
-typedef struct
-{
-    Variable var;
-    bool is_negated;
-} Literal;
+    if (strcmp(name, "shortest") == 0)
+        return SOLVER_SELECT_SHORTEST;
+    if (strcmp(name, "age-weight") == 0)
+        return SOLVER_SELECT_AGE_WEIGHT;
+    if (strcmp(name, "fifo") == 0)
+        return SOLVER_SELECT_FIFO;
+    if (strcmp(name, "ordered") == 0)
+        return SOLVER_SELECT_ORDERED;
+    return -1;
+}
 
-// Structure to represent a clause (disjunction of literals)
-typedef struct
+// Function to print resolution statistics
+void print_stats(SolverStats *stats)
 {
-    Literal *literals;
-    int num_literals;
-    int capacity;
-} Clause;
+    printf("Statistics:\n");
+    printf("  given clauses        : %ld\n", stats->given_clauses);
+    printf("  pairs tried          : %ld\n", stats->pairs_tried);
+    printf("  resolvents generated : %ld\n", stats->resolvents);
+    printf("  tautologies rejected : %ld\n", stats->tautologies);
+    printf("  duplicates rejected  : %ld\n", stats->duplicates);
+    printf("  forward subsumed     : %ld\n", stats->forward_subsumed);
+    printf("  backward subsumed    : %ld\n", stats->backward_subsumed);
+    printf("  final clause count   : %d\n", stats->final_clauses);
+    printf("  peak clause count    : %d\n", stats->peak_clauses);
+    printf("  peak bytes           : %lld\n", stats->peak_bytes);
+    if (stats->bitset_variables > 0)
+        printf("  bitset kernels       : %d variables (%s)\n", stats->bitset_variables, stats->bitset_instructions);
+    if (stats->components > 0)
+        printf("  components           : %d, one thread each\n", stats->components);
+    if (stats->threads > 1)
+    {
+        // Work done by all threads over the time the rounds or components took: the speedup of
+        // the parallel part
+        printf("  threads              : %d\n", stats->threads);
+        if (stats->rounds > 0)
+            printf("  parallel rounds      : %ld\n", stats->rounds);
+        printf("  parallel speedup     : %.2fx (%.3f s of work in %.3f s)\n",
+               stats->parallel_seconds > 0 ? stats->worker_seconds / stats->parallel_seconds : 1.0,
+               stats->worker_seconds, stats->parallel_seconds);
+    }
+}
 
-// Structure to represent a formula (conjunction of clauses)
-typedef struct
-{
-    Clause *clauses;
-    int num_clauses;
-    int capacity;
-    Variable *variables; // Track unique variables
-    int num_variables;
-    int var_capacity;
-} Formula;
-
-// Function to initialize a variable
-void init_variable(Variable *var)
+// Function to print what unit propagation derived before resolution
+void print_unit_propagation_stats(SolverStats *stats)
 {
-    var->name[0] = '\0';
+    printf("Unit propagation:\n");
+    printf("  variables assigned   : %d\n", stats->units_assigned);
+    printf("  clauses removed      : %d\n", stats->units_clauses_removed);
+    printf("  literals removed     : %d\n", stats->units_literals_removed);
+    printf("  propagations         : %ld\n", stats->units_propagations);
+    if (stats->units_conflict_size >= 0)
+        printf("  conflict clause size : %d\n", stats->units_conflict_size);
 }
 
-// Function to compare variables
-bool variables_equal(Variable *v1, Variable *v2)
+// Function to print how much each preprocessing technique simplified the formula
+void print_preprocess_stats(SolverStats *stats, int num_clauses)
 {
-    return strcmp(v1->name, v2->name) == 0;
+    printf("Preprocessing:                 variables  clauses\n");
+    printf("  units and failed literals : %9d %8d\n", stats->unit_variables, stats->unit_clauses);
+    printf("  equivalent literals       : %9d %8d\n", stats->equivalent_variables, stats->equivalent_clauses);
+    printf("  pure literals             : %9d %8d\n", stats->pure_variables, stats->pure_clauses);
+    printf("  variable elimination      : %9d %8d\n", stats->eliminated_variables, stats->eliminated_clauses);
+    printf("  failed literals           : %d\n", stats->failed_literals);
+    printf("  clauses kept              : %d of %d\n", stats->preprocessed_clauses, num_clauses);
 }
 
-// Function to initialize a clause
-bool init_clause(Clause *clause)
+// Function to print CDCL statistics
+void print_cdcl_stats(SolverStats *stats)
 {
-    clause->literals = malloc(INITIAL_CAPACITY * sizeof(Literal));
-    if (!clause->literals)
-        return false;
-    clause->num_literals = 0;
-    clause->capacity = INITIAL_CAPACITY;
-    return true;
+    printf("Statistics:\n");
+    printf("  decisions            : %ld\n", stats->decisions);
+    printf("  propagations         : %ld\n", stats->propagations);
+    printf("  conflicts            : %ld\n", stats->conflicts);
+    printf("  restarts             : %ld\n", stats->restarts);
+    printf("  learned clauses      : %ld\n", stats->learned_clauses);
+    printf("  deleted clauses      : %ld\n", stats->deleted_clauses);
+    printf("  peak clause count    : %d\n", stats->peak_clauses);
+    printf("  peak bytes           : %lld\n", stats->peak_bytes);
 }
 
-// Function to free a clause
-void free_clause(Clause *clause)
+// Function to print the wall-clock and CPU time of each phase
+void print_timers(SolverStats *stats, bool preprocess)
 {
-    free(clause->literals);
-    clause->literals = NULL;
-    clause->num_literals = 0;
-    clause->capacity = 0;
+    printf("Timers:                  wall s     cpu s\n");
+    printf("  parse             : %9.3f %9.3f\n", stats->parse_seconds, stats->parse_cpu_seconds);
+    if (preprocess)
+        printf("  preprocess        : %9.3f %9.3f\n", stats->preprocess_seconds, stats->preprocess_cpu_seconds);
+    printf("  solve             : %9.3f %9.3f\n", stats->solve_seconds, stats->solve_cpu_seconds);
 }
 
-// Function to initialize a formula
-bool init_formula(Formula *formula)
+// Function to print a JSON string, or null when there is none
+static void print_json_string(const char *text)
 {
-    formula->clauses = malloc(INITIAL_CAPACITY * sizeof(Clause));
-    formula->variables = malloc(INITIAL_CAPACITY * sizeof(Variable));
-    if (!formula->clauses || !formula->variables)
-    {
-        free(formula->clauses);
-        free(formula->variables);
-        return false;
-    }
-    formula->num_clauses = 0;
-    formula->capacity = INITIAL_CAPACITY;
-    formula->num_variables = 0;
-    formula->var_capacity = INITIAL_CAPACITY;
-    return true;
+    if (text)
+        printf("\"%s\"", text);
+    else
+        fputs("null", stdout);
 }
 
-// Function to free a formula
-void free_formula(Formula *formula)
+// Function to print the statistics of a solve as one JSON object, for logs and scripts
+// Only the sections of the engine that answered are included, as in the text output
+void print_stats_json(SolverStats *stats, SolverResult result, SolverEngine engine, bool preprocess, int num_clauses)
 {
-    for (int i = 0; i < formula->num_clauses; i++)
+    printf("{\"result\": \"%s\", \"stopped_by\": ", solver_result_name(result));
+    print_json_string(stats->stopped_by);
+    if (stats->cached)
+        printf(", \"cached\": {\"wall\": %.6f, \"cpu\": %.6f}", stats->cached_solve_seconds,
+               stats->cached_solve_cpu_seconds);
+    printf(", \"time\": {\"parse\": {\"wall\": %.6f, \"cpu\": %.6f}, ", stats->parse_seconds, stats->parse_cpu_seconds);
+    printf("\"preprocess\": {\"wall\": %.6f, \"cpu\": %.6f}, ", stats->preprocess_seconds, stats->preprocess_cpu_seconds);
+    printf("\"solve\": {\"wall\": %.6f, \"cpu\": %.6f}}", stats->solve_seconds, stats->solve_cpu_seconds);
+    printf(", \"peak_clauses\": %d, \"peak_bytes\": %lld", stats->peak_clauses, stats->peak_bytes);
+
+    if (preprocess)
     {
-        free_clause(&formula->clauses[i]);
+        printf(", \"preprocess\": {\"unit_variables\": %d, \"unit_clauses\": %d, \"failed_literals\": %d, ",
+               stats->unit_variables, stats->unit_clauses, stats->failed_literals);
+        printf("\"equivalent_variables\": %d, \"equivalent_clauses\": %d, ", stats->equivalent_variables,
+               stats->equivalent_clauses);
+        printf("\"pure_variables\": %d, \"pure_clauses\": %d, ", stats->pure_variables, stats->pure_clauses);
+        printf("\"eliminated_variables\": %d, \"eliminated_clauses\": %d, ", stats->eliminated_variables,
+               stats->eliminated_clauses);
+        printf("\"clauses_kept\": %d, \"clauses\": %d}", stats->preprocessed_clauses, num_clauses);
     }
-    free(formula->clauses);
-    free(formula->variables);
-    formula->clauses = NULL;
-    formula->variables = NULL;
-    formula->num_clauses = 0;
-    formula->capacity = 0;
-    formula->num_variables = 0;
-    formula->var_capacity = 0;
-}
 
-// Function to find or add a variable to the formula
-int find_or_add_variable(Formula *formula, const char *name)
-{
-    // First try to find the variable
-    for (int i = 0; i < formula->num_variables; i++)
+    bool use_cdcl = engine == SOLVER_ENGINE_CDCL || (stats->strategy && strncmp(stats->strategy, "cdcl", 4) == 0);
+    if (engine == SOLVER_ENGINE_PORTFOLIO)
     {
-        if (strcmp(formula->variables[i].name, name) == 0)
+        printf(", \"portfolio\": {\"strategies\": %d, \"answered_by\": ", stats->strategies);
+        print_json_string(stats->strategy);
+        fputs("}", stdout);
+        if (!stats->strategy)
         {
-            return i;
+            printf("}\n");
+            return;
         }
     }
-
-    // If not found, add it
-    if (formula->num_variables >= formula->var_capacity)
+    if (use_cdcl)
     {
-        int new_capacity = formula->var_capacity * GROWTH_FACTOR;
-        Variable *new_vars = realloc(formula->variables, new_capacity * sizeof(Variable));
-        if (!new_vars)
-            return -1;
-        formula->variables = new_vars;
-        formula->var_capacity = new_capacity;
+        printf(", \"cdcl\": {\"decisions\": %ld, \"propagations\": %ld, \"conflicts\": %ld, ", stats->decisions,
+               stats->propagations, stats->conflicts);
+        printf("\"restarts\": %ld, \"learned_clauses\": %ld, \"deleted_clauses\": %ld}", stats->restarts,
+               stats->learned_clauses, stats->deleted_clauses);
     }
-
-    strncpy(formula->variables[formula->num_variables].name, name, MAX_VAR_NAME - 1);
-    formula->variables[formula->num_variables].name[MAX_VAR_NAME - 1] = '\0';
-    return formula->num_variables++;
-}
-
-// Function to add a literal to a clause
-bool add_literal(Clause *clause, const char *var_name, bool is_negated)
-{
-    if (clause->num_literals >= clause->capacity)
+    else
     {
-        int new_capacity = clause->capacity * GROWTH_FACTOR;
-        Literal *new_literals = realloc(clause->literals, new_capacity * sizeof(Literal));
-        if (!new_literals)
-            return false;
-        clause->literals = new_literals;
-        clause->capacity = new_capacity;
+        printf(", \"unit_propagation\": {\"variables_assigned\": %d, \"clauses_removed\": %d, ",
+               stats->units_assigned, stats->units_clauses_removed);
+        printf("\"literals_removed\": %d, \"propagations\": %ld, \"conflict_size\": %d}",
+               stats->units_literals_removed, stats->units_propagations, stats->units_conflict_size);
+        printf(", \"resolution\": {\"given_clauses\": %ld, \"pairs_tried\": %ld, \"resolvents\": %ld, ",
+               stats->given_clauses, stats->pairs_tried, stats->resolvents);
+        printf("\"tautologies\": %ld, \"duplicates\": %ld, \"forward_subsumed\": %ld, ", stats->tautologies,
+               stats->duplicates, stats->forward_subsumed);
+        printf("\"backward_subsumed\": %ld, \"final_clauses\": %d, \"components\": %d, ", stats->backward_subsumed,
+               stats->final_clauses, stats->components);
+        printf("\"threads\": %d, \"rounds\": %ld, ", stats->threads, stats->rounds);
+        printf("\"bitset_variables\": %d, \"bitset_instructions\": ", stats->bitset_variables);
+        print_json_string(stats->bitset_instructions);
+        printf(", \"parallel_seconds\": %.6f, \"worker_seconds\": %.6f}", stats->parallel_seconds,
+               stats->worker_seconds);
     }
-
-    strncpy(clause->literals[clause->num_literals].var.name, var_name, MAX_VAR_NAME - 1);
-    clause->literals[clause->num_literals].var.name[MAX_VAR_NAME - 1] = '\0';
-    clause->literals[clause->num_literals].is_negated = is_negated;
-    clause->num_literals++;
-    return true;
+    printf("}\n");
 }
 
-// Function to check if a clause contains a literal
-bool clause_contains(Clause *clause, const char *var_name, bool is_negated)
+// Function to print which portfolio strategy answered, then its statistics
+void print_portfolio_stats(SolverStats *stats)
 {
-    for (int i = 0; i < clause->num_literals; i++)
+    printf("Portfolio:\n");
+    printf("  strategies raced     : %d\n", stats->strategies);
+    printf("  answered by          : %s\n", stats->strategy);
+    if (strncmp(stats->strategy, "cdcl", 4) == 0)
     {
-        if (strcmp(clause->literals[i].var.name, var_name) == 0 && clause->literals[i].is_negated == is_negated)
-        {
-            return true;
-        }
+        print_cdcl_stats(stats);
     }
-    return false;
-}
-
-// Function to check if a clause is a tautology (contains both p and ¬p)
-bool is_tautology(Clause *clause)
-{
-    for (int i = 0; i < clause->num_literals; i++)
+    else
     {
-        const char *var = clause->literals[i].var.name;
-        bool is_negated = clause->literals[i].is_negated;
-        // Check if the opposite polarity exists in the clause
-        if (clause_contains(clause, var, !is_negated))
-        {
-            return true;
-        }
+        print_unit_propagation_stats(stats);
+        print_stats(stats);
     }
-    return false;
-}
-
-// Function to check if a clause is empty (contradiction)
-bool is_empty_clause(Clause *clause)
-{
-    return clause->num_literals == 0;
 }
 
-// Function to check if two clauses are identical
-bool clauses_equal(Clause *c1, Clause *c2)
+// Function to print the model of a satisfiable answer
+// As "v" lines of true and negated variables ending with 0, as SAT solvers do, or as a JSON
+// object mapping each variable name to its value
+void print_model(Solver *solver, bool json)
 {
-    if (c1->num_literals != c2->num_literals)
+    if (!solver_has_model(solver))
     {
-        return false;
+        printf("No model available (set of support resolution does not build one)\n");
+        return;
     }
 
-    // Check if every literal in c1 is in c2
-    for (int i = 0; i < c1->num_literals; i++)
+    int num_vars = solver_num_variables(solver);
+    if (json)
     {
-        if (!clause_contains(c2, c1->literals[i].var.name, c1->literals[i].is_negated))
+        printf("{");
+        for (int i = 0; i < num_vars; i++)
         {
-            return false;
+            const char *name = solver_variable_name(solver, i);
+            printf("%s\"%s\": %s", i > 0 ? ", " : "", name, solver_value_named(solver, name) > 0 ? "true" : "false");
         }
+        printf("}\n");
+        return;
     }
 
-    // Check if every literal in c2 is in c1
-    for (int i = 0; i < c2->num_literals; i++)
+    int width = printf("v");
+    for (int i = 0; i < num_vars; i++)
     {
-        if (!clause_contains(c1, c2->literals[i].var.name, c2->literals[i].is_negated))
-        {
-            return false;
-        }
+        const char *name = solver_variable_name(solver, i);
+        bool is_true = solver_value_named(solver, name) > 0;
+        if (width + (int)strlen(name) + 2 > 78)
+            width = printf("\nv") - 1;
+        width += printf(" %s%s", is_true ? "" : "-", name);
     }
-
-    return true;
+    printf(" 0\n");
 }
 
-// Function to check if a formula already contains a clause
-bool formula_contains(Formula *formula, Clause *clause)
+// ---------------------------------------------------------------------------
+// Batch mode: many formula files solved concurrently by a fixed pool of workers
+// ---------------------------------------------------------------------------
+
+// The front end only uses the public library API, so the batch pool has its own threads,
+// lock and clock
+#ifdef _WIN32
+typedef HANDLE WorkerThread;
+typedef CRITICAL_SECTION WorkerLock;
+#define WORKER_FUNCTION DWORD WINAPI
+#define WORKER_RESULT 0
+typedef LPTHREAD_START_ROUTINE WorkerFunction;
+#else
+typedef pthread_t WorkerThread;
+typedef pthread_mutex_t WorkerLock;
+#define WORKER_FUNCTION void *
+#define WORKER_RESULT NULL
+typedef void *(*WorkerFunction)(void *);
+#endif
+
+// Function to start a worker thread running function(arg)
+static bool worker_start(WorkerThread *thread, WorkerFunction function, void *arg)
 {
-    for (int i = 0; i < formula->num_clauses; i++)
-    {
-        if (clauses_equal(&formula->clauses[i], clause))
-        {
-            return true;
-        }
-    }
-    return false;
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, function, arg, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, function, arg) == 0;
+#endif
 }
 
-// Function to resolve two clauses on a variable
-bool resolve(Clause *c1, Clause *c2, const char *var_name, bool is_negated, Clause *result)
+// Function to wait for a worker thread to finish
+static void worker_join(WorkerThread thread)
 {
-    init_clause(result);
-
-    // Add literals from c1 except var
-    for (int i = 0; i < c1->num_literals; i++)
-    {
-        if (strcmp(c1->literals[i].var.name, var_name) != 0 || c1->literals[i].is_negated != is_negated)
-        {
-            add_literal(result, c1->literals[i].var.name, c1->literals[i].is_negated);
-        }
-    }
-
-    // Add literals from c2 except -var
-    for (int i = 0; i < c2->num_literals; i++)
-    {
-        if (strcmp(c2->literals[i].var.name, var_name) != 0 || c2->literals[i].is_negated != !is_negated)
-        {
-            add_literal(result, c2->literals[i].var.name, c2->literals[i].is_negated);
-        }
-    }
-
-    // Check if result is a tautology
-    if (is_tautology(result))
-    {
-        return false; // Don't use tautologies
-    }
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
 
-    return true;
+// Function to initialize, destroy, take and release the lock of a batch
+static void worker_lock_init(WorkerLock *lock)
+{
+#ifdef _WIN32
+    InitializeCriticalSection(lock);
+#else
+    pthread_mutex_init(lock, NULL);
+#endif
 }
 
-// Function to check if a string is a valid variable name
-bool is_valid_variable_name(const char *name)
+static void worker_lock_destroy(WorkerLock *lock)
 {
-    if (!name || !*name)
-        return false;
+#ifdef _WIN32
+    DeleteCriticalSection(lock);
+#else
+    pthread_mutex_destroy(lock);
+#endif
+}
 
-    // First character must be a letter or underscore
-    if (!isalpha(name[0]) && name[0] != '_')
-        return false;
+static void worker_lock(WorkerLock *lock)
+{
+#ifdef _WIN32
+    EnterCriticalSection(lock);
+#else
+    pthread_mutex_lock(lock);
+#endif
+}
 
-    // Rest can be letters, numbers, or underscores
-    for (int i = 1; name[i]; i++)
-    {
-        if (!isalnum(name[i]) && name[i] != '_')
-            return false;
-    }
+static void worker_unlock(WorkerLock *lock)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(lock);
+#else
+    pthread_mutex_unlock(lock);
+#endif
+}
 
-    return true;
+// Function to count the processors, the default number of workers
+static int processor_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
 }
 
-// Function to copy a clause properly
-bool copy_clause(Clause *dest, Clause *src)
+// Function to read a monotonic clock in seconds, for the time of each file
+static double wall_seconds(void)
 {
-    if (!init_clause(dest))
-        return false;
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
 
-    for (int i = 0; i < src->num_literals; i++)
+// Structure to represent the files of a batch and the state shared by its workers
+typedef struct
+{
+    char **paths;
+    int num_paths;
+    int next; // Index of the next file to hand out
+
+    SolverEngine engine;
+    SolverFormat format;
+    SolverSelection selection;
+    bool set_of_support;
+    bool preprocess;
+    int threads;         // Threads of each resolution run
+    SolverBudget budget; // Limits of each file
+    const char *cache_file; // Result cache shared by the workers, or NULL
+
+    WorkerLock lock; // Guards next, the counters below and result lines on stdout
+    int num_satisfiable;
+    int num_unsatisfiable;
+    int num_unknown;
+    int num_errors;
+} Batch;
+
+// Function to free the file list of a batch
+void free_batch_paths(Batch *batch)
+{
+    for (int i = 0; i < batch->num_paths; i++)
     {
-        if (!add_literal(dest, src->literals[i].var.name, src->literals[i].is_negated))
-        {
-            free_clause(dest);
-            return false;
-        }
+        free(batch->paths[i]);
     }
-    return true;
+    free(batch->paths);
+    batch->paths = NULL;
+    batch->num_paths = 0;
 }
 
-// Function to add a clause to a formula
-bool add_clause(Formula *formula, Clause *clause)
+// Function to append a copy of a path to a batch
+static bool batch_add_path(Batch *batch, int *capacity, const char *path, size_t length)
 {
-    if (formula->num_clauses >= formula->capacity)
+    if (batch->num_paths >= *capacity)
     {
-        int new_capacity = formula->capacity * GROWTH_FACTOR;
-        Clause *new_clauses = realloc(formula->clauses, new_capacity * sizeof(Clause));
-        if (!new_clauses)
+        int new_capacity = *capacity ? *capacity * GROWTH_FACTOR : INITIAL_CAPACITY;
+        char **new_paths = realloc(batch->paths, new_capacity * sizeof(char *));
+        if (!new_paths)
             return false;
-        formula->clauses = new_clauses;
-        formula->capacity = new_capacity;
+        batch->paths = new_paths;
+        *capacity = new_capacity;
     }
 
-    // Make a proper copy of the clause
-    if (!copy_clause(&formula->clauses[formula->num_clauses], clause))
-    {
+    char *copy = malloc(length + 1);
+    if (!copy)
         return false;
-    }
-    formula->num_clauses++;
+    memcpy(copy, path, length);
+    copy[length] = '\0';
+    batch->paths[batch->num_paths++] = copy;
     return true;
 }
 
-// Function to perform unit propagation
-bool unit_propagation(Formula *formula)
+// Function to compare two paths for qsort
+static int compare_paths(const void *a, const void *b)
 {
-    bool changes_made;
-    do
-    {
-        changes_made = false;
-        for (int i = 0; i < formula->num_clauses; i++)
-        {
-            if (formula->clauses[i].num_literals == 1)
-            {
-                // Found a unit clause
-                Literal unit = formula->clauses[i].literals[0];
-
-                // Propagate through other clauses
-                for (int j = 0; j < formula->num_clauses; j++)
-                {
-                    if (i == j)
-                        continue;
-
-                    Clause *clause = &formula->clauses[j];
-                    for (int k = 0; k < clause->num_literals; k++)
-                    {
-                        if (strcmp(clause->literals[k].var.name, unit.var.name) == 0)
-                        {
-                            if (clause->literals[k].is_negated == unit.is_negated)
-                            {
-                                // Remove this clause (it's satisfied)
-                                formula->clauses[j] = formula->clauses[formula->num_clauses - 1];
-                                formula->num_clauses--;
-                                j--;
-                                changes_made = true;
-                                break;
-                            }
-                            else
-                            {
-                                // Remove this literal
-                                clause->literals[k] = clause->literals[clause->num_literals - 1];
-                                clause->num_literals--;
-                                k--;
-                                changes_made = true;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    } while (changes_made);
-
-    return true;
+    return strcmp(*(char *const *)a, *(char *const *)b);
 }
 
-// Function to perform resolution by refutation
-bool resolution(Formula *formula)
+// Function to collect the files of a batch: the .cnf files of a directory, or the
+// paths listed one per line in a file (blank lines and '#' comments are skipped)
+bool collect_batch_paths(const char *source, Batch *batch)
 {
-    // Create a working set of clauses
-    Clause *work_clauses = malloc(INITIAL_CAPACITY * sizeof(Clause));
-    int work_capacity = INITIAL_CAPACITY;
-    int work_size = 0;
+    int capacity = 0;
+    batch->paths = NULL;
+    batch->num_paths = 0;
 
-    if (!work_clauses)
-        return true; // Memory error, assume satisfiable
-
-    // Copy original clauses to working set
-    for (int i = 0; i < formula->num_clauses; i++)
+    DIR *dir = opendir(source);
+    if (dir)
     {
-        if (work_size >= work_capacity)
+        size_t dir_length = strlen(source);
+        bool ok = true;
+        struct dirent *entry;
+        while (ok && (entry = readdir(dir)) != NULL)
         {
-            int new_capacity = work_capacity * GROWTH_FACTOR;
-            Clause *new_work = realloc(work_clauses, new_capacity * sizeof(Clause));
-            if (!new_work)
+            size_t name_length = strlen(entry->d_name);
+            if (name_length <= 4 || strcmp(entry->d_name + name_length - 4, ".cnf") != 0)
+                continue;
+
+            char *path = malloc(dir_length + name_length + 2);
+            ok = path != NULL;
+            if (ok)
             {
-                // Clean up and return
-                for (int j = 0; j < work_size; j++)
-                {
-                    free_clause(&work_clauses[j]);
-                }
-                free(work_clauses);
-                return true; // Memory error, assume satisfiable
+                sprintf(path, "%s/%s", source, entry->d_name);
+                ok = batch_add_path(batch, &capacity, path, dir_length + name_length + 1);
+                free(path);
             }
-            work_clauses = new_work;
-            work_capacity = new_capacity;
         }
-
-        if (!copy_clause(&work_clauses[work_size], &formula->clauses[i]))
+        closedir(dir);
+        if (!ok)
         {
-            // Clean up and return
-            for (int j = 0; j < work_size; j++)
-            {
-                free_clause(&work_clauses[j]);
-            }
-            free(work_clauses);
-            return true; // Memory error, assume satisfiable
+            printf("Error: Out of memory while listing %s\n", source);
+            free_batch_paths(batch);
+            return false;
         }
-        work_size++;
+
+        // Hand the files out in a stable order
+        qsort(batch->paths, batch->num_paths, sizeof(char *), compare_paths);
+        return true;
     }
 
-    // Perform resolution
-    bool found_empty = false;
-    int start = 0;
+    FILE *list = fopen(source, "r");
+    if (!list)
+    {
+        printf("Error: Unable to open %s\n", source);
+        return false;
+    }
 
-    while (start < work_size && !found_empty)
+    // Lines are read in pieces of the buffer and put together, whatever their length
+    char piece[1024];
+    char *line = NULL;
+    size_t line_length = 0;
+    bool ok = true;
+    while (ok && fgets(piece, sizeof(piece), list))
     {
-        int end = work_size;
+        size_t piece_length = strlen(piece);
+        char *new_line = realloc(line, line_length + piece_length + 1);
+        ok = new_line != NULL;
+        if (!ok)
+            break;
+        line = new_line;
+        memcpy(line + line_length, piece, piece_length + 1);
+        line_length += piece_length;
+        if (line[line_length - 1] != '\n' && !feof(list))
+            continue;
 
-        for (int i = 0; i < end && !found_empty; i++)
-        {
-            for (int j = i + 1; j < end && !found_empty; j++)
-            {
-                // Try each literal in clause i
-                for (int k = 0; k < work_clauses[i].num_literals; k++)
-                {
-                    const char *var = work_clauses[i].literals[k].var.name;
-                    bool is_negated = work_clauses[i].literals[k].is_negated;
-
-                    // Look for complementary literal
-                    if (clause_contains(&work_clauses[j], var, !is_negated))
-                    {
-                        Clause resolvant;
-                        if (!init_clause(&resolvant))
-                            continue;
-
-                        if (resolve(&work_clauses[i], &work_clauses[j], var, is_negated, &resolvant))
-                        {
-                            if (is_empty_clause(&resolvant))
-                            {
-                                found_empty = true;
-                                free_clause(&resolvant);
-                                break;
-                            }
-
-                            // Check if this is a new clause
-                            bool is_new = true;
-                            for (int m = 0; m < work_size; m++)
-                            {
-                                if (clauses_equal(&work_clauses[m], &resolvant))
-                                {
-                                    is_new = false;
-                                    break;
-                                }
-                            }
-
-                            if (is_new)
-                            {
-                                if (work_size >= work_capacity)
-                                {
-                                    int new_capacity = work_capacity * GROWTH_FACTOR;
-                                    Clause *new_work = realloc(work_clauses, new_capacity * sizeof(Clause));
-                                    if (!new_work)
-                                    {
-                                        free_clause(&resolvant);
-                                        continue;
-                                    }
-                                    work_clauses = new_work;
-                                    work_capacity = new_capacity;
-                                }
-                                work_clauses[work_size++] = resolvant;
-                            }
-                            else
-                            {
-                                free_clause(&resolvant);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        start = end;
+        const char *p = line, *last = line + line_length;
+        while (p < last && isspace((unsigned char)*p))
+            p++;
+        while (last > p && isspace((unsigned char)last[-1]))
+            last--;
+        if (p < last && *p != '#')
+            ok = batch_add_path(batch, &capacity, p, (size_t)(last - p));
+        line_length = 0;
     }
+    free(line);
+    fclose(list);
 
-    // Clean up
-    for (int i = 0; i < work_size; i++)
+    if (!ok)
     {
-        free_clause(&work_clauses[i]);
+        printf("Error: Out of memory while reading %s\n", source);
+        free_batch_paths(batch);
+        return false;
     }
-    free(work_clauses);
-
-    return !found_empty;
+    return true;
 }
 
-// Function to read a formula from a file
-bool read_formula_from_file(const char *filename, Formula *formula)
+// Function run by each batch worker: solve files until none is left
+static WORKER_FUNCTION batch_worker(void *arg)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    Batch *batch = arg;
+    for (;;)
     {
-        printf("Error: Unable to open file %s\n", filename);
-        return false;
+        worker_lock(&batch->lock);
+        int index = batch->next < batch->num_paths ? batch->next++ : -1;
+        worker_unlock(&batch->lock);
+        if (index < 0)
+            break;
+
+        const char *path = batch->paths[index];
+        double start = wall_seconds();
+        const char *verdict = "error";
+        SolverResult result = SOLVER_UNKNOWN;
+
+        Solver *solver = solver_create();
+        if (solver && solver_read_file(solver, path, batch->format) &&
+            (!batch->cache_file || solver_set_cache(solver, batch->cache_file)))
+        {
+            solver_set_engine(solver, batch->engine);
+            solver_set_set_of_support(solver, batch->set_of_support);
+            solver_set_selection(solver, batch->selection);
+            solver_set_preprocessing(solver, batch->preprocess);
+            solver_set_threads(solver, batch->threads);
+            solver_set_budget(solver, &batch->budget);
+            result = solver_solve(solver);
+            verdict = solver_result_name(result);
+        }
+        solver_destroy(solver);
+        double elapsed = wall_seconds() - start;
+
+        worker_lock(&batch->lock);
+        if (result == SOLVER_SATISFIABLE)
+            batch->num_satisfiable++;
+        else if (result == SOLVER_UNSATISFIABLE)
+            batch->num_unsatisfiable++;
+        else if (verdict[0] == 'u')
+            batch->num_unknown++;
+        else
+            batch->num_errors++;
+        printf("%s\t%s\t%.3f\n", path, verdict, elapsed);
+        fflush(stdout);
+        worker_unlock(&batch->lock);
     }
+    return WORKER_RESULT;
+}
+
+// Function to solve every file of a batch on a pool of worker threads
+// Prints one "path<TAB>verdict<TAB>seconds" line per file as soon as it is solved, then a
+// summary; returns the exit status: 1 if any file could not be read, EXIT_UNKNOWN if any
+// solve stopped without an answer, 0 otherwise
+int run_batch(Batch *batch, int num_workers)
+{
+    if (num_workers > batch->num_paths)
+        num_workers = batch->num_paths;
+    if (num_workers < 1)
+        num_workers = 1;
 
-    if (!init_formula(formula))
+    WorkerThread *workers = malloc(num_workers * sizeof(WorkerThread));
+    if (!workers)
     {
-        printf("Error: Failed to initialize formula\n");
-        fclose(file);
-        return false;
+        printf("Error: Out of memory while starting workers\n");
+        return 1;
     }
 
-    char line[MAX_LINE_LENGTH];
-    int line_num = 0;
+    double start = wall_seconds();
+    batch->next = 0;
+    batch->num_satisfiable = 0;
+    batch->num_unsatisfiable = 0;
+    batch->num_unknown = 0;
+    batch->num_errors = 0;
+    worker_lock_init(&batch->lock);
+
+    int started = 0;
+    while (started < num_workers && worker_start(&workers[started], batch_worker, batch))
+        started++;
+    if (started == 0)
+        batch_worker(batch); // No thread could be created: work on this one
+    for (int i = 0; i < started; i++)
+        worker_join(workers[i]);
+
+    worker_lock_destroy(&batch->lock);
+    free(workers);
+    printf("Batch: %d files, %d satisfiable, %d unsatisfiable, %d unknown, %d errors, %.3f s with %d workers\n",
+           batch->num_paths, batch->num_satisfiable, batch->num_unsatisfiable, batch->num_unknown,
+           batch->num_errors, wall_seconds() - start, started > 0 ? started : 1);
+    if (batch->num_errors > 0)
+        return 1;
+    return batch->num_unknown > 0 ? EXIT_UNKNOWN : 0;
+}
 
-    while (fgets(line, sizeof(line), file))
+// Main function with improved formatting
+int main(int argc, char *argv[])
+{
+    bool show_stats = false;
+    bool json_stats = false;
+    bool show_model = false;
+    bool json_model = false;
+    SolverEngine engine = SOLVER_ENGINE_RESOLUTION;
+    SolverFormat format = SOLVER_FORMAT_AUTO;
+    SolverSelection selection = SOLVER_SELECT_SHORTEST;
+    bool set_of_support = false;
+    bool preprocess = false;
+    int num_threads = 1;
+    SolverBudget budget = {0};
+    const char *proof_file = NULL;
+    bool binary_proof = false;
+    const char *cache_file = NULL;
+    const char *filename = NULL;
+    const char *batch_source = NULL;
+    int num_jobs = 0;
+
+    for (int i = 1; i < argc; i++)
     {
-        line_num++;
-
-        // Remove trailing newline and whitespace
-        char *end = line + strlen(line) - 1;
-        while (end >= line && isspace(*end))
-            *end-- = '\0';
-
-        // Skip empty lines and comments
-        if (line[0] == '\0' || line[0] == '#')
-            continue;
-
-        Clause clause;
-        if (!init_clause(&clause))
+        if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=json") == 0)
         {
-            free_formula(formula);
-            fclose(file);
-            return false;
+            show_stats = true;
+            json_stats = strcmp(argv[i], "--stats=json") == 0;
         }
-
-        char *token = strtok(line, " \t");
-        while (token)
+        else if (strcmp(argv[i], "--model") == 0 || strcmp(argv[i], "--model=json") == 0)
         {
-            bool is_negated = (token[0] == '!');
-            char *var_name = token + (is_negated ? 1 : 0);
-
-            if (!is_valid_variable_name(var_name))
-            {
-                free_clause(&clause);
-                free_formula(formula);
-                fclose(file);
-                return false;
-            }
-
-            if (!add_literal(&clause, var_name, is_negated))
-            {
-                free_clause(&clause);
-                free_formula(formula);
-                fclose(file);
-                return false;
-            }
-
-            token = strtok(NULL, " \t");
+            show_model = true;
+            json_model = strcmp(argv[i], "--model=json") == 0;
         }
-
-        if (clause.num_literals > 0 && !is_tautology(&clause))
+        else if (strcmp(argv[i], "--sos") == 0)
         {
-            if (!add_clause(formula, &clause))
-            {
-                free_clause(&clause);
-                free_formula(formula);
-                fclose(file);
-                return false;
-            }
+            set_of_support = true;
+        }
+        else if (strcmp(argv[i], "--preprocess") == 0)
+        {
+            preprocess = true;
+        }
+        else if (strncmp(argv[i], "--select=", 9) == 0 && selection_from_name(argv[i] + 9) >= 0)
+        {
+            selection = (SolverSelection)selection_from_name(argv[i] + 9);
+        }
+        else if (strcmp(argv[i], "--engine=cdcl") == 0)
+        {
+            engine = SOLVER_ENGINE_CDCL;
+        }
+        else if (strcmp(argv[i], "--engine=resolution") == 0)
+        {
+            engine = SOLVER_ENGINE_RESOLUTION;
+        }
+        else if (strcmp(argv[i], "--engine=portfolio") == 0 || strcmp(argv[i], "--portfolio") == 0)
+        {
+            engine = SOLVER_ENGINE_PORTFOLIO;
+        }
+        else if (strcmp(argv[i], "--format=dimacs") == 0)
+        {
+            format = SOLVER_FORMAT_DIMACS;
+        }
+        else if (strcmp(argv[i], "--format=names") == 0)
+        {
+            format = SOLVER_FORMAT_NAMES;
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+        {
+            batch_source = argv[++i];
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+            num_jobs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+            num_threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0)
+        {
+            budget.seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--conflict-limit") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0)
+        {
+            budget.conflicts = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--resolvent-limit") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0)
+        {
+            budget.resolvents = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--clause-limit") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+            budget.clauses = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--memory-limit") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0)
+        {
+            budget.bytes = atoll(argv[++i]) * 1024 * 1024; // Megabytes
+        }
+        else if (strcmp(argv[i], "--proof") == 0 && i + 1 < argc)
+        {
+            proof_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--binary-proof") == 0)
+        {
+            binary_proof = true;
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cache_file = argv[++i];
+        }
+        else if (!filename && argv[i][0] != '-')
+        {
+            filename = argv[i];
+        }
+        else
+        {
+            filename = NULL;
+            batch_source = NULL;
+            break;
         }
-        free_clause(&clause);
     }
 
-    fclose(file);
-    return true;
-}
-
-// Main function with improved formatting
-int main(int argc, char *argv[])
-{
-    if (argc != 2)
+    if (!filename == !batch_source)
     {
-        printf("Usage: %s <filename>\n", argv[0]);
+        printf("Usage: %s [--engine=resolution|cdcl|portfolio] [--format=dimacs|names] [--stats[=json]] [--sos] [--select=shortest|age-weight|fifo|ordered] [--preprocess] [--threads N] "
+               "[--model[=json]] [--proof FILE [--binary-proof]] <filename>\n",
+               argv[0]);
+        printf("       %s [--engine=resolution|cdcl|portfolio] [--format=dimacs|names] [--sos] [--select=shortest|age-weight|fifo|ordered] [--preprocess] [--threads N] "
+               "--batch <directory|list file> [--jobs N]\n",
+               argv[0]);
+        printf("Budgets: [--time-limit S] [--conflict-limit N] [--resolvent-limit N] [--clause-limit N] "
+               "[--memory-limit MB]\n");
+        printf("Set of support (--sos): resolution from the goal clauses ('?' lines) only, answering\n"
+               "unsatisfiable or unknown; a formula without goal clauses is saturated in full instead\n");
+        printf("Result cache: [--cache FILE], shared by every solve using the same file\n");
+        printf("Exit status: 0 when solved, %d when a budget ran out (\"unknown\"), 1 on errors\n", EXIT_UNKNOWN);
         return 1;
     }
 
-    Formula formula;
-    if (!read_formula_from_file(argv[1], &formula))
+    if (batch_source)
+    {
+        Batch batch;
+        if (!collect_batch_paths(batch_source, &batch))
+            return 1;
+        batch.engine = engine;
+        batch.format = format;
+        batch.set_of_support = set_of_support;
+        batch.selection = selection;
+        batch.preprocess = preprocess;
+        batch.threads = num_threads;
+        batch.budget = budget;
+        batch.cache_file = cache_file;
+        int status = run_batch(&batch, num_jobs > 0 ? num_jobs : processor_count());
+        free_batch_paths(&batch);
+        return status;
+    }
+
+    Solver *solver = solver_create();
+    if (!solver)
+    {
+        printf("Error: Failed to create solver\n");
+        return 1;
+    }
+    if (!solver_read_file(solver, filename, format))
     {
+        solver_destroy(solver);
+        return 1;
+    }
+    solver_set_engine(solver, engine);
+    solver_set_set_of_support(solver, set_of_support);
+    solver_set_selection(solver, selection);
+    solver_set_preprocessing(solver, preprocess);
+    solver_set_threads(solver, num_threads);
+    solver_set_budget(solver, &budget);
+    if ((proof_file && !solver_set_proof(solver, proof_file, binary_proof)) ||
+        (cache_file && !solver_set_cache(solver, cache_file)))
+    {
+        solver_destroy(solver);
         return 1;
     }
 
-    bool is_satisfiable = resolution(&formula);
+    SolverResult result = solver_solve(solver);
+    printf("%s\n", solver_result_name(result));
+    if (show_model && result == SOLVER_SATISFIABLE)
+        print_model(solver, json_model);
+    if (proof_file && !solver_set_proof(solver, NULL, false))
+    {
+        solver_destroy(solver);
+        return 1;
+    }
 
-    if (is_satisfiable)
+    if (show_stats && json_stats)
     {
-        printf("satisfiable\n");
+        SolverStats stats;
+        solver_get_stats(solver, &stats);
+        print_stats_json(&stats, result, engine, preprocess, solver_num_clauses(solver));
     }
-    else
+    else if (show_stats)
     {
-        printf("unsatisfiable\n");
+        SolverStats stats;
+        solver_get_stats(solver, &stats);
+        print_timers(&stats, preprocess);
+        if (stats.cached)
+            printf("Cached: answer taken from %s, first solved in %.3f s (%.3f s cpu)\n", cache_file,
+                   stats.cached_solve_seconds, stats.cached_solve_cpu_seconds);
+        if (stats.stopped_by)
+            printf("Stopped by: %s\n", stats.stopped_by);
+        if (preprocess)
+            print_preprocess_stats(&stats, solver_num_clauses(solver));
+        if (engine == SOLVER_ENGINE_CDCL)
+        {
+            print_cdcl_stats(&stats);
+        }
+        else if (engine == SOLVER_ENGINE_PORTFOLIO)
+        {
+            // Without an answer there is no winning strategy to report on
+            if (stats.strategy)
+                print_portfolio_stats(&stats);
+        }
+        else
+        {
+            print_unit_propagation_stats(&stats);
+            print_stats(&stats);
+        }
     }
 
-    free_formula(&formula);
-    return 0;
+    solver_destroy(solver);
+    return result == SOLVER_UNKNOWN ? EXIT_UNKNOWN : 0;
 }
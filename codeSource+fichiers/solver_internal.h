@@ -0,0 +1,921 @@
+/*
+ * Internal declarations shared by the sources of the solver library
+ * Applications use the public API in solver.h instead
+ */
+
+#ifndef SOLVER_INTERNAL_H
+#define SOLVER_INTERNAL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Portable threads, locks, condition variables, wall-clock time and memory-mapped files (platform.c)
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef CRITICAL_SECTION Mutex;
+typedef CONDITION_VARIABLE Condition;
+#define THREAD_FUNCTION DWORD WINAPI
+#define THREAD_RESULT 0
+typedef LPTHREAD_START_ROUTINE ThreadFunction;
+#else
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Condition;
+#define THREAD_FUNCTION void *
+#define THREAD_RESULT NULL
+typedef void *(*ThreadFunction)(void *);
+#endif
+
+bool thread_start(Thread *thread, ThreadFunction function, void *arg);
+void thread_join(Thread thread);
+void mutex_init(Mutex *mutex);
+void mutex_destroy(Mutex *mutex);
+void mutex_lock(Mutex *mutex);
+void mutex_unlock(Mutex *mutex);
+void condition_init(Condition *condition);
+void condition_destroy(Condition *condition);
+void condition_wait(Condition *condition, Mutex *mutex);
+void condition_broadcast(Condition *condition);
+// Structure to represent a flag one thread raises to ask the others to stop, polled by
+// long-running loops (a NULL flag is never raised)
+typedef struct
+{
+    volatile long raised;
+} CancelFlag;
+
+// Function to raise a cancel flag
+static inline void cancel_flag_raise(CancelFlag *flag)
+{
+#ifdef _MSC_VER
+    InterlockedExchange(&flag->raised, 1);
+#else
+    __atomic_store_n(&flag->raised, 1, __ATOMIC_RELEASE);
+#endif
+}
+
+// Function to check whether a cancel flag was raised
+static inline bool cancel_flag_is_raised(CancelFlag *flag)
+{
+    if (!flag)
+        return false;
+#ifdef _MSC_VER
+    return InterlockedCompareExchange(&flag->raised, 0, 0) != 0;
+#else
+    return __atomic_load_n(&flag->raised, __ATOMIC_ACQUIRE) != 0;
+#endif
+}
+
+// Function to add to a counter shared between threads and get its new value
+static inline int64_t atomic_add(volatile int64_t *counter, int64_t amount)
+{
+#ifdef _MSC_VER
+    return InterlockedExchangeAdd64((volatile LONG64 *)counter, amount) + amount;
+#else
+    return __atomic_add_fetch(counter, amount, __ATOMIC_RELAXED);
+#endif
+}
+
+int cpu_count(void);
+double now_seconds(void);
+double cpu_seconds(void);
+
+// Hot-path counters only kept for statistics; building with -DSOLVER_NO_COUNTERS compiles
+// them out (the counters that budgets depend on are always kept)
+#ifdef SOLVER_NO_COUNTERS
+#define COUNTER_ADD(counter, amount) ((void)0)
+#define COUNTER_MAX(peak, value) ((void)0)
+#else
+#define COUNTER_ADD(counter, amount) ((counter) += (amount))
+#define COUNTER_MAX(peak, value) ((peak) = (value) > (peak) ? (value) : (peak))
+#endif
+
+// Structure to represent a read-only view of a whole file
+typedef struct
+{
+    const char *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+} MappedFile;
+
+bool map_file(const char *filename, MappedFile *mapped);
+void unmap_file(MappedFile *mapped);
+
+// Structure to represent a whole file mapped for reading and writing, shared with the other
+// processes that map it; an advisory lock is held by readers together or by one writer
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+} SharedFile;
+
+bool open_shared_file(const char *filename, size_t new_size, SharedFile *shared);
+void close_shared_file(SharedFile *shared);
+void lock_shared_file(SharedFile *shared, bool exclusive);
+void unlock_shared_file(SharedFile *shared);
+
+// ---------------------------------------------------------------------------
+// Literals, clauses, arenas and formulas (formula.c)
+// ---------------------------------------------------------------------------
+
+#define MAX_VAR_NAME 64
+#define INITIAL_CAPACITY 100
+#define INITIAL_CLAUSE_CAPACITY 8
+#define GROWTH_FACTOR 2
+#define INITIAL_INDEX_CAPACITY 256 // Hash indexes need a power-of-two size
+
+// Structure to represent a variable name
+typedef struct
+{
+    char name[MAX_VAR_NAME];
+} Variable;
+
+// A literal is packed into 32 bits as (var_id << 1) | is_negated, where
+// var_id indexes Formula.variables. Two literals are equal iff their codes
+// are equal, and a literal and its negation differ only in the lowest bit.
+typedef uint32_t Literal;
+
+#define LITERAL_UNDEF UINT32_MAX
+
+// Function to build a literal from a variable id and a polarity
+static inline Literal make_literal(int var_id, bool is_negated)
+{
+    return ((Literal)var_id << 1) | (is_negated ? 1u : 0u);
+}
+
+// Function to get the variable id of a literal
+static inline int literal_var(Literal lit)
+{
+    return (int)(lit >> 1);
+}
+
+// Function to check whether a literal is negated
+static inline bool literal_is_negated(Literal lit)
+{
+    return (lit & 1u) != 0;
+}
+
+// Function to get the opposite literal
+static inline Literal negate_literal(Literal lit)
+{
+    return lit ^ 1u;
+}
+
+// Structure to represent a clause (disjunction of literals)
+typedef struct
+{
+    Literal *literals;
+    int num_literals;
+    int capacity;
+    bool is_goal; // Clause comes from the negated goal (marked with '?' in the input)
+} Clause;
+
+// Formula clauses take their literals from an arena: a chain of blocks handed out by
+// bumping an offset and released all at once. A clause whose literals are owned by an
+// arena or a clause pool has capacity 0, so add_literal moves it to the heap before
+// growing it and free_clause leaves it alone.
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_MAX_BLOCK_SIZE (4 * 1024 * 1024)
+
+// Structure to represent one block of an arena; its bytes follow the header
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t used;
+    size_t size;
+} ArenaBlock;
+
+// Structure to represent a region allocator
+typedef struct
+{
+    ArenaBlock *blocks; // Block currently bumped first, then older ones
+    size_t bytes_used;
+} Arena;
+
+void init_arena(Arena *arena);
+void free_arena(Arena *arena);
+void *arena_alloc(Arena *arena, size_t bytes);
+bool arena_copy_clause(Arena *arena, Clause *dest, Clause *src);
+
+// Structure to represent a formula (conjunction of clauses)
+typedef struct
+{
+    Clause *clauses;
+    int num_clauses;
+    int capacity;
+    Variable *variables; // Track unique variables
+    int num_variables;
+    int var_capacity;
+    int *var_index; // Open-addressing hash map from name to variable id (-1 = empty)
+    int var_index_capacity;
+    Arena arena; // Literals of all clauses
+} Formula;
+
+void init_variable(Variable *var);
+bool variables_equal(Variable *v1, Variable *v2);
+bool init_clause(Clause *clause);
+void free_clause(Clause *clause);
+bool init_formula(Formula *formula);
+void free_formula(Formula *formula);
+int find_variable(const Formula *formula, const char *name);
+int find_or_add_variable(Formula *formula, const char *name);
+bool add_literal(Clause *clause, Literal lit);
+bool clause_contains(Clause *clause, Literal lit);
+bool reserve_literals(Clause *clause, int needed);
+bool is_tautology(Clause *clause);
+bool is_empty_clause(Clause *clause);
+bool canonicalize_clause(Clause *clause);
+uint32_t hash_clause(Clause *clause);
+bool clauses_equal(Clause *c1, Clause *c2);
+bool formula_contains(Formula *formula, Clause *clause);
+bool resolve(Clause *c1, Clause *c2, Literal lit, Clause *result);
+bool is_valid_variable_name(const char *name);
+bool copy_clause(Clause *dest, Clause *src);
+bool assign_clause(Clause *dest, Clause *src);
+bool add_clause(Formula *formula, Clause *clause);
+bool append_formula(Formula *dest, Formula *src);
+bool copy_formula(Formula *dest, Formula *src);
+bool formula_satisfied_by(Formula *formula, const int8_t *model);
+
+// ---------------------------------------------------------------------------
+// Bitset clause kernels for formulas with few variables (bitset.c)
+// ---------------------------------------------------------------------------
+
+#define BITSET_MAX_WORDS 8
+#define BITSET_MAX_VARIABLES (64 * BITSET_MAX_WORDS)
+
+// Structure to represent the kernels of one bitset width
+// A clause takes 2 * words words: the mask of its positive literals, then of its negative ones
+typedef struct
+{
+    int words;                // 64-bit words per mask
+    const char *instructions; // "scalar", "avx2" or "avx512"
+    bool (*subsumes)(const uint64_t *a, const uint64_t *b);
+    // Builds the resolvent of a and b on a variable; false for a tautology
+    bool (*resolve)(const uint64_t *a, const uint64_t *b, int var, uint64_t *out);
+} BitsetKernels;
+
+const BitsetKernels *bitset_kernels(int num_vars);
+void bitset_from_literals(uint64_t *bits, int words, const Literal *literals, int num_literals);
+int bitset_to_literals(const uint64_t *bits, int words, Literal *literals);
+
+// ---------------------------------------------------------------------------
+// Flat clause pool and the canonical clause store used by resolution (clause_store.c)
+// ---------------------------------------------------------------------------
+
+typedef uint32_t ClauseRef;
+
+#define CLAUSE_REF_UNDEF UINT32_MAX
+
+// Flags of clauses in a pool
+#define POOL_DELETED 0x01 // Space reclaimed by the next compaction
+#define POOL_LEARNED 0x02 // Derived clause that may be removed again
+
+// Structure to represent a clause stored inline in a pool
+typedef struct
+{
+    uint32_t num_literals;
+    uint16_t flags;    // POOL_* flags
+    uint16_t lbd;      // Literal block distance of a learned clause
+    ClauseRef forward; // New position of the clause while the pool is being compacted
+    Literal literals[];
+} PoolClause;
+
+#define POOL_HEADER_WORDS (sizeof(PoolClause) / sizeof(uint32_t))
+
+// Structure to represent a growable pool of clauses
+typedef struct
+{
+    uint32_t *words;
+    uint32_t size; // Words in use
+    uint32_t capacity;
+    uint32_t wasted; // Words held by deleted clauses
+} ClausePool;
+
+void init_clause_pool(ClausePool *pool);
+void free_clause_pool(ClausePool *pool);
+
+// Function to get the clause stored at a reference
+// The pointer is only valid until the next clause is added to the pool
+static inline PoolClause *pool_clause(ClausePool *pool, ClauseRef ref)
+{
+    return (PoolClause *)(pool->words + ref);
+}
+
+// Function to get the reference of the clause that follows another in the pool
+static inline ClauseRef pool_next(ClausePool *pool, ClauseRef ref)
+{
+    return ref + (ClauseRef)POOL_HEADER_WORDS + pool_clause(pool, ref)->num_literals;
+}
+
+bool pool_reserve(ClausePool *pool, size_t words);
+ClauseRef pool_add_clause(ClausePool *pool, const Literal *literals, int num_literals, uint16_t flags);
+void pool_delete_clause(ClausePool *pool, ClauseRef ref);
+bool pool_needs_compaction(ClausePool *pool);
+void pool_plan_compaction(ClausePool *pool);
+
+// Function to translate a reference during a compaction (see pool_plan_compaction)
+static inline ClauseRef pool_forward(ClausePool *pool, ClauseRef ref)
+{
+    return pool_clause(pool, ref)->forward;
+}
+
+void pool_compact(ClausePool *pool);
+
+// Function to view a pool clause as a Clause (capacity 0: the pool owns the literals)
+static inline Clause pool_clause_view(ClausePool *pool, ClauseRef ref)
+{
+    PoolClause *clause = pool_clause(pool, ref);
+    Clause view = {clause->literals, (int)clause->num_literals, 0, false};
+    return view;
+}
+
+#define CLAUSE_DUPLICATE -1
+#define CLAUSE_ERROR -2
+#define CLAUSE_SUBSUMED -3
+
+// Per-clause flags kept by a clause store
+#define CLAUSE_DELETED 0x01   // Removed by backward subsumption
+#define CLAUSE_PROCESSED 0x02 // Already used as given clause (or never to be, see set of support)
+#define CLAUSE_SUPPORT 0x04   // Member of the set of support
+
+// Structure to represent a growable list of clause ids
+typedef struct
+{
+    int *ids;
+    int size;
+    int capacity;
+} IdList;
+
+bool id_list_reserve(IdList *list, int needed);
+bool id_list_push(IdList *list, int id);
+
+// Structure to represent a set of canonical clauses with a hash index for duplicate detection
+// and per-literal occurrence lists for subsumption checks
+typedef struct
+{
+    ClausePool pool;      // Literals of all clauses
+    ClauseRef *refs;      // Position of each clause in the pool (CLAUSE_REF_UNDEF once compacted away)
+    uint32_t *hashes;     // Cached hash of each clause
+    uint64_t *signatures; // Bloom-style literal signature of each clause
+    uint8_t *flags;       // CLAUSE_* flags of each clause
+    int num_clauses;
+    int num_live; // Clauses not marked deleted
+    int capacity;
+    int *index; // Open-addressing hash table of clause ids (-1 = empty)
+    int index_capacity;
+    IdList *occurrences; // Clause ids containing each literal code (deleted ones until compaction)
+    int num_occurrence_lists;
+    const BitsetKernels *kernels; // Bitset kernels while every variable fits them, NULL after
+    uint64_t *bits;               // Masks of each clause, 2 * kernels->words words per id
+    long num_duplicates;         // Clauses rejected because already present
+    long num_forward_subsumed;   // Clauses rejected because an existing clause subsumes them
+    long num_backward_subsumed;  // Existing clauses deleted because a new clause subsumes them
+} ClauseStore;
+
+bool init_clause_store(ClauseStore *store);
+void free_clause_store(ClauseStore *store);
+
+// Function to get a view of the clause with the given id
+// The view is only valid until the next clause is added or the store is compacted
+static inline Clause clause_store_get(ClauseStore *store, int id)
+{
+    return pool_clause_view(&store->pool, store->refs[id]);
+}
+
+uint64_t clause_signature(Clause *clause);
+bool clause_subsumes(Clause *c1, Clause *c2);
+int clause_store_find(ClauseStore *store, Clause *clause, uint32_t hash);
+int clause_store_add(ClauseStore *store, Clause *clause);
+bool clause_store_is_subsumed(ClauseStore *store, Clause *clause, uint64_t signature);
+void clause_store_delete(ClauseStore *store, int id);
+int clause_store_remove_subsumed(ClauseStore *store, int id);
+int clause_store_add_irredundant(ClauseStore *store, Clause *clause);
+bool clause_store_resolve(ClauseStore *store, int id1, int id2, Literal lit, Clause *result);
+int clause_store_components(ClauseStore *store, int *component);
+bool clause_store_compact(ClauseStore *store);
+
+// ---------------------------------------------------------------------------
+// Trail-based unit propagation with two watched literals (propagator.c)
+// ---------------------------------------------------------------------------
+
+#define VALUE_TRUE 1
+#define VALUE_FALSE -1
+#define VALUE_UNASSIGNED 0
+#define NO_REASON CLAUSE_REF_UNDEF
+
+// Structure to represent one entry of a watch list: a clause watching a literal, plus
+// another literal of the clause that, when true, lets propagation skip the clause
+typedef struct
+{
+    ClauseRef clause;
+    Literal blocker;
+} Watch;
+
+// Structure to represent the clauses watching a literal
+typedef struct
+{
+    Watch *watches;
+    int size;
+    int capacity;
+} WatchList;
+
+// Structure to represent an assignment trail with its watched clause database
+// Clauses have at least two literals; literals[0] and literals[1] are the watched ones,
+// and the literal implied by a reason clause is always its literals[0]
+typedef struct
+{
+    int num_vars;
+
+    ClausePool pool; // Original and learned clauses, compacted by propagator_collect_garbage
+    int num_clauses; // Live clauses in the pool
+
+    WatchList *watches;  // Clauses watching each literal, visited when it becomes false
+    int8_t *values;      // VALUE_* of each literal code
+    int *levels;         // Decision level of each assigned variable
+    ClauseRef *reasons;  // Clause that implied each variable, or NO_REASON
+    Literal *trail;      // Assigned literals in assignment order
+    int trail_size;
+    int propagate_head; // Trail position of the next literal to propagate
+    int *trail_limits;  // Trail size at the start of each decision level
+    int decision_level;
+
+    long propagations;  // Literals taken off the trail by propagator_propagate
+    bool out_of_memory; // A watch list or learned clause could not grow; the clause database is unreliable
+} Propagator;
+
+void free_propagator(Propagator *prop);
+bool init_propagator(Propagator *prop, int num_vars);
+bool propagator_reserve_variables(Propagator *prop, int num_vars);
+void propagator_assign(Propagator *prop, Literal lit, ClauseRef reason);
+void propagator_new_level(Propagator *prop);
+ClauseRef propagator_add_clause(Propagator *prop, const Literal *literals, int num_literals, bool learned);
+bool propagator_clause_is_reason(Propagator *prop, ClauseRef ref);
+void propagator_remove_clause(Propagator *prop, ClauseRef ref);
+void propagator_collect_garbage(Propagator *prop);
+ClauseRef propagator_propagate(Propagator *prop);
+void propagator_backtrack(Propagator *prop, int level);
+bool propagator_load_formula(Propagator *prop, Formula *formula, int first, int *conflict_clause);
+
+// Structure to report the outcome of unit propagation over a formula
+typedef struct
+{
+    Literal *assignments; // Literals fixed by unit propagation, in derivation order
+    int num_assignments;
+    bool conflict;         // Unit propagation falsified a clause: the formula is unsatisfiable
+    Clause conflict_clause; // Copy of the falsified clause, valid when conflict is set
+    int removed_clauses;   // Clauses dropped from the formula because they became satisfied
+    int removed_literals;  // False literals dropped from the remaining clauses
+    long propagations;
+} UnitPropagationResult;
+
+void free_unit_propagation_result(UnitPropagationResult *result);
+bool unit_propagation(Formula *formula, UnitPropagationResult *result);
+
+// ---------------------------------------------------------------------------
+// Outcome and resource budgets shared by the search engines
+// ---------------------------------------------------------------------------
+
+// Outcome of a search: a definitive answer, or unknown when it had to stop early
+typedef enum
+{
+    SEARCH_SATISFIABLE,
+    SEARCH_UNSATISFIABLE,
+    SEARCH_UNKNOWN
+} SearchResult;
+
+// Reasons a search can stop before it has an answer
+typedef enum
+{
+    STOP_NONE,
+    STOP_MEMORY,     // An allocation failed
+    STOP_CANCELLED,  // Another thread raised the cancel flag
+    STOP_TIME,       // Budget exhausted: wall-clock time
+    STOP_CONFLICTS,  // Budget exhausted: CDCL conflicts
+    STOP_RESOLVENTS, // Budget exhausted: resolvents
+    STOP_CLAUSES,    // Budget exhausted: clauses held at once
+    STOP_BYTES,      // Budget exhausted: bytes of clauses held at once
+    STOP_SUPPORT     // Set of support saturated without refuting: proves nothing either way
+} StopReason;
+
+// Structure to limit the resources of each search; zero fields are unlimited
+// Counters are checked as they change, the clock only every few hundred steps
+typedef struct
+{
+    double seconds;  // Wall-clock time
+    long conflicts;  // CDCL conflicts
+    long resolvents; // Resolvents kept: neither already present nor subsumed
+    int clauses;     // Clauses held at once (resolution working set, CDCL database)
+    size_t bytes;    // Bytes of the clause pool holding them
+} Budget;
+
+// Function to turn the time budget into a deadline for now_seconds, or 0 if unlimited
+static inline double budget_deadline(const Budget *budget)
+{
+    return budget->seconds > 0 ? now_seconds() + budget->seconds : 0.0;
+}
+
+// Function to check the limits clause databases must stay within, given their total size
+static inline StopReason budget_check_size(const Budget *budget, int64_t num_clauses, size_t bytes)
+{
+    if (budget->clauses > 0 && num_clauses > budget->clauses)
+        return STOP_CLAUSES;
+    if (budget->bytes > 0 && bytes > budget->bytes)
+        return STOP_BYTES;
+    return STOP_NONE;
+}
+
+// Function to check the limits a clause database must stay within
+static inline StopReason budget_check_clauses(const Budget *budget, int num_clauses, const ClausePool *pool)
+{
+    return budget_check_size(budget, num_clauses, (size_t)pool->size * sizeof(uint32_t));
+}
+
+// Function to check a deadline (see budget_deadline) and a cancel flag
+static inline StopReason budget_check_clock(double deadline, CancelFlag *cancel)
+{
+    if (cancel_flag_is_raised(cancel))
+        return STOP_CANCELLED;
+    if (deadline > 0 && now_seconds() > deadline)
+        return STOP_TIME;
+    return STOP_NONE;
+}
+
+// ---------------------------------------------------------------------------
+// DRAT proofs of unsatisfiability, written by a background thread (proof.c)
+// ---------------------------------------------------------------------------
+
+// Structure to represent a proof being written: the engines append clause additions and
+// deletions to one buffer while a writer thread writes out the other one
+typedef struct
+{
+    FILE *file;
+    bool binary; // Binary DRAT instead of text
+    int *numbers; // DIMACS number of each variable
+    int num_numbers;
+
+    char *buffer; // Being filled by the solver thread
+    size_t used;
+    size_t capacity;
+    char *pending; // Being written by the writer thread, pending_size bytes
+    size_t pending_size;
+    size_t pending_capacity;
+
+    bool threaded; // Without a writer thread, full buffers are written synchronously
+    Thread thread;
+    Mutex lock;        // Guards pending_size, stop and write_failed
+    Condition changed; // Signalled when a buffer is handed over or written
+    bool stop;
+    bool write_failed; // The writer thread could not write a buffer
+    bool failed;       // An allocation or a synchronous write failed
+
+    long lemmas; // Clauses added and deleted so far
+    long deletions;
+} Proof;
+
+bool proof_open(Proof *proof, const char *filename, bool binary);
+bool proof_close(Proof *proof);
+bool proof_map_variables(Proof *proof, Formula *formula);
+void proof_add(Proof *proof, const Literal *literals, int num_literals);
+void proof_delete(Proof *proof, const Literal *literals, int num_literals);
+
+// ---------------------------------------------------------------------------
+// Preprocessing by bounded variable elimination (preprocess.c)
+// ---------------------------------------------------------------------------
+
+// Structure to record the clauses removed by preprocessing, so that a model of the
+// simplified formula can be extended to the variables removed
+typedef struct
+{
+    uint32_t *words; // Each removed clause: the literal of its eliminated variable, the other
+                     // literals, then the number of literals
+    int size;
+    int capacity;
+    int num_eliminated;
+    bool *eliminated; // Whether each variable of the input was eliminated
+} EliminationStack;
+
+// Structure to collect what one preprocessing technique removed
+typedef struct
+{
+    int variables;
+    int clauses; // Clauses removed less those added in their place
+} TechniqueStats;
+
+// Structure to collect counters from preprocessing
+typedef struct
+{
+    TechniqueStats units;        // Unit propagation with failed literal probing
+    TechniqueStats equivalences; // Equivalent literal substitution
+    TechniqueStats pure;         // Pure literal elimination
+    TechniqueStats elimination;  // Bounded variable elimination
+    int failed_literals;         // Literals whose propagation conflicts
+    int clauses_before;
+    int clauses_after;
+    long resolvents;       // Resolvents added in place of eliminated clauses
+    long subsumed_clauses; // Clauses removed because another one subsumes them
+    double seconds;
+    double cpu_seconds;
+} PreprocessStats;
+
+bool preprocess_formula(Formula *input, Formula *output, const bool *frozen, int bound, Proof *proof,
+                        EliminationStack *stack, PreprocessStats *stats);
+void extend_model(EliminationStack *stack, int8_t *model);
+void free_elimination_stack(EliminationStack *stack);
+
+// ---------------------------------------------------------------------------
+// Resolution by refutation with the given-clause algorithm (resolution.c)
+// ---------------------------------------------------------------------------
+
+// Orders in which the given-clause loop selects the next unprocessed clause; every order
+// still resolves each pair of clauses once, so only the time to an answer changes
+typedef enum
+{
+    SELECT_SHORTEST,   // Fewest literals first, oldest among equals
+    SELECT_AGE_WEIGHT, // Shortest first, except that every AGE_WEIGHT_RATIO-th pick is the oldest
+    SELECT_FIFO,       // Oldest first: the level-by-level order of plain saturation
+    SELECT_ORDERED     // Smallest largest variable first, then shortest, as in ordered resolution
+} ClauseSelection;
+
+#define AGE_WEIGHT_RATIO 5
+
+// Function to weigh a clause for selection: lighter clauses are selected first
+typedef long long (*ClauseWeight)(Clause *clause);
+
+// Structure to represent a clause waiting in a selection heap
+typedef struct
+{
+    long long weight;
+    long age; // Queueing order, which breaks ties between equal weights
+    int id;
+} QueueEntry;
+
+// Structure to represent a binary min-heap of queued clauses
+typedef struct
+{
+    QueueEntry *entries;
+    int size;
+    int capacity;
+} ClauseHeap;
+
+// Structure to represent the unprocessed clauses of a working set
+// Selected clauses are removed lazily: entries of deleted or processed clauses are skipped
+typedef struct
+{
+    ClauseWeight weight; // Weight of the by_weight heap
+    int age_ratio;       // Every age_ratio-th selection takes the oldest clause (0: never)
+    ClauseHeap by_weight;
+    ClauseHeap by_age; // Same clauses by age, only kept when age_ratio is set
+    long next_age;
+    long selections;
+} ClauseQueue;
+
+// Structure to configure a resolution run
+typedef struct
+{
+    bool set_of_support; // Only resolve when at least one parent descends from a goal clause
+    ClauseSelection selection; // Order in which clauses are given
+    int threads;         // Threads resolving pairs; 1 runs the sequential given-clause loop
+} ResolutionOptions;
+
+// Structure to represent the budget counters the parts of a component saturation share, so
+// that the budget applies to the whole solve: totals of the working set and of every part
+typedef struct
+{
+    volatile int64_t kept;    // Resolvents the parts kept
+    volatile int64_t clauses; // Live clauses
+    volatile int64_t bytes;   // Bytes of the clause pools
+} SharedBudget;
+
+// Structure to collect counters from a resolution run
+typedef struct
+{
+    long given;              // Clauses selected from the unprocessed set
+    long pairs;              // Pairs of clauses resolved, tautologies included
+    long resolvents;         // Non-tautological resolvents produced
+    long tautologies;        // Resolvents discarded as tautologies
+    long duplicates;         // Clauses rejected by the clause store as already present
+    long forward_subsumed;   // New clauses rejected because an existing clause subsumes them
+    long backward_subsumed;  // Existing clauses deleted because a new clause subsumes them
+    int final_clauses;       // Live clauses in the working set when resolution stopped
+    int peak_clauses;        // Most live clauses the working set has held
+    long long peak_bytes;    // Most bytes its clause pool has taken
+    int bitset_variables;    // Variables covered by the bitset kernels, 0 once the formula outgrew them
+    const char *bitset_instructions; // Instruction set of those kernels, or NULL
+    int components;          // Variable-disjoint components the last saturation split into, or 0
+    int threads;             // Threads used by the last saturation
+    long rounds;             // Parallel rounds of the last saturation
+    double parallel_seconds; // Wall-clock time of its parallel phases
+    double worker_seconds;   // Time the threads spent resolving during those phases, summed
+} ResolutionStats;
+
+// Structure to represent a resolution working set that persists between saturations
+typedef struct
+{
+    ClauseStore store;
+    ClauseQueue queue; // Clauses waiting to be given
+    IdList pending;    // Given clauses a budget or memory error cut short; selected first again
+    ClauseSelection selection;
+    bool use_support; // Set of support: clauses not descending from a goal are never selected
+    bool found_empty; // The empty clause was derived: unsatisfiable whatever is added
+    Budget budget;      // Limits of each saturation
+    CancelFlag *cancel; // Optional: saturation stops at the next given clause once it is raised;
+                        // a component that derives the empty clause raises it for the others
+    Proof *proof;       // Optional: kept resolvents and the empty clause are logged to it
+    StopReason stopped; // Why the last saturation stopped early; a later call resumes it
+    Clause copy;      // Scratch clauses reused across calls
+    Clause resolvant;
+    long given;       // Counters since the working set was created, see ResolutionStats
+    long pairs;
+    long resolvents;
+    long tautologies;
+    long kept; // Resolvents added to the store, what the resolvent budget counts
+    SharedBudget *shared; // Optional: totals the budget is checked against instead of this
+                          // working set alone, with what it last added to them
+    int64_t shared_clauses;
+    int64_t shared_bytes;
+    int peak_clauses;
+    long long peak_bytes;
+} ResolutionState;
+
+bool init_resolution_state(ResolutionState *state, bool use_support, ClauseSelection selection);
+bool resolution_set_weight(ResolutionState *state, ClauseWeight weight, int age_ratio);
+bool resolution_set_selection(ResolutionState *state, ClauseSelection selection);
+void free_resolution_state(ResolutionState *state);
+bool resolution_add_clause(ResolutionState *state, Clause *clause);
+SearchResult resolution_saturate(ResolutionState *state, int num_threads, ResolutionStats *stats);
+bool resolution_implies(ResolutionState *state, Clause *clause);
+bool resolution_build_model(ResolutionState *state, int8_t *model, int num_vars);
+
+// ---------------------------------------------------------------------------
+// Conflict-driven clause learning (CDCL) search engine (cdcl.c)
+// ---------------------------------------------------------------------------
+
+// Structure to collect counters from a CDCL run
+typedef struct
+{
+    long decisions;
+    long propagations;
+    long conflicts;
+    long restarts;
+    long learned_clauses;
+    long deleted_clauses;
+    int peak_clauses;     // Most clauses held at once, original and learned
+    long long peak_bytes; // Most bytes their pool has taken
+} CdclStats;
+
+// Structure to represent the state of a CDCL search
+typedef struct
+{
+    Propagator prop; // Assignment trail and clause database (original and learned clauses)
+    int num_learned;
+    double max_learned;
+
+    bool *saved_phases; // Polarity (is_negated) of the last assignment, reused by decisions
+
+    // EVSIDS decision heuristic: binary max-heap of variables by activity
+    double *activity;
+    double var_increment;
+    int *heap;
+    int *heap_index; // Position of each variable in the heap, or -1
+    int heap_size;
+
+    // Scratch space for conflict analysis
+    uint8_t *seen;
+    Literal *learned;
+    Literal *analyze_stack;
+    Literal *analyze_toclear; // Literals whose seen mark must be reset after analysis
+    int toclear_size;
+    int *level_stamps;
+    int stamp;
+
+    // Strategy, set between init_cdcl_solver and loading the formula
+    bool initial_phase; // Polarity (is_negated) of the first decision on each variable
+    int restart_base;   // Conflicts per unit of the Luby restart sequence
+
+    Budget budget;      // Limits of each search
+    CancelFlag *cancel; // Optional: the search gives up once it is raised
+    Proof *proof;       // Optional: learned and deleted clauses are logged to it
+    StopReason stopped; // Why the last search gave up, with an unknown result
+
+    bool unsatisfiable; // Conflict at level 0: unsatisfiable whatever the assumptions
+    CdclStats stats;
+} CdclSolver;
+
+void free_cdcl_solver(CdclSolver *solver);
+bool init_cdcl_solver(CdclSolver *solver, int num_vars);
+bool cdcl_reserve_variables(CdclSolver *solver, int num_vars);
+bool cdcl_load_formula(CdclSolver *solver, Formula *formula, int first);
+SearchResult cdcl_search(CdclSolver *solver, const Literal *assumptions, int num_assumptions);
+void cdcl_copy_model(CdclSolver *solver, int8_t *model, int num_vars);
+
+// ---------------------------------------------------------------------------
+// Portfolio: differently configured engines racing on the same formula (portfolio.c)
+// ---------------------------------------------------------------------------
+
+// Structure to report which strategy of a portfolio answered, with its counters
+typedef struct
+{
+    const char *winner;            // Name of the strategy that answered first, or NULL
+    int strategies;                // Strategies that were started
+    bool use_cdcl;                 // The winner is a CDCL strategy: cdcl is filled in, otherwise
+    CdclStats cdcl;                // units and resolution are
+    UnitPropagationResult units;
+    ResolutionStats resolution;
+    StopReason stopped;            // Without a winner: why the first strategy stopped
+    int8_t *model;                 // Satisfiable answer: VALUE_* of each formula variable, or
+                                   // NULL if the winner could not build one
+} PortfolioResult;
+
+void free_portfolio_result(PortfolioResult *result);
+SearchResult portfolio_solve(Formula *formula, const Literal *assumptions, int num_assumptions,
+                             ResolutionOptions *options, const Budget *budget, PortfolioResult *result);
+
+// ---------------------------------------------------------------------------
+// Formula file readers: the name-based format and DIMACS CNF (reader.c)
+// ---------------------------------------------------------------------------
+
+// Input formats understood by read_formula
+typedef enum
+{
+    FORMAT_AUTO,   // DIMACS if a "p cnf" header comes before any clause, names otherwise
+    FORMAT_NAMES,  // One clause per line, literals are names optionally prefixed with '!'
+    FORMAT_DIMACS  // "p cnf <vars> <clauses>" header, clauses of signed integers ending with 0
+} FileFormat;
+
+bool read_formula(const char *filename, FileFormat format, Formula *formula);
+bool read_formula_from_file(const char *filename, Formula *formula);
+
+// ---------------------------------------------------------------------------
+// Canonical form of a formula, independent of variable names and clause order (canonical.c)
+// ---------------------------------------------------------------------------
+
+// Structure to represent the canonical form of a formula by its hash and its numbering of the
+// variables; formulas equal up to a renaming of the variables get the same one
+typedef struct
+{
+    uint64_t key;      // Hash of the canonical clauses
+    uint64_t check;    // Independent hash of the same clauses, against collisions of the key
+    int *order;        // Formula variable of each canonical variable
+    int num_variables; // Variables occurring in a clause (not a tautology)
+} CanonicalForm;
+
+bool canonical_form(Formula *formula, CanonicalForm *form);
+void free_canonical_form(CanonicalForm *form);
+
+// ---------------------------------------------------------------------------
+// Persistent cache of answers, shared by processes through a mapped file (cache.c)
+// ---------------------------------------------------------------------------
+
+#define CACHE_ENTRIES 4096         // Answers a new cache file holds
+#define CACHE_WAYS 8               // Entries a formula can go in, picked by its key
+#define CACHE_MODEL_VARIABLES 4096 // Variables of the largest model a new cache file holds
+
+// Structure to represent the counters of the solve that stored an answer
+typedef struct
+{
+    double solve_seconds;
+    double solve_cpu_seconds;
+    int64_t given_clauses;
+    int64_t pairs_tried;
+    int64_t resolvents;
+    int64_t decisions;
+    int64_t propagations;
+    int64_t conflicts;
+} CachedStats;
+
+// Structure to represent an open cache file
+typedef struct
+{
+    SharedFile file;
+} ResultCache;
+
+bool cache_open(ResultCache *cache, const char *filename);
+void cache_close(ResultCache *cache);
+SearchResult cache_lookup(ResultCache *cache, const CanonicalForm *form, int8_t *model, CachedStats *stats);
+void cache_store(ResultCache *cache, const CanonicalForm *form, SearchResult result, const int8_t *model,
+                 const CachedStats *stats);
+
+#endif
@@ -0,0 +1,630 @@
+/*
+ * Tests of the solver library through its public API
+ *
+ *   test_solver [seed]
+ *
+ * - Random CNFs solved by every engine, checked against a brute-force count of their
+ *   models, with the clauses added in two halves and a solve under assumptions after each
+ * - An incremental set-of-support sequence: goals and plain clauses added between solves
+ * - DRAT proofs of unsatisfiable formulas checked by drat-trim (or the checker named by the
+ *   DRAT_TRIM environment variable); skipped when no checker is found
+ * - Cache hits on renamed and reordered copies of formulas
+ * Prints one line per failure and exits with 1 if any test failed.
+ */
+
+#include "solver.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+#define MAX_VARIABLES 12 // Brute force tries every assignment
+#define RANDOM_VARIABLES 10
+#define MAX_CLAUSES 64
+#define MAX_CLAUSE_SIZE 4
+#define RANDOM_FORMULAS 150
+#define CACHE_FORMULAS 40
+#define TEST_CNF_FILE "test_solver.cnf"
+#define TEST_PROOF_FILE "test_solver.drat"
+#define TEST_CACHE_FILE "test_solver.cache"
+
+// Structure to represent a test formula: clauses of DIMACS literals
+typedef struct
+{
+    int num_variables;
+    int num_clauses;
+    int sizes[MAX_CLAUSES];
+    int literals[MAX_CLAUSES][MAX_CLAUSE_SIZE];
+} TestFormula;
+
+// Structure to represent a solver configuration the random formulas are run on
+typedef struct
+{
+    const char *name;
+    SolverEngine engine;
+    SolverSelection selection;
+    int threads;
+    bool preprocess;
+    bool support; // Set of support, the last clause being the goal; it may answer unknown
+} TestConfig;
+
+static const TestConfig configs[] = {
+    {"resolution", SOLVER_ENGINE_RESOLUTION, SOLVER_SELECT_SHORTEST, 1, false, false},
+    {"resolution fifo", SOLVER_ENGINE_RESOLUTION, SOLVER_SELECT_FIFO, 1, false, false},
+    {"resolution ordered", SOLVER_ENGINE_RESOLUTION, SOLVER_SELECT_ORDERED, 1, false, false},
+    {"resolution 4 threads", SOLVER_ENGINE_RESOLUTION, SOLVER_SELECT_SHORTEST, 4, false, false},
+    {"resolution preprocessed", SOLVER_ENGINE_RESOLUTION, SOLVER_SELECT_SHORTEST, 1, true, false},
+    {"resolution set of support", SOLVER_ENGINE_RESOLUTION, SOLVER_SELECT_SHORTEST, 1, false, true},
+    {"cdcl", SOLVER_ENGINE_CDCL, SOLVER_SELECT_SHORTEST, 1, false, false},
+    {"cdcl preprocessed", SOLVER_ENGINE_CDCL, SOLVER_SELECT_SHORTEST, 1, true, false},
+    {"portfolio", SOLVER_ENGINE_PORTFOLIO, SOLVER_SELECT_SHORTEST, 2, false, false},
+};
+
+static int failures = 0;
+
+// Function to report a failed test
+static void fail(const char *test, const char *detail, uint64_t seed)
+{
+    printf("FAIL %s: %s (seed %llu)\n", test, detail, (unsigned long long)seed);
+    failures++;
+}
+
+// Function to draw the next number of a seeded generator (splitmix64)
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Function to draw a number from 0 to bound - 1
+static int random_below(uint64_t *state, int bound)
+{
+    return (int)(next_random(state) % (uint64_t)bound);
+}
+
+// Function to generate a random formula of clauses of 1 to MAX_CLAUSE_SIZE distinct variables,
+// mostly of 3, around the satisfiability threshold
+static void generate_formula(TestFormula *formula, uint64_t *seed)
+{
+    formula->num_variables = 3 + random_below(seed, RANDOM_VARIABLES - 2);
+    formula->num_clauses = formula->num_variables * 4 + random_below(seed, formula->num_variables + 1);
+    for (int c = 0; c < formula->num_clauses; c++)
+    {
+        int roll = random_below(seed, 10);
+        int size = roll == 0 ? 2 : roll == 1 ? 4 : 3;
+        if (size > formula->num_variables)
+            size = formula->num_variables;
+        formula->sizes[c] = size;
+        for (int i = 0; i < size; i++)
+        {
+            int variable;
+            bool fresh;
+            do
+            {
+                variable = random_below(seed, formula->num_variables) + 1;
+                fresh = true;
+                for (int j = 0; j < i; j++)
+                {
+                    if (abs(formula->literals[c][j]) == variable)
+                        fresh = false;
+                }
+            } while (!fresh);
+            formula->literals[c][i] = random_below(seed, 2) ? -variable : variable;
+        }
+    }
+}
+
+// Function to tell whether an assignment (bit v - 1 for variable v) satisfies a literal
+static inline bool literal_true(int literal, unsigned assignment)
+{
+    bool value = (assignment >> (abs(literal) - 1)) & 1;
+    return literal > 0 ? value : !value;
+}
+
+// Function to decide the first num_clauses clauses of a formula with assumption literals by
+// trying every assignment
+static bool brute_force(const TestFormula *formula, int num_clauses, const int *assumptions, int num_assumptions)
+{
+    for (unsigned assignment = 0; assignment < 1u << formula->num_variables; assignment++)
+    {
+        bool satisfied = true;
+        for (int i = 0; i < num_assumptions && satisfied; i++)
+        {
+            satisfied = literal_true(assumptions[i], assignment);
+        }
+        for (int c = 0; c < num_clauses && satisfied; c++)
+        {
+            satisfied = false;
+            for (int i = 0; i < formula->sizes[c] && !satisfied; i++)
+            {
+                satisfied = literal_true(formula->literals[c][i], assignment);
+            }
+        }
+        if (satisfied)
+            return true;
+    }
+    return false;
+}
+
+// Function to write the name of a literal of variable v as "x<v>" or "!x<v>"
+static void literal_name(char *name, size_t size, int literal)
+{
+    snprintf(name, size, "%sx%d", literal < 0 ? "!" : "", abs(literal));
+}
+
+// Function to add a clause by the names of its literals
+static bool add_named(Solver *solver, const int *literals, int size, bool is_goal)
+{
+    char buffers[MAX_CLAUSE_SIZE][16];
+    const char *names[MAX_CLAUSE_SIZE];
+    for (int i = 0; i < size; i++)
+    {
+        literal_name(buffers[i], sizeof(buffers[i]), literals[i]);
+        names[i] = buffers[i];
+    }
+    return solver_add_named_clause(solver, names, size, is_goal);
+}
+
+// Function to tell whether the model of a solver satisfies the first num_clauses clauses and
+// the assumptions
+static bool model_satisfies(const Solver *solver, const TestFormula *formula, int num_clauses, const int *assumptions,
+                            int num_assumptions)
+{
+    char name[16];
+    for (int i = 0; i < num_assumptions; i++)
+    {
+        snprintf(name, sizeof(name), "x%d", abs(assumptions[i]));
+        if (solver_value_named(solver, name) != (assumptions[i] > 0 ? 1 : -1))
+            return false;
+    }
+    for (int c = 0; c < num_clauses; c++)
+    {
+        bool satisfied = false;
+        for (int i = 0; i < formula->sizes[c] && !satisfied; i++)
+        {
+            int literal = formula->literals[c][i];
+            snprintf(name, sizeof(name), "x%d", abs(literal));
+            satisfied = solver_value_named(solver, name) == (literal > 0 ? 1 : -1);
+        }
+        if (!satisfied)
+            return false;
+    }
+    return true;
+}
+
+// Function to check the answer of a solve against brute force
+static void check_answer(const TestConfig *config, const char *step, SolverResult result, const Solver *solver,
+                         const TestFormula *formula, int num_clauses, const int *assumptions, int num_assumptions,
+                         bool unknown_allowed, uint64_t seed)
+{
+    char detail[128];
+    bool expected = brute_force(formula, num_clauses, assumptions, num_assumptions);
+    if (result == SOLVER_UNKNOWN && unknown_allowed)
+        return;
+    if (result != (expected ? SOLVER_SATISFIABLE : SOLVER_UNSATISFIABLE))
+    {
+        snprintf(detail, sizeof(detail), "%s answered %s instead of %s", step, solver_result_name(result),
+                 expected ? "satisfiable" : "unsatisfiable");
+        fail(config->name, detail, seed);
+    }
+    else if (expected && !model_satisfies(solver, formula, num_clauses, assumptions, num_assumptions))
+    {
+        snprintf(detail, sizeof(detail), "%s returned a wrong model", step);
+        fail(config->name, detail, seed);
+    }
+}
+
+// Function to solve a random formula incrementally with a configuration: half of its clauses,
+// then under two assumptions, then all of them, then under two assumptions again
+static void test_random_formula(const TestConfig *config, const TestFormula *formula, uint64_t seed)
+{
+    Solver *solver = solver_create();
+    if (!solver)
+    {
+        fail(config->name, "out of memory", seed);
+        return;
+    }
+    solver_set_engine(solver, config->engine);
+    solver_set_selection(solver, config->selection);
+    solver_set_threads(solver, config->threads);
+    solver_set_preprocessing(solver, config->preprocess);
+    solver_set_set_of_support(solver, config->support);
+
+    uint64_t state = seed;
+    int assumptions[2];
+    char names[2][16];
+    const char *assumption_names[2] = {names[0], names[1]};
+    int half = formula->num_clauses / 2;
+    for (int step = 0; step < 2; step++)
+    {
+        int from = step == 0 ? 0 : half;
+        int to = step == 0 ? half : formula->num_clauses;
+        for (int c = from; c < to; c++)
+        {
+            bool is_goal = config->support && c == formula->num_clauses - 1;
+            if (!add_named(solver, formula->literals[c], formula->sizes[c], is_goal))
+                fail(config->name, "clause rejected", seed);
+        }
+        // Set of support only runs without assumptions, and needs the goal to answer
+        bool unknown_allowed = config->support;
+        check_answer(config, step == 0 ? "half solve" : "full solve", solver_solve(solver), solver, formula, to,
+                     NULL, 0, unknown_allowed, seed);
+
+        for (int i = 0; i < 2; i++)
+        {
+            int variable = random_below(&state, formula->num_variables) + 1;
+            assumptions[i] = random_below(&state, 2) ? -variable : variable;
+            literal_name(names[i], sizeof(names[i]), assumptions[i]);
+        }
+        check_answer(config, step == 0 ? "half solve assuming" : "full solve assuming",
+                     solver_solve_assuming_named(solver, assumption_names, 2), solver, formula, to, assumptions, 2,
+                     false, seed);
+    }
+    solver_destroy(solver);
+}
+
+// Function to check the answers of every configuration on random formulas
+static void test_random_formulas(uint64_t seed)
+{
+    for (size_t k = 0; k < sizeof(configs) / sizeof(configs[0]); k++)
+    {
+        uint64_t state = seed + k;
+        for (int n = 0; n < RANDOM_FORMULAS; n++)
+        {
+            TestFormula formula;
+            uint64_t formula_seed = next_random(&state);
+            uint64_t generator = formula_seed;
+            generate_formula(&formula, &generator);
+            test_random_formula(&configs[k], &formula, formula_seed);
+        }
+    }
+}
+
+// Function to add a clause given as literal names, such as {"!p", "q"}
+static bool add_names(Solver *solver, const char *a, const char *b, bool is_goal)
+{
+    const char *names[2] = {a, b};
+    return solver_add_named_clause(solver, names, b ? 2 : 1, is_goal);
+}
+
+// Function to check the answer of one solve of a sequence
+static void expect(const char *test, const char *step, SolverResult result, SolverResult expected)
+{
+    char detail[128];
+    if (result != expected)
+    {
+        snprintf(detail, sizeof(detail), "%s answered %s instead of %s", step, solver_result_name(result),
+                 solver_result_name(expected));
+        fail(test, detail, 0);
+    }
+}
+
+// Function to run set-of-support resolution over clauses added between solves
+static void test_support_sequence(void)
+{
+    const char *test = "set of support sequence";
+    Solver *solver = solver_create();
+    solver_set_set_of_support(solver, true);
+
+    // p -> q -> r with the goal p: nothing descending from it refutes anything
+    add_names(solver, "!p", "q", false);
+    add_names(solver, "!q", "r", false);
+    add_names(solver, "p", NULL, true);
+    expect(test, "first solve", solver_solve(solver), SOLVER_UNKNOWN);
+    SolverStats stats;
+    solver_get_stats(solver, &stats);
+    if (!stats.stopped_by || strcmp(stats.stopped_by, "support") != 0)
+        fail(test, "first solve did not stop for lack of support", 0);
+
+    // Assumptions saturate without set of support
+    const char *not_r[] = {"!r"};
+    const char *r[] = {"r"};
+    expect(test, "solve assuming !r", solver_solve_assuming_named(solver, not_r, 1), SOLVER_UNSATISFIABLE);
+    expect(test, "solve assuming r", solver_solve_assuming_named(solver, r, 1), SOLVER_SATISFIABLE);
+
+    // A second goal meets the support clauses derived from the first one
+    add_names(solver, "!r", NULL, true);
+    expect(test, "solve with goal !r", solver_solve(solver), SOLVER_UNSATISFIABLE);
+    solver_destroy(solver);
+
+    // Plain clauses added later must still meet the support clauses given by earlier solves
+    solver = solver_create();
+    solver_set_set_of_support(solver, true);
+    add_names(solver, "!p", "!s", true);
+    add_names(solver, "q", "r", false);
+    expect(test, "solve before p and s", solver_solve(solver), SOLVER_UNKNOWN);
+    add_names(solver, "p", NULL, false);
+    add_names(solver, "s", NULL, false);
+    expect(test, "solve with p and s", solver_solve(solver), SOLVER_UNSATISFIABLE);
+    solver_destroy(solver);
+
+    // Without goal clauses, set of support saturates everything and can find a model
+    solver = solver_create();
+    solver_set_set_of_support(solver, true);
+    add_names(solver, "!p", "q", false);
+    add_names(solver, "p", NULL, false);
+    expect(test, "solve without goal", solver_solve(solver), SOLVER_SATISFIABLE);
+    solver_destroy(solver);
+}
+
+// Function to write the first num_clauses clauses of a formula as a DIMACS file
+static bool write_dimacs(const char *filename, const TestFormula *formula)
+{
+    FILE *file = fopen(filename, "w");
+    if (!file)
+        return false;
+    fprintf(file, "p cnf %d %d\n", formula->num_variables, formula->num_clauses);
+    for (int c = 0; c < formula->num_clauses; c++)
+    {
+        for (int i = 0; i < formula->sizes[c]; i++)
+        {
+            fprintf(file, "%d ", formula->literals[c][i]);
+        }
+        fprintf(file, "0\n");
+    }
+    return fclose(file) == 0;
+}
+
+// Function to get the command that runs the DRAT checker, or NULL if there is none
+static const char *drat_checker(void)
+{
+    const char *checker = getenv("DRAT_TRIM");
+    if (checker && *checker)
+        return checker;
+#ifndef _WIN32
+    if (system("command -v drat-trim > /dev/null 2>&1") == 0)
+        return "drat-trim";
+#endif
+    return NULL;
+}
+
+// Function to tell whether the checker verifies the proof of the test formula file
+static bool proof_verified(const char *checker)
+{
+    char command[512];
+    char line[256];
+    snprintf(command, sizeof(command), "%s %s %s", checker, TEST_CNF_FILE, TEST_PROOF_FILE);
+    FILE *output = popen(command, "r");
+    if (!output)
+        return false;
+    bool verified = false;
+    while (fgets(line, sizeof(line), output))
+    {
+        if (strncmp(line, "s VERIFIED", 10) == 0)
+            verified = true;
+    }
+    pclose(output);
+    return verified;
+}
+
+// Function to check the DRAT proofs of resolution and CDCL on unsatisfiable random formulas,
+// in text and binary
+static void test_proofs(uint64_t seed)
+{
+    const char *checker = drat_checker();
+    if (!checker)
+    {
+        printf("skip DRAT proofs: no drat-trim on the path and DRAT_TRIM not set\n");
+        return;
+    }
+
+    uint64_t state = seed;
+    int checked = 0;
+    while (checked < 8)
+    {
+        TestFormula formula;
+        uint64_t formula_seed = next_random(&state);
+        uint64_t generator = formula_seed;
+        generate_formula(&formula, &generator);
+        if (brute_force(&formula, formula.num_clauses, NULL, 0))
+            continue;
+        if (!write_dimacs(TEST_CNF_FILE, &formula))
+        {
+            fail("DRAT proof", "cannot write " TEST_CNF_FILE, formula_seed);
+            return;
+        }
+
+        SolverEngine engine = checked & 1 ? SOLVER_ENGINE_CDCL : SOLVER_ENGINE_RESOLUTION;
+        bool binary = checked & 2;
+        const char *test = engine == SOLVER_ENGINE_CDCL ? "cdcl DRAT proof" : "resolution DRAT proof";
+        Solver *solver = solver_create();
+        solver_set_engine(solver, engine);
+        if (!solver_read_file(solver, TEST_CNF_FILE, SOLVER_FORMAT_DIMACS) ||
+            !solver_set_proof(solver, TEST_PROOF_FILE, binary))
+            fail(test, "cannot set up the solver", formula_seed);
+        else if (solver_solve(solver) != SOLVER_UNSATISFIABLE)
+            fail(test, "unsatisfiable formula not refuted", formula_seed);
+        else if (!solver_set_proof(solver, NULL, binary))
+            fail(test, "proof not written", formula_seed);
+        else if (!proof_verified(checker))
+            fail(test, binary ? "binary proof rejected" : "text proof rejected", formula_seed);
+        solver_destroy(solver);
+        checked++;
+    }
+    remove(TEST_CNF_FILE);
+    remove(TEST_PROOF_FILE);
+}
+
+// Function to add a formula to a solver with its variables renamed by a permutation, and its
+// clauses and their literals shuffled
+static void add_renamed(Solver *solver, const TestFormula *formula, uint64_t *state)
+{
+    int permutation[MAX_VARIABLES + 1];
+    int order[MAX_CLAUSES];
+    for (int v = 1; v <= formula->num_variables; v++)
+    {
+        int j = 1 + random_below(state, v);
+        permutation[v] = permutation[j];
+        permutation[j] = v;
+    }
+    for (int c = 0; c < formula->num_clauses; c++)
+    {
+        int j = random_below(state, c + 1);
+        order[c] = order[j];
+        order[j] = c;
+    }
+
+    for (int n = 0; n < formula->num_clauses; n++)
+    {
+        int c = order[n];
+        int literals[MAX_CLAUSE_SIZE];
+        char buffers[MAX_CLAUSE_SIZE][16];
+        const char *names[MAX_CLAUSE_SIZE];
+        for (int i = 0; i < formula->sizes[c]; i++)
+        {
+            literals[i] = formula->literals[c][i];
+        }
+        for (int i = formula->sizes[c] - 1; i > 0; i--)
+        {
+            int j = random_below(state, i + 1);
+            int literal = literals[i];
+            literals[i] = literals[j];
+            literals[j] = literal;
+        }
+        for (int i = 0; i < formula->sizes[c]; i++)
+        {
+            snprintf(buffers[i], sizeof(buffers[i]), "%sy%d", literals[i] < 0 ? "!" : "",
+                     permutation[abs(literals[i])]);
+            names[i] = buffers[i];
+        }
+        solver_add_named_clause(solver, names, formula->sizes[c], false);
+    }
+}
+
+// Function to check that a formula solved through the cache is found again under another
+// naming and order of its clauses and literals
+static void check_cached_copy(const TestFormula *formula, uint64_t *state, uint64_t seed)
+{
+    const char *test = "cache";
+    char detail[128];
+    Solver *first = solver_create();
+    Solver *second = solver_create();
+    if (!solver_set_cache(first, TEST_CACHE_FILE) || !solver_set_cache(second, TEST_CACHE_FILE))
+    {
+        fail(test, "cannot open " TEST_CACHE_FILE, seed);
+        solver_destroy(first);
+        solver_destroy(second);
+        return;
+    }
+    add_renamed(first, formula, state);
+    add_renamed(second, formula, state);
+
+    SolverResult result = solver_solve(first);
+    SolverResult again = solver_solve(second);
+    SolverStats stats;
+    solver_get_stats(second, &stats);
+    if (!stats.cached)
+        fail(test, "renamed copy missed the cache", seed);
+    if (again != result)
+    {
+        snprintf(detail, sizeof(detail), "renamed copy answered %s instead of %s", solver_result_name(again),
+                 solver_result_name(result));
+        fail(test, detail, seed);
+    }
+    else if (again == SOLVER_SATISFIABLE && !solver_has_model(second))
+        fail(test, "cached model rejected", seed);
+    solver_destroy(first);
+    solver_destroy(second);
+}
+
+// Function to add a clause of up to three literals to a test formula
+static void add_test_clause(TestFormula *formula, int a, int b, int c)
+{
+    int *literals = formula->literals[formula->num_clauses];
+    int size = 0;
+    literals[size++] = a;
+    if (b)
+        literals[size++] = b;
+    if (c)
+        literals[size++] = c;
+    formula->sizes[formula->num_clauses++] = size;
+}
+
+// Function to build formulas whose variables colour refinement alone cannot tell apart: the
+// edges of a hexagon and of two triangles as clauses (x v y), the same with a clause (!x) for
+// one triangle corner, and three pigeons in two holes
+static int symmetric_formulas(TestFormula *formulas)
+{
+    static const int hexagon_and_triangles[][2] = {{1, 2}, {2, 3}, {3, 4},  {4, 5},  {5, 6},  {6, 1},
+                                                   {7, 8}, {8, 9}, {9, 7}, {10, 11}, {11, 12}, {12, 10}};
+    memset(formulas, 0, 3 * sizeof(TestFormula));
+    for (int k = 0; k < 2; k++)
+    {
+        formulas[k].num_variables = 12;
+        for (int e = 0; e < 12; e++)
+        {
+            add_test_clause(&formulas[k], hexagon_and_triangles[e][0], hexagon_and_triangles[e][1], 0);
+        }
+    }
+    add_test_clause(&formulas[1], -7, 0, 0);
+
+    // Pigeon i in hole j is variable 2 * i + j + 1
+    formulas[2].num_variables = 6;
+    for (int i = 0; i < 3; i++)
+    {
+        add_test_clause(&formulas[2], 2 * i + 1, 2 * i + 2, 0);
+    }
+    for (int j = 0; j < 2; j++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int k = i + 1; k < 3; k++)
+            {
+                add_test_clause(&formulas[2], -(2 * i + j + 1), -(2 * k + j + 1), 0);
+            }
+        }
+    }
+    return 3;
+}
+
+// Function to check cache hits on renamed copies of random and symmetric formulas
+static void test_cache(uint64_t seed)
+{
+    remove(TEST_CACHE_FILE);
+    uint64_t state = seed;
+    for (int n = 0; n < CACHE_FORMULAS; n++)
+    {
+        TestFormula formula;
+        uint64_t formula_seed = next_random(&state);
+        uint64_t generator = formula_seed;
+        generate_formula(&formula, &generator);
+        check_cached_copy(&formula, &generator, formula_seed);
+    }
+
+    TestFormula formulas[3];
+    int count = symmetric_formulas(formulas);
+    for (int k = 0; k < count; k++)
+    {
+        for (int n = 0; n < CACHE_FORMULAS / 4; n++)
+        {
+            uint64_t copy_seed = next_random(&state);
+            uint64_t generator = copy_seed;
+            check_cached_copy(&formulas[k], &generator, copy_seed);
+        }
+    }
+    remove(TEST_CACHE_FILE);
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+
+    test_random_formulas(seed);
+    test_support_sequence();
+    test_proofs(seed);
+    test_cache(seed);
+
+    if (failures)
+    {
+        printf("%d test(s) failed\n", failures);
+        return 1;
+    }
+    printf("All tests passed\n");
+    return 0;
+}